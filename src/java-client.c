@@ -24,20 +24,81 @@ typedef struct
 {
   JavaClient         *client;
   gchar              *input;
+  ClientProgressFunc  progress_func;
+  GCancellable       *cancellable;
   ClientCallbackFunc  func;
   gpointer            data;
 } Message;
 
+/*
+ * An edit to apply to the server's copy of a buffer: replace length 
+ * characters at offset with text.
+ */
+typedef struct
+{
+  gint     offset;
+  gint     length;
+  GString *text;
+} Edit;
+
+typedef struct
+{
+  JavaClient    *client;
+  GtkTextBuffer *buffer;
+  gchar         *file_path;
+  gchar         *contents;
+  GArray        *edits;
+  guint          version;
+  gboolean       resync;
+  gboolean       closed;
+  gulong         insert_text_id;
+  gulong         delete_range_id;
+} Mirror;
+
 static void java_client_class_init (JavaClientClass *klass);
 static void java_client_init       (JavaClient      *client);
 static void java_client_finalize   (JavaClient      *client);
 
 static void execute                (Message         *message);
+static gchar* send_request         (JavaClient      *client,
+                                    gchar           *input);
+static gchar* send_streaming       (GSocket         *socket,
+                                    gchar           *input,
+                                    Message         *message);
+static gchar* exchange             (GSocket         *socket,
+                                    gchar           *input);
+static gboolean send_all           (GSocket         *socket,
+                                    const gchar     *text,
+                                    gsize            length,
+                                    GError         **error);
+static GSocketConnection* open_connection (void);
+static void insert_text_action     (Mirror          *mirror, 
+                                    GtkTextIter     *location, 
+                                    gchar           *text, 
+                                    gint             length);
+static void delete_range_action    (Mirror          *mirror, 
+                                    GtkTextIter     *start, 
+                                    GtkTextIter     *end);
+static void add_edit               (Mirror          *mirror, 
+                                    gint             offset, 
+                                    gint             length, 
+                                    const gchar     *text);
+static void buffer_finalized       (Mirror          *mirror, 
+                                    GObject         *buffer);
+static void flush_mirrors          (JavaClient      *client);
+static gchar* get_sync_input       (Mirror          *mirror);
+static void clear_edits            (Mirror          *mirror);
+static void free_mirror            (Mirror          *mirror);
                           
 #define JAVA_CLIENT_GET_PRIVATE(obj) \
   (G_TYPE_INSTANCE_GET_PRIVATE ((obj), JAVA_CLIENT_TYPE, JavaClientPrivate))
   
 #define LOCALHOST "localhost"  
+#define PROGRESS "PROGRESS"
+#define END_OF_STREAM "END_OF_STREAM"
+#define RESYNC "RESYNC"
+#define CANCEL "-program cancel\n"
+#define MAX_EDITS 1000
 
 typedef struct _JavaClientPrivate JavaClientPrivate;
 
@@ -45,8 +106,11 @@ struct _JavaClientPrivate
 {
   CodeSlayer        *codeslayer;
   GSocket           *socket;
-  GSocketClient     *socket_client;
   GSocketConnection *socket_connection;
+  GList             *mirrors;
+  GMutex             mutex;
+  GRecMutex          send_mutex;
+  gboolean           syncing;
 };
 
 G_DEFINE_TYPE (JavaClient, java_client, G_TYPE_OBJECT)
@@ -60,7 +124,15 @@ java_client_class_init (JavaClientClass *klass)
 }
 
 static void
-java_client_init (JavaClient *client) {}
+java_client_init (JavaClient *client) 
+{
+  JavaClientPrivate *priv;
+  priv = JAVA_CLIENT_GET_PRIVATE (client);
+  priv->mirrors = NULL;
+  priv->syncing = FALSE;
+  g_mutex_init (&priv->mutex);
+  g_rec_mutex_init (&priv->send_mutex);
+}
 
 static void
 java_client_finalize (JavaClient *client)
@@ -68,8 +140,10 @@ java_client_finalize (JavaClient *client)
   JavaClientPrivate *priv;
   priv = JAVA_CLIENT_GET_PRIVATE (client);
 
-  if (priv->socket_client)
-    g_object_unref (priv->socket_client);
+  g_list_foreach (priv->mirrors, (GFunc) free_mirror, NULL);
+  g_list_free (priv->mirrors);
+  g_mutex_clear (&priv->mutex);
+  g_rec_mutex_clear (&priv->send_mutex);
 
   if (priv->socket)
     g_object_unref (priv->socket);    
@@ -98,22 +172,34 @@ void
 java_client_connect (JavaClient *client)
 {
   JavaClientPrivate *priv;
-  GError *error = NULL;
-
   priv = JAVA_CLIENT_GET_PRIVATE (client);
   
-  priv->socket_client = g_socket_client_new ();  
-  priv->socket_connection = g_socket_client_connect_to_host (priv->socket_client, LOCALHOST, 4444, NULL, &error);
+  priv->socket_connection = open_connection ();
+  if (priv->socket_connection != NULL)
+    priv->socket = g_socket_connection_get_socket (priv->socket_connection);
+}
+
+static GSocketConnection*
+open_connection (void)
+{
+  GSocketClient *socket_client;
+  GSocketConnection *socket_connection;
+  GError *error = NULL;
+
+  socket_client = g_socket_client_new ();  
+  socket_connection = g_socket_client_connect_to_host (socket_client, LOCALHOST, 4444, NULL, &error);
+  g_object_unref (socket_client);
   
   if (error != NULL)
     {
       g_print ("%s\n", error->message);
       g_error_free (error);
-      return;
+      return NULL;
     }
   
-  priv->socket = g_socket_connection_get_socket (priv->socket_connection);
-  g_socket_set_blocking (priv->socket, FALSE);
+  g_socket_set_blocking (g_socket_connection_get_socket (socket_connection), FALSE);
+  
+  return socket_connection;
 }
 
 void
@@ -126,32 +212,130 @@ java_client_send_with_callback (JavaClient         *client,
   message = g_malloc (sizeof (Message));
   message->client = client;
   message->input = g_strdup (input);
+  message->progress_func = NULL;
+  message->cancellable = NULL;
+  message->func = func;
+  message->data = data;
+  g_thread_new ("client-send", (GThreadFunc) execute, message);
+}
+
+/*
+ * Same as java_client_send_with_callback() except that nothing is sent once 
+ * the cancellable is cancelled, and the func is then handed NULL. A request 
+ * that is already out is still answered, so the caller should also check 
+ * the cancellable when the output comes back.
+ */
+void
+java_client_send_with_cancellable (JavaClient         *client,
+                                   gchar              *input,
+                                   GCancellable       *cancellable,
+                                   ClientCallbackFunc  func, 
+                                   gpointer            data)
+{
+  Message *message;
+  message = g_malloc (sizeof (Message));
+  message->client = client;
+  message->input = g_strdup (input);
+  message->progress_func = NULL;
+  message->cancellable = cancellable;
   message->func = func;
   message->data = data;
   g_thread_new ("client-send", (GThreadFunc) execute, message);
 }
 
+/*
+ * Same as java_client_send_with_callback() except that the server is asked 
+ * to stream its progress. Every PROGRESS line is handed to the progress_func 
+ * as it arrives (on the client thread), everything else is collected and 
+ * handed to the func once the server sends END_OF_STREAM. A stream that 
+ * ends without it did not finish, and the func is handed NULL.
+ *
+ * Cancelling the cancellable sends the server a cancel line on the same 
+ * connection, which it reads between progress lines and takes as the 
+ * word to abandon the request. The connection is then dropped, since 
+ * whatever the server already had in flight is of no use, and the func 
+ * is handed NULL.
+ */
+void
+java_client_send_with_progress (JavaClient         *client,
+                                gchar              *input,
+                                GCancellable       *cancellable,
+                                ClientProgressFunc  progress_func, 
+                                ClientCallbackFunc  func, 
+                                gpointer            data)
+{
+  Message *message;
+  message = g_malloc (sizeof (Message));
+  message->client = client;
+  message->input = g_strconcat (input, " -progress true", NULL);
+  message->progress_func = progress_func;
+  message->cancellable = cancellable;
+  message->func = func;
+  message->data = data;
+  g_thread_new ("client-send", (GThreadFunc) execute, message);
+}
+
+/*
+ * A request made on a thread goes out on a connection of its own, so that 
+ * a long one such as an indexing run or a low priority prefetch does not 
+ * hold up the requests made from the main loop. Only the edits to the 
+ * buffers are sent first, on the shared connection, so that the server 
+ * answers from what is in the editors.
+ */
 static void
 execute (Message *message)
 {
-  gchar *output;
-  output = java_client_send (message->client, message->input); 
+  GSocketConnection *connection = NULL;
+  gchar *output = NULL;
+  
+  if (!g_cancellable_is_cancelled (message->cancellable))
+    {
+      flush_mirrors (message->client);
+      connection = open_connection ();
+    }
+  
+  if (connection == NULL)
+    output = NULL;
+  else if (message->progress_func != NULL)
+    output = send_streaming (g_socket_connection_get_socket (connection), message->input, message);
+  else
+    output = exchange (g_socket_connection_get_socket (connection), message->input);
+  
+  if (connection != NULL)
+    {
+      g_io_stream_close (G_IO_STREAM (connection), NULL, NULL);
+      g_object_unref (connection);
+    }
+
   message->func (output, message->data);
   g_free (message->input);
   g_free (message);
 }
 
+/*
+ * Requests on the same client take turns, since they share the socket.
+ */
 gchar*
 java_client_send (JavaClient *client,
                   gchar      *input)
 {
   JavaClientPrivate *priv;
-  gchar buffer[1024];
-  GError *error = NULL;
-  gint received;
-  gint position;
-  GString *page;
-  gchar *text;
+  gchar *output;
+  
+  priv = JAVA_CLIENT_GET_PRIVATE (client);
+  
+  g_rec_mutex_lock (&priv->send_mutex);
+  output = send_request (client, input);
+  g_rec_mutex_unlock (&priv->send_mutex);
+  
+  return output;
+}
+
+static gchar*
+send_request (JavaClient *client,
+              gchar      *input)
+{
+  JavaClientPrivate *priv;
 
   priv = JAVA_CLIENT_GET_PRIVATE (client);
 
@@ -164,10 +348,26 @@ java_client_send (JavaClient *client,
           return NULL;
         }
     }
+  
+  flush_mirrors (client);
+  
+  return exchange (priv->socket, input);
+}
+
+static gchar*
+exchange (GSocket *socket,
+          gchar   *input)
+{
+  gchar buffer[1024];
+  GError *error = NULL;
+  gint received;
+  gint position;
+  GString *page;
+  gchar *text;
 
   text = g_strconcat (input, "\n", NULL);
 
-  g_socket_send (priv->socket, text, strlen(text), NULL, &error);
+  send_all (socket, text, strlen (text), &error);
   
   g_free (text);
 
@@ -179,9 +379,9 @@ java_client_send (JavaClient *client,
     
   page = g_string_new ("");
   
-  if (g_socket_condition_wait (priv->socket, G_IO_IN, NULL, NULL))
+  if (g_socket_condition_wait (socket, G_IO_IN, NULL, NULL))
     {
-      received = g_socket_receive (priv->socket, buffer, 1024, NULL, NULL);
+      received = g_socket_receive (socket, buffer, 1024, NULL, NULL);
       g_print ("received %d\n", received);
     
       while (received > 0)
@@ -190,10 +390,480 @@ java_client_send (JavaClient *client,
             {
               g_string_append_c (page, buffer[position]);
             }
-          received = g_socket_receive (priv->socket, buffer, 1024, NULL, NULL);
+          received = g_socket_receive (socket, buffer, 1024, NULL, NULL);
           g_print ("received %d\n", received);
         }
     }
     
   return g_string_free (page, FALSE);
 }
+
+static gchar*
+send_streaming (GSocket *socket,
+                gchar   *input, 
+                Message *message)
+{
+  gchar buffer[1024];
+  GError *error = NULL;
+  gint received;
+  gint position;
+  GString *page;
+  GString *line;
+  gchar *text;
+  gboolean done = FALSE;
+
+  text = g_strconcat (input, "\n", NULL);
+
+  send_all (socket, text, strlen (text), &error);
+  
+  g_free (text);
+
+  if (error != NULL)
+    {
+      g_print ("%s\n", error->message);
+      g_error_free (error);
+      return NULL;
+    }
+    
+  page = g_string_new ("");
+  line = g_string_new ("");
+  
+  /* unlike java_client_send() a pause in the output does not mean that the 
+     server is finished, so keep waiting until the end of the stream */
+  
+  while (!done && g_socket_condition_wait (socket, G_IO_IN | G_IO_HUP, 
+                                           message->cancellable, NULL))
+    {
+      received = g_socket_receive (socket, buffer, 1024, message->cancellable, NULL);
+      
+      if (received == 0)
+        break;
+      
+      for (position = 0; position < received; position++) 
+        {
+          if (buffer[position] != '\n')
+            {
+              g_string_append_c (line, buffer[position]);
+              continue;
+            }
+          
+          if (g_strcmp0 (line->str, END_OF_STREAM) == 0)
+            {
+              done = TRUE;
+              break;
+            }
+
+          if (g_str_has_prefix (line->str, PROGRESS))
+            {
+              message->progress_func (line->str, message->data);
+            }
+          else
+            {
+              g_string_append (page, line->str);
+              g_string_append_c (page, '\n');
+            }
+
+          g_string_truncate (line, 0);
+        }
+    }
+
+  g_string_free (line, TRUE);
+  
+  if (g_cancellable_is_cancelled (message->cancellable))
+    {
+      if (!done)
+        send_all (socket, CANCEL, strlen (CANCEL), NULL);
+      g_string_free (page, TRUE);
+      return NULL;
+    }
+  
+  if (!done)
+    {
+      g_string_free (page, TRUE);
+      return NULL;
+    }
+    
+  return g_string_free (page, FALSE);
+}
+
+/*
+ * The socket does not block, so a large request can go out in more than 
+ * one piece. Whenever the socket is full this waits until there is room.
+ */
+static gboolean
+send_all (GSocket      *socket,
+          const gchar  *text,
+          gsize         length,
+          GError      **error)
+{
+  while (length > 0)
+    {
+      GError *tmp_error = NULL;
+      gssize sent;
+      
+      sent = g_socket_send (socket, text, length, NULL, &tmp_error);
+      
+      if (sent < 0)
+        {
+          if (!g_error_matches (tmp_error, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK))
+            {
+              g_propagate_error (error, tmp_error);
+              return FALSE;
+            }
+          
+          g_error_free (tmp_error);
+          
+          if (!g_socket_condition_wait (socket, G_IO_OUT, NULL, error))
+            return FALSE;
+          
+          continue;
+        }
+      
+      text += sent;
+      length -= sent;
+    }
+    
+  return TRUE;
+}
+
+/*
+ * Keeps a copy of the buffer on the server, so that requests about the 
+ * file are answered from what is in the editor rather than what was last 
+ * saved. The whole text is only sent the first time. After that only the 
+ * edits are sent, and they are held until the next request goes out, so 
+ * a run of typing is sent as one edit.
+ *
+ * The server uses its copy of any -sourcefile it has one for, and drops 
+ * the copy when the buffer goes away. When the server has lost track of 
+ * the copy it answers RESYNC, and the whole text is sent again. The same 
+ * happens when more than MAX_EDITS edits pile up, say while the server is 
+ * down, since by then the text is the smaller thing to send.
+ */
+void
+java_client_mirror_buffer (JavaClient    *client, 
+                           GtkTextBuffer *buffer, 
+                           const gchar   *file_path)
+{
+  JavaClientPrivate *priv;
+  Mirror *mirror;
+  
+  priv = JAVA_CLIENT_GET_PRIVATE (client);
+  
+  mirror = g_malloc (sizeof (Mirror));
+  mirror->client = client;
+  mirror->buffer = buffer;
+  mirror->file_path = g_strdup (file_path);
+  mirror->edits = g_array_new (FALSE, FALSE, sizeof (Edit));
+  mirror->version = 0;
+  mirror->contents = NULL;
+  mirror->resync = TRUE;
+  mirror->closed = FALSE;
+  
+  mirror->insert_text_id = g_signal_connect_swapped (G_OBJECT (buffer), "insert-text",
+                                                     G_CALLBACK (insert_text_action), mirror);
+  
+  mirror->delete_range_id = g_signal_connect_swapped (G_OBJECT (buffer), "delete-range",
+                                                      G_CALLBACK (delete_range_action), mirror);
+  
+  g_object_weak_ref (G_OBJECT (buffer), (GWeakNotify) buffer_finalized, mirror);
+  
+  g_mutex_lock (&priv->mutex);
+  priv->mirrors = g_list_prepend (priv->mirrors, mirror);
+  g_mutex_unlock (&priv->mutex);
+}
+
+/*
+ * Runs before the text goes in, so the location is still where it starts.
+ */
+static void
+insert_text_action (Mirror      *mirror, 
+                    GtkTextIter *location, 
+                    gchar       *text, 
+                    gint         length)
+{
+  gchar *copy = g_strndup (text, length);
+  add_edit (mirror, gtk_text_iter_get_offset (location), 0, copy);
+  g_free (copy);
+}
+
+static void
+delete_range_action (Mirror      *mirror, 
+                     GtkTextIter *start, 
+                     GtkTextIter *end)
+{
+  gint start_offset;
+  gint end_offset;
+  
+  start_offset = gtk_text_iter_get_offset (start);
+  end_offset = gtk_text_iter_get_offset (end);
+  
+  add_edit (mirror, MIN (start_offset, end_offset), ABS (end_offset - start_offset), "");
+}
+
+/*
+ * Folds the edit into the last one when it carries on typing at its end, 
+ * or backspaces over text it inserted. Nothing is kept while the whole 
+ * text is going to be sent anyway.
+ */
+static void
+add_edit (Mirror      *mirror, 
+          gint         offset, 
+          gint         length, 
+          const gchar *text)
+{
+  JavaClientPrivate *priv;
+  Edit edit;
+  
+  priv = JAVA_CLIENT_GET_PRIVATE (mirror->client);
+  
+  g_mutex_lock (&priv->mutex);
+  
+  if (mirror->resync)
+    {
+      g_mutex_unlock (&priv->mutex);
+      return;
+    }
+  
+  if (mirror->edits->len >= MAX_EDITS)
+    {
+      clear_edits (mirror);
+      mirror->resync = TRUE;
+      g_mutex_unlock (&priv->mutex);
+      return;
+    }
+  
+  if (mirror->edits->len > 0)
+    {
+      Edit *last = &g_array_index (mirror->edits, Edit, mirror->edits->len - 1);
+      gint last_end = last->offset + g_utf8_strlen (last->text->str, last->text->len);
+      
+      if (length == 0 && offset == last_end)
+        {
+          g_string_append (last->text, text);
+          g_mutex_unlock (&priv->mutex);
+          return;
+        }
+      
+      if (*text == '\0' && offset + length == last_end && offset >= last->offset)
+        {
+          gchar *cut = g_utf8_offset_to_pointer (last->text->str, offset - last->offset);
+          g_string_truncate (last->text, cut - last->text->str);
+          g_mutex_unlock (&priv->mutex);
+          return;
+        }
+    }
+  
+  edit.offset = offset;
+  edit.length = length;
+  edit.text = g_string_new (text);
+  g_array_append_val (mirror->edits, edit);
+  
+  g_mutex_unlock (&priv->mutex);
+}
+
+static void
+buffer_finalized (Mirror  *mirror, 
+                  GObject *buffer)
+{
+  JavaClientPrivate *priv;
+  priv = JAVA_CLIENT_GET_PRIVATE (mirror->client);
+  
+  g_mutex_lock (&priv->mutex);
+  mirror->buffer = NULL;
+  mirror->closed = TRUE;
+  clear_edits (mirror);
+  g_mutex_unlock (&priv->mutex);
+}
+
+/*
+ * Sends what changed in the buffers since the last request, ahead of the 
+ * request itself. The sync requests go through java_client_send() too, so 
+ * they are kept from flushing again. The send mutex is held throughout, 
+ * which is what guards the syncing flag, and it is recursive so the sync 
+ * requests can still go out.
+ */
+static void
+flush_mirrors (JavaClient *client)
+{
+  JavaClientPrivate *priv;
+  GList *inputs = NULL;
+  GList *paths = NULL;
+  GList *closed = NULL;
+  GList *list;
+  GList *path;
+  
+  priv = JAVA_CLIENT_GET_PRIVATE (client);
+  
+  g_rec_mutex_lock (&priv->send_mutex);
+  
+  if (priv->syncing)
+    {
+      g_rec_mutex_unlock (&priv->send_mutex);
+      return;
+    }
+  
+  g_mutex_lock (&priv->mutex);
+  
+  list = priv->mirrors;
+  while (list != NULL)
+    {
+      Mirror *mirror = list->data;
+      gchar *input;
+      
+      list = g_list_next (list);
+      
+      input = get_sync_input (mirror);
+      if (input != NULL)
+        {
+          inputs = g_list_append (inputs, input);
+          paths = g_list_append (paths, g_strdup (mirror->file_path));
+        }
+      
+      if (mirror->closed)
+        {
+          priv->mirrors = g_list_remove (priv->mirrors, mirror);
+          closed = g_list_prepend (closed, mirror);
+        }
+    }
+  
+  g_mutex_unlock (&priv->mutex);
+  
+  priv->syncing = TRUE;
+  
+  for (list = inputs, path = paths; list != NULL; 
+       list = g_list_next (list), path = g_list_next (path))
+    {
+      gchar *output = java_client_send (client, list->data);
+      
+      if (output != NULL && g_str_has_prefix (output, RESYNC))
+        {
+          GList *mirrors;
+          
+          g_mutex_lock (&priv->mutex);
+          for (mirrors = priv->mirrors; mirrors != NULL; mirrors = g_list_next (mirrors))
+            {
+              Mirror *mirror = mirrors->data;
+              if (g_strcmp0 (path->data, mirror->file_path) == 0)
+                {
+                  clear_edits (mirror);
+                  mirror->resync = TRUE;
+                }
+            }
+          g_mutex_unlock (&priv->mutex);
+        }
+      
+      g_free (output);
+    }
+  
+  priv->syncing = FALSE;
+  
+  g_rec_mutex_unlock (&priv->send_mutex);
+  
+  g_list_foreach (inputs, (GFunc) g_free, NULL);
+  g_list_free (inputs);
+  g_list_foreach (paths, (GFunc) g_free, NULL);
+  g_list_free (paths);
+  g_list_foreach (closed, (GFunc) free_mirror, NULL);
+  g_list_free (closed);
+}
+
+/*
+ * The text is URI escaped so that it stays on one line and clear of the 
+ * spaces between the arguments. Each edit is offset:length:text, with the 
+ * edits separated by semicolons. Returns NULL when there is nothing to 
+ * send. Called with the mutex held.
+ *
+ * The whole text is read when it is sent, so it already has every edit in 
+ * it. The buffer can only be read on the main loop though, so until a 
+ * request is made from there nothing is sent for the buffer, and the server 
+ * answers from the saved file.
+ */
+static gchar*
+get_sync_input (Mirror *mirror)
+{
+  GString *input;
+  guint i;
+  
+  if (mirror->resync && mirror->buffer != NULL && 
+      g_main_context_is_owner (g_main_context_default ()))
+    {
+      GtkTextIter start;
+      GtkTextIter end;
+      gtk_text_buffer_get_bounds (mirror->buffer, &start, &end);
+      g_free (mirror->contents);
+      mirror->contents = gtk_text_buffer_get_text (mirror->buffer, &start, &end, TRUE);
+      mirror->resync = FALSE;
+      clear_edits (mirror);
+    }
+  
+  if (mirror->closed)
+    {
+      if (mirror->version == 0)
+        return NULL;
+      return g_strconcat ("-program sync -sourcefile ", mirror->file_path, 
+                          " -close true", NULL);
+    }
+  
+  if (mirror->resync || (mirror->contents == NULL && mirror->edits->len == 0))
+    return NULL;
+  
+  mirror->version++;
+  
+  input = g_string_new ("-program sync -sourcefile ");
+  g_string_append (input, mirror->file_path);
+  g_string_append_printf (input, " -version %u", mirror->version);
+  
+  if (mirror->contents != NULL)
+    {
+      gchar *escaped = g_uri_escape_string (mirror->contents, NULL, FALSE);
+      g_string_append (input, " -contents ");
+      g_string_append (input, escaped);
+      g_free (escaped);
+      g_free (mirror->contents);
+      mirror->contents = NULL;
+      return g_string_free (input, FALSE);
+    }
+  
+  g_string_append (input, " -edits ");
+  
+  for (i = 0; i < mirror->edits->len; i++)
+    {
+      Edit *edit = &g_array_index (mirror->edits, Edit, i);
+      gchar *escaped = g_uri_escape_string (edit->text->str, NULL, FALSE);
+      g_string_append_printf (input, "%s%d:%d:%s", i > 0 ? ";" : "", 
+                              edit->offset, edit->length, escaped);
+      g_free (escaped);
+    }
+  
+  clear_edits (mirror);
+  
+  return g_string_free (input, FALSE);
+}
+
+static void
+clear_edits (Mirror *mirror)
+{
+  guint i;
+  
+  for (i = 0; i < mirror->edits->len; i++)
+    g_string_free (g_array_index (mirror->edits, Edit, i).text, TRUE);
+  
+  g_array_set_size (mirror->edits, 0);
+}
+
+static void
+free_mirror (Mirror *mirror)
+{
+  if (mirror->buffer != NULL)
+    {
+      g_signal_handler_disconnect (mirror->buffer, mirror->insert_text_id);
+      g_signal_handler_disconnect (mirror->buffer, mirror->delete_range_id);
+      g_object_weak_unref (G_OBJECT (mirror->buffer), (GWeakNotify) buffer_finalized, mirror);
+    }
+  
+  clear_edits (mirror);
+  g_array_free (mirror->edits, TRUE);
+  g_free (mirror->contents);
+  g_free (mirror->file_path);
+  g_free (mirror);
+}
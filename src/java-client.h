@@ -31,6 +31,7 @@ G_BEGIN_DECLS
 #define IS_JAVA_CLIENT_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), JAVA_CLIENT_TYPE))
 
 typedef void (*ClientCallbackFunc) (gchar *output, gpointer data);
+typedef void (*ClientProgressFunc) (gchar *line, gpointer data);
 
 typedef struct _JavaClient JavaClient;
 typedef struct _JavaClientClass JavaClientClass;
@@ -47,15 +48,29 @@ struct _JavaClientClass
 
 GType java_client_get_type (void) G_GNUC_CONST;
 
-JavaClient*  java_client_new                 (CodeSlayer         *codeslayer);
+JavaClient*  java_client_new                    (CodeSlayer         *codeslayer);
                   
-void         java_client_connect             (JavaClient         *client);
-gchar*       java_client_send                (JavaClient         *client, 
-                                              gchar              *input);
-void         java_client_send_with_callback  (JavaClient         *client, 
-                                              gchar              *input,
-                                              ClientCallbackFunc  func, 
-                                              gpointer            data);
+void         java_client_connect                (JavaClient         *client);
+gchar*       java_client_send                   (JavaClient         *client, 
+                                                 gchar              *input);
+void         java_client_send_with_callback     (JavaClient         *client, 
+                                                 gchar              *input,
+                                                 ClientCallbackFunc  func, 
+                                                 gpointer            data);
+void         java_client_send_with_cancellable  (JavaClient         *client, 
+                                                 gchar              *input,
+                                                 GCancellable       *cancellable,
+                                                 ClientCallbackFunc  func, 
+                                                 gpointer            data);
+void         java_client_send_with_progress     (JavaClient         *client, 
+                                                 gchar              *input,
+                                                 GCancellable       *cancellable,
+                                                 ClientProgressFunc  progress_func, 
+                                                 ClientCallbackFunc  func, 
+                                                 gpointer            data);
+void         java_client_mirror_buffer          (JavaClient         *client, 
+                                                 GtkTextBuffer      *buffer, 
+                                                 const gchar        *file_path);
 
 G_END_DECLS
 
@@ -0,0 +1,780 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include "java-completion-cache.h"
+#include "java-resolver.h"
+#include "java-lexer.h"
+
+/*
+ * The method completions for an expression only change when the code that 
+ * declares the receiver changes, or when the indexes are rebuilt. So the raw 
+ * server output is kept in a small LRU cache keyed on the source file, the 
+ * expression and the enclosing scope. The whole cache is dropped when the 
+ * indexes are rebuilt.
+ *
+ * The scope is the opening brace of the block the caret is in. It is held 
+ * as a mark, so that it keeps pointing at the same block while lines are 
+ * added and removed above it.
+ *
+ * Next to that there is a table of members per type, for the receivers 
+ * whose type could be worked out in the buffer. It lets any receiver of a 
+ * type that was seen before be answered without asking the server.
+ *
+ * The classes that start with a letter are kept as well. They are the same 
+ * for every editor, so only the first editor to complete a letter waits 
+ * for the server.
+ */
+
+typedef struct
+{
+  gchar       *key;
+  gchar       *file_path;
+  gchar       *root;
+  GtkTextMark *scope;
+  gchar       *output;
+  gchar       *type;
+} Entry;
+
+static void java_completion_cache_class_init  (JavaCompletionCacheClass *klass);
+static void java_completion_cache_init        (JavaCompletionCache      *cache);
+static void java_completion_cache_finalize    (JavaCompletionCache      *cache);
+
+static gchar* get_key                         (JavaCompletionCache      *cache, 
+                                               const gchar              *file_path, 
+                                               const gchar              *expression);
+static GList* find_link                       (JavaCompletionCache      *cache, 
+                                               const gchar              *file_path, 
+                                               const gchar              *expression, 
+                                               GtkTextIter              *scope);
+static void insert_entry                      (JavaCompletionCache      *cache, 
+                                               const gchar              *file_path, 
+                                               const gchar              *expression, 
+                                               GtkTextIter              *scope, 
+                                               const gchar              *output, 
+                                               const gchar              *type);
+static gchar* get_root                        (const gchar              *expression);
+static gboolean has_scope                     (Entry                    *entry, 
+                                               GtkTextIter              *scope);
+static gboolean is_declared                   (const gchar              *text, 
+                                               const gchar              *root);
+static gboolean is_keyword                    (const gchar              *word);
+static void invalidate_file                   (JavaCompletionCache      *cache, 
+                                               const gchar              *file_path);
+static void remove_entry                      (JavaCompletionCache      *cache, 
+                                               GList                    *link);
+static void remove_all                        (JavaCompletionCache      *cache);
+static gboolean mentions_type                 (const gchar              *type, 
+                                               const gchar              *output, 
+                                               const gchar              *name);
+
+#define MAX_ENTRIES 64
+#define MAX_TYPES 256
+
+#define JAVA_COMPLETION_CACHE_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), JAVA_COMPLETION_CACHE_TYPE, JavaCompletionCachePrivate))
+
+typedef struct _JavaCompletionCachePrivate JavaCompletionCachePrivate;
+
+struct _JavaCompletionCachePrivate
+{
+  GHashTable *entries;
+  GQueue     *lru;
+  GHashTable *types;
+  GHashTable *classes;
+  guint       generation;
+};
+
+static const gchar *keywords[] = {"return", "new", "throw", "case", "else", 
+                                  "assert", "yield", "instanceof", NULL};
+
+G_DEFINE_TYPE (JavaCompletionCache, java_completion_cache, G_TYPE_OBJECT)
+
+static void 
+java_completion_cache_class_init (JavaCompletionCacheClass *klass)
+{
+  G_OBJECT_CLASS (klass)->finalize = (GObjectFinalizeFunc) java_completion_cache_finalize;
+  g_type_class_add_private (klass, sizeof (JavaCompletionCachePrivate));
+}
+
+static void
+java_completion_cache_init (JavaCompletionCache *cache)
+{
+  JavaCompletionCachePrivate *priv;
+  priv = JAVA_COMPLETION_CACHE_GET_PRIVATE (cache);
+  priv->entries = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, 
+                                         (GDestroyNotify) g_list_free);
+  priv->lru = g_queue_new ();
+  priv->types = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+  priv->classes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+  priv->generation = 0;
+}
+
+static void
+java_completion_cache_finalize (JavaCompletionCache *cache)
+{
+  JavaCompletionCachePrivate *priv;
+  priv = JAVA_COMPLETION_CACHE_GET_PRIVATE (cache);
+  
+  remove_all (cache);
+  g_hash_table_destroy (priv->entries);
+  g_queue_free (priv->lru);
+  g_hash_table_destroy (priv->types);
+  g_hash_table_destroy (priv->classes);
+
+  G_OBJECT_CLASS (java_completion_cache_parent_class)-> finalize (G_OBJECT (cache));
+}
+
+JavaCompletionCache*
+java_completion_cache_new (void)
+{
+  return JAVA_COMPLETION_CACHE (g_object_new (java_completion_cache_get_type (), NULL));
+}
+
+/*
+ * Returns the cached output, or NULL when the server has to be asked. The 
+ * output is owned by the cache.
+ */
+const gchar*
+java_completion_cache_lookup (JavaCompletionCache *cache, 
+                              const gchar         *file_path, 
+                              const gchar         *expression, 
+                              GtkTextIter         *scope)
+{
+  JavaCompletionCachePrivate *priv;
+  GList *link;
+  
+  priv = JAVA_COMPLETION_CACHE_GET_PRIVATE (cache);
+  
+  link = find_link (cache, file_path, expression, scope);
+  if (link == NULL)
+    return NULL;
+  
+  g_queue_unlink (priv->lru, link);
+  g_queue_push_head_link (priv->lru, link);
+  
+  return ((Entry*) link->data)->output;
+}
+
+/*
+ * An entry that is replaced keeps the type it was resolved to, so that a 
+ * page added to it is still known by its type, and the members of the 
+ * type take the page as well.
+ */
+void
+java_completion_cache_insert (JavaCompletionCache *cache, 
+                              const gchar         *file_path, 
+                              const gchar         *expression, 
+                              GtkTextIter         *scope, 
+                              const gchar         *output)
+{
+  const gchar *type;
+  gchar *kept;
+  
+  type = java_completion_cache_get_resolved_type (cache, file_path, expression, scope);
+  kept = g_strdup (type);
+  insert_entry (cache, file_path, expression, scope, output, kept);
+  
+  if (kept != NULL)
+    java_completion_cache_insert_type (cache, kept, output);
+  
+  g_free (kept);
+}
+
+/*
+ * Adds a later page to the methods that are already cached for the 
+ * expression, when the page carries on where they stop. If the cache has 
+ * dropped them since, say because of an edit, the page is of no use on 
+ * its own.
+ */
+void
+java_completion_cache_append (JavaCompletionCache *cache, 
+                              const gchar         *file_path, 
+                              const gchar         *expression, 
+                              GtkTextIter         *scope, 
+                              gint                 offset, 
+                              const gchar         *output)
+{
+  const gchar *cached;
+  gsize length;
+  gchar *appended;
+  
+  cached = java_completion_cache_lookup (cache, file_path, expression, scope);
+  if (cached == NULL || java_completion_cache_get_next_offset (cached, &length) != offset)
+    return;
+  
+  if (g_str_has_prefix (output, "NO_RESULTS_FOUND"))
+    appended = g_strndup (cached, length);
+  else
+    appended = g_strdup_printf ("%.*s%s", (gint) length, cached, output);
+  
+  java_completion_cache_insert (cache, file_path, expression, scope, appended);
+  g_free (appended);
+}
+
+/*
+ * Returns the offset of the next page when the output ends with a 
+ * MORE_RESULTS line, or -1 when it holds all of the methods. The length 
+ * is set to where that line starts.
+ */
+gint
+java_completion_cache_get_next_offset (const gchar *output, 
+                                       gsize       *length)
+{
+  const gchar *line;
+  
+  if (output == NULL)
+    return -1;
+  
+  if (g_str_has_prefix (output, "MORE_RESULTS\t"))
+    line = output;
+  else if ((line = strstr (output, "\nMORE_RESULTS\t")) != NULL)
+    line++;
+  else
+    return -1;
+  
+  if (length != NULL)
+    *length = line - output;
+  
+  return atoi (line + strlen ("MORE_RESULTS\t"));
+}
+
+/*
+ * Returns the key of the type that the cached expression was resolved to, 
+ * or NULL when it was not.
+ */
+const gchar*
+java_completion_cache_get_resolved_type (JavaCompletionCache *cache, 
+                                         const gchar         *file_path, 
+                                         const gchar         *expression, 
+                                         GtkTextIter         *scope)
+{
+  GList *link;
+  
+  link = find_link (cache, file_path, expression, scope);
+  if (link == NULL)
+    return NULL;
+  
+  return ((Entry*) link->data)->type;
+}
+
+/*
+ * Called with the text of the lines that an edit touched, before a delete 
+ * and after an insert. A brace changes the scopes, so everything cached for 
+ * the file goes. Otherwise only the expressions whose receiver is declared 
+ * on those lines are dropped, which leaves the cache intact while calls on 
+ * a receiver are being typed.
+ */
+void
+java_completion_cache_edited (JavaCompletionCache *cache, 
+                              const gchar         *file_path, 
+                              const gchar         *text)
+{
+  JavaCompletionCachePrivate *priv;
+  GList *list;
+  
+  priv = JAVA_COMPLETION_CACHE_GET_PRIVATE (cache);
+  
+  if (g_hash_table_size (priv->types) > 0 && strpbrk (text, "{};") != NULL)
+    {
+      gchar *basename;
+      basename = g_path_get_basename (file_path);
+      if (g_str_has_suffix (basename, ".java"))
+        basename[strlen (basename) - 5] = '\0';
+      g_hash_table_foreach_remove (priv->types, (GHRFunc) mentions_type, basename);
+      g_free (basename);
+    }
+  
+  if (g_queue_is_empty (priv->lru))
+    return;
+  
+  if (strchr (text, '{') != NULL || strchr (text, '}') != NULL)
+    {
+      invalidate_file (cache, file_path);
+      return;
+    }
+
+  list = g_queue_peek_head_link (priv->lru);
+  while (list != NULL)
+    {
+      Entry *entry = list->data;
+      GList *next = list->next;
+      
+      if (g_strcmp0 (entry->file_path, file_path) == 0 && 
+          is_declared (text, entry->root))
+        remove_entry (cache, list);
+        
+      list = next;
+    }
+}
+
+/*
+ * Called when the indexes have been rebuilt. Everything that came from the 
+ * old indexes is stale.
+ */
+void
+java_completion_cache_next_generation (JavaCompletionCache *cache)
+{
+  JavaCompletionCachePrivate *priv;
+  priv = JAVA_COMPLETION_CACHE_GET_PRIVATE (cache);
+  
+  priv->generation++;
+  remove_all (cache);
+  g_hash_table_remove_all (priv->types);
+  g_hash_table_remove_all (priv->classes);
+}
+
+/*
+ * Looks for the output of the expression, and then for the members of its 
+ * type when that can be worked out from the buffer at the start of the 
+ * member name. A hit on the type is cached for the expression as well, so 
+ * that later pages have something to be added to.
+ */
+const gchar*
+java_completion_cache_lookup_resolved (JavaCompletionCache *cache, 
+                                       const gchar         *file_path, 
+                                       const gchar         *expression, 
+                                       GtkTextIter         *start, 
+                                       GtkTextIter         *scope)
+{
+  JavaCompletionCachePrivate *priv;
+  const gchar *cached;
+  gchar *type;
+  
+  priv = JAVA_COMPLETION_CACHE_GET_PRIVATE (cache);
+  
+  cached = java_completion_cache_lookup (cache, file_path, expression, scope);
+  if (cached != NULL)
+    return cached;
+  
+  type = java_resolver_get_type (*start, expression);
+  if (type == NULL)
+    return NULL;
+  
+  cached = g_hash_table_lookup (priv->types, type);
+  if (cached != NULL)
+    {
+      insert_entry (cache, file_path, expression, scope, cached, type);
+      cached = java_completion_cache_lookup (cache, file_path, expression, scope);
+    }
+  
+  g_free (type);
+  
+  return cached;
+}
+
+/*
+ * Caches the output for the expression, and for its type when that can be 
+ * worked out.
+ */
+void
+java_completion_cache_insert_resolved (JavaCompletionCache *cache, 
+                                       const gchar         *file_path, 
+                                       const gchar         *expression, 
+                                       GtkTextIter         *start, 
+                                       GtkTextIter         *scope, 
+                                       const gchar         *output)
+{
+  gchar *type;
+  
+  type = java_resolver_get_type (*start, expression);
+  insert_entry (cache, file_path, expression, scope, output, type);
+  
+  if (type != NULL)
+    {
+      java_completion_cache_insert_type (cache, type, output);
+      g_free (type);
+    }
+}
+
+/*
+ * Returns the members that are known for the type, which is a key from the 
+ * resolver, or NULL. The output is owned by the cache.
+ */
+const gchar*
+java_completion_cache_lookup_type (JavaCompletionCache *cache, 
+                                   const gchar         *type)
+{
+  JavaCompletionCachePrivate *priv;
+  priv = JAVA_COMPLETION_CACHE_GET_PRIVATE (cache);
+  return g_hash_table_lookup (priv->types, type);
+}
+
+void
+java_completion_cache_insert_type (JavaCompletionCache *cache, 
+                                   const gchar         *type, 
+                                   const gchar         *output)
+{
+  JavaCompletionCachePrivate *priv;
+  priv = JAVA_COMPLETION_CACHE_GET_PRIVATE (cache);
+  
+  if (g_hash_table_size (priv->types) >= MAX_TYPES)
+    g_hash_table_remove_all (priv->types);
+  
+  g_hash_table_insert (priv->types, g_strdup (type), g_strdup (output));
+}
+
+/*
+ * Returns the classes that start with the letter, or NULL. The output is 
+ * owned by the cache.
+ */
+const gchar*
+java_completion_cache_lookup_classes (JavaCompletionCache *cache, 
+                                      const gchar         *letter)
+{
+  JavaCompletionCachePrivate *priv;
+  priv = JAVA_COMPLETION_CACHE_GET_PRIVATE (cache);
+  return g_hash_table_lookup (priv->classes, letter);
+}
+
+void
+java_completion_cache_insert_classes (JavaCompletionCache *cache, 
+                                      const gchar         *letter, 
+                                      const gchar         *output)
+{
+  JavaCompletionCachePrivate *priv;
+  priv = JAVA_COMPLETION_CACHE_GET_PRIVATE (cache);
+  g_hash_table_insert (priv->classes, g_strdup (letter), g_strdup (output));
+}
+
+/*
+ * The generation goes up every time the indexes are rebuilt, so anything 
+ * kept outside of the cache can tell when it is stale.
+ */
+guint
+java_completion_cache_get_generation (JavaCompletionCache *cache)
+{
+  JavaCompletionCachePrivate *priv;
+  priv = JAVA_COMPLETION_CACHE_GET_PRIVATE (cache);
+  return priv->generation;
+}
+
+/*
+ * Moves back to the opening brace of the enclosing block, or to the start 
+ * of the buffer when there is none. The braces come from the lexer, so the 
+ * ones in strings, characters and comments do not count, and the lines 
+ * that are walked over are already lexed.
+ */
+void
+java_completion_cache_get_scope (GtkTextIter *iter, 
+                                 GtkTextIter *scope)
+{
+  GtkTextBuffer *buffer;
+  JavaLexer *lexer;
+  gint line_index;
+  gint depth = 0;
+  gint line;
+  
+  buffer = gtk_text_iter_get_buffer (iter);
+  lexer = java_lexer_get (buffer);
+  line_index = gtk_text_iter_get_line_index (iter);
+  
+  for (line = gtk_text_iter_get_line (iter); line >= 0; line--)
+    {
+      GArray *tokens;
+      const gchar *text;
+      gint i;
+      
+      tokens = java_lexer_get_tokens (lexer, line);
+      text = java_lexer_get_text (lexer, line);
+      if (tokens == NULL)
+        continue;
+      
+      for (i = tokens->len - 1; i >= 0; i--)
+        {
+          JavaToken *token = &g_array_index (tokens, JavaToken, i);
+          
+          if (token->type != JAVA_TOKEN_OPERATOR || 
+              (line == gtk_text_iter_get_line (iter) && token->index >= line_index))
+            continue;
+          
+          if (text[token->index] == '}')
+            {
+              depth++;
+            }
+          else if (text[token->index] == '{')
+            {
+              if (depth == 0)
+                {
+                  gtk_text_buffer_get_iter_at_line_index (buffer, scope, line, token->index);
+                  return;
+                }
+              depth--;
+            }
+        }
+    }
+  
+  gtk_text_buffer_get_start_iter (buffer, scope);
+}
+
+static gboolean
+is_keyword (const gchar *word)
+{
+  const gchar **keyword;
+  
+  for (keyword = keywords; *keyword != NULL; keyword++)
+    {
+      if (g_strcmp0 (*keyword, word) == 0)
+        return TRUE;
+    }
+  
+  return FALSE;
+}
+
+static GList*
+find_link (JavaCompletionCache *cache, 
+           const gchar         *file_path, 
+           const gchar         *expression, 
+           GtkTextIter         *scope)
+{
+  JavaCompletionCachePrivate *priv;
+  GList *chain;
+  gchar *key;
+  
+  priv = JAVA_COMPLETION_CACHE_GET_PRIVATE (cache);
+  
+  key = get_key (cache, file_path, expression);
+  chain = g_hash_table_lookup (priv->entries, key);
+  g_free (key);
+  
+  for (; chain != NULL; chain = chain->next)
+    {
+      GList *link = chain->data;
+      if (has_scope (link->data, scope))
+        return link;
+    }
+
+  return NULL;
+}
+
+static void
+insert_entry (JavaCompletionCache *cache, 
+              const gchar         *file_path, 
+              const gchar         *expression, 
+              GtkTextIter         *scope, 
+              const gchar         *output, 
+              const gchar         *type)
+{
+  JavaCompletionCachePrivate *priv;
+  GtkTextBuffer *buffer;
+  GList *chain;
+  GList *link;
+  Entry *entry;
+  
+  priv = JAVA_COMPLETION_CACHE_GET_PRIVATE (cache);
+  
+  link = find_link (cache, file_path, expression, scope);
+  if (link != NULL)
+    remove_entry (cache, link);
+  
+  while (g_queue_get_length (priv->lru) >= MAX_ENTRIES)
+    remove_entry (cache, g_queue_peek_tail_link (priv->lru));
+  
+  buffer = gtk_text_iter_get_buffer (scope);
+  
+  entry = g_malloc (sizeof (Entry));
+  entry->key = get_key (cache, file_path, expression);
+  entry->file_path = g_strdup (file_path);
+  entry->root = get_root (expression);
+  entry->scope = g_object_ref (gtk_text_buffer_create_mark (buffer, NULL, scope, FALSE));
+  entry->output = g_strdup (output);
+  entry->type = g_strdup (type);
+  
+  g_queue_push_head (priv->lru, entry);
+  link = g_queue_peek_head_link (priv->lru);
+  
+  chain = g_hash_table_lookup (priv->entries, entry->key);
+  g_hash_table_steal (priv->entries, entry->key);
+  g_hash_table_insert (priv->entries, entry->key, g_list_prepend (chain, link));
+}
+
+static gchar*
+get_key (JavaCompletionCache *cache, 
+         const gchar         *file_path, 
+         const gchar         *expression)
+{
+  return g_strconcat (file_path, "\t", expression, NULL);
+}
+
+/*
+ * The variable, field or method the expression starts with, for example 
+ * tableModel in tableModel.getItems().
+ */
+static gchar*
+get_root (const gchar *expression)
+{
+  return g_strndup (expression, strcspn (expression, ".("));
+}
+
+static gboolean
+has_scope (Entry       *entry, 
+           GtkTextIter *scope)
+{
+  GtkTextBuffer *buffer;
+  GtkTextIter iter;
+  
+  if (gtk_text_mark_get_deleted (entry->scope))
+    return FALSE;
+  
+  buffer = gtk_text_mark_get_buffer (entry->scope);
+  if (buffer != gtk_text_iter_get_buffer (scope))
+    return FALSE;
+  
+  gtk_text_buffer_get_iter_at_mark (buffer, &iter, entry->scope);
+  
+  return gtk_text_iter_equal (&iter, scope);
+}
+
+/*
+ * Whether the root shows up in the text as something being declared, which 
+ * means it follows a type such as Foo root, List<Foo> root or Foo[] root, 
+ * rather than an operator or a keyword such as return root.
+ */
+static gboolean
+is_declared (const gchar *text, 
+             const gchar *root)
+{
+  const gchar *found;
+  gsize length;
+  
+  length = strlen (root);
+  if (length == 0)
+    return FALSE;
+  
+  for (found = strstr (text, root); found != NULL; found = strstr (found + 1, root))
+    {
+      const gchar *prev;
+      const gchar *word_end;
+      const gchar *word_start;
+      gchar *word;
+      gboolean keyword;
+      
+      if (found > text && (g_ascii_isalnum (found[-1]) || found[-1] == '_'))
+        continue;
+      if (g_ascii_isalnum (found[length]) || found[length] == '_')
+        continue;
+      
+      prev = found;
+      while (prev > text && g_ascii_isspace (prev[-1]))
+        prev--;
+      
+      if (prev == text)
+        continue;
+      
+      if (prev[-1] == '>' || prev[-1] == ']')
+        return TRUE;
+      
+      if (!g_ascii_isalnum (prev[-1]) && prev[-1] != '_')
+        continue;
+      
+      word_end = prev;
+      word_start = prev;
+      while (word_start > text && (g_ascii_isalnum (word_start[-1]) || word_start[-1] == '_'))
+        word_start--;
+      
+      word = g_strndup (word_start, word_end - word_start);
+      keyword = is_keyword (word);
+      g_free (word);
+      
+      if (!keyword)
+        return TRUE;
+    }
+    
+  return FALSE;
+}
+
+static void
+invalidate_file (JavaCompletionCache *cache, 
+                 const gchar         *file_path)
+{
+  JavaCompletionCachePrivate *priv;
+  GList *list;
+  
+  priv = JAVA_COMPLETION_CACHE_GET_PRIVATE (cache);
+  
+  list = g_queue_peek_head_link (priv->lru);
+  while (list != NULL)
+    {
+      Entry *entry = list->data;
+      GList *next = list->next;
+      
+      if (g_strcmp0 (entry->file_path, file_path) == 0)
+        remove_entry (cache, list);
+        
+      list = next;
+    }
+}
+
+static void
+remove_entry (JavaCompletionCache *cache, 
+              GList               *link)
+{
+  JavaCompletionCachePrivate *priv;
+  Entry *entry;
+  GList *chain;
+  
+  priv = JAVA_COMPLETION_CACHE_GET_PRIVATE (cache);
+  
+  entry = link->data;
+  
+  chain = g_hash_table_lookup (priv->entries, entry->key);
+  g_hash_table_steal (priv->entries, entry->key);
+  chain = g_list_remove (chain, link);
+  
+  if (chain != NULL)
+    {
+      Entry *other = ((GList*) chain->data)->data;
+      g_hash_table_insert (priv->entries, other->key, chain);
+    }
+  
+  g_queue_delete_link (priv->lru, link);
+  
+  if (!gtk_text_mark_get_deleted (entry->scope))
+    gtk_text_buffer_delete_mark (gtk_text_mark_get_buffer (entry->scope), entry->scope);
+  
+  g_object_unref (entry->scope);
+  g_free (entry->key);
+  g_free (entry->file_path);
+  g_free (entry->root);
+  g_free (entry->output);
+  g_free (entry->type);
+  g_free (entry);
+}
+
+/*
+ * The members of a type go when the file of a class by the same name has a 
+ * declaration edited, which errs on the side of asking the server again.
+ */
+static gboolean
+mentions_type (const gchar *type, 
+               const gchar *output, 
+               const gchar *name)
+{
+  return strstr (type, name) != NULL;
+}
+
+static void
+remove_all (JavaCompletionCache *cache)
+{
+  JavaCompletionCachePrivate *priv;
+  priv = JAVA_COMPLETION_CACHE_GET_PRIVATE (cache);
+  
+  while (!g_queue_is_empty (priv->lru))
+    remove_entry (cache, g_queue_peek_head_link (priv->lru));
+}
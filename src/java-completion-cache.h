@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __JAVA_COMPLETION_CACHE_H__
+#define	__JAVA_COMPLETION_CACHE_H__
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+#define JAVA_COMPLETION_CACHE_TYPE            (java_completion_cache_get_type ())
+#define JAVA_COMPLETION_CACHE(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), JAVA_COMPLETION_CACHE_TYPE, JavaCompletionCache))
+#define JAVA_COMPLETION_CACHE_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), JAVA_COMPLETION_CACHE_TYPE, JavaCompletionCacheClass))
+#define IS_JAVA_COMPLETION_CACHE(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), JAVA_COMPLETION_CACHE_TYPE))
+#define IS_JAVA_COMPLETION_CACHE_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), JAVA_COMPLETION_CACHE_TYPE))
+
+typedef struct _JavaCompletionCache JavaCompletionCache;
+typedef struct _JavaCompletionCacheClass JavaCompletionCacheClass;
+
+struct _JavaCompletionCache
+{
+  GObject parent_instance;
+};
+
+struct _JavaCompletionCacheClass
+{
+  GObjectClass parent_class;
+};
+
+GType java_completion_cache_get_type (void) G_GNUC_CONST;
+
+JavaCompletionCache*  java_completion_cache_new                 (void);
+
+const gchar*          java_completion_cache_lookup              (JavaCompletionCache *cache, 
+                                                                 const gchar         *file_path, 
+                                                                 const gchar         *expression, 
+                                                                 GtkTextIter         *scope);
+void                  java_completion_cache_insert              (JavaCompletionCache *cache, 
+                                                                 const gchar         *file_path, 
+                                                                 const gchar         *expression, 
+                                                                 GtkTextIter         *scope, 
+                                                                 const gchar         *output);
+void                  java_completion_cache_append              (JavaCompletionCache *cache, 
+                                                                 const gchar         *file_path, 
+                                                                 const gchar         *expression, 
+                                                                 GtkTextIter         *scope, 
+                                                                 gint                 offset, 
+                                                                 const gchar         *output);
+gint                  java_completion_cache_get_next_offset     (const gchar         *output, 
+                                                                 gsize               *length);
+const gchar*          java_completion_cache_get_resolved_type   (JavaCompletionCache *cache, 
+                                                                 const gchar         *file_path, 
+                                                                 const gchar         *expression, 
+                                                                 GtkTextIter         *scope);
+const gchar*          java_completion_cache_lookup_resolved     (JavaCompletionCache *cache, 
+                                                                 const gchar         *file_path, 
+                                                                 const gchar         *expression, 
+                                                                 GtkTextIter         *start, 
+                                                                 GtkTextIter         *scope);
+void                  java_completion_cache_insert_resolved     (JavaCompletionCache *cache, 
+                                                                 const gchar         *file_path, 
+                                                                 const gchar         *expression, 
+                                                                 GtkTextIter         *start, 
+                                                                 GtkTextIter         *scope, 
+                                                                 const gchar         *output);
+void                  java_completion_cache_edited              (JavaCompletionCache *cache, 
+                                                                 const gchar         *file_path, 
+                                                                 const gchar         *text);
+void                  java_completion_cache_next_generation     (JavaCompletionCache *cache);
+guint                 java_completion_cache_get_generation      (JavaCompletionCache *cache);
+const gchar*          java_completion_cache_lookup_type         (JavaCompletionCache *cache, 
+                                                                 const gchar         *type);
+void                  java_completion_cache_insert_type         (JavaCompletionCache *cache, 
+                                                                 const gchar         *type, 
+                                                                 const gchar         *output);
+const gchar*          java_completion_cache_lookup_classes      (JavaCompletionCache *cache, 
+                                                                 const gchar         *letter);
+void                  java_completion_cache_insert_classes      (JavaCompletionCache *cache, 
+                                                                 const gchar         *letter, 
+                                                                 const gchar         *output);
+void                  java_completion_cache_get_scope           (GtkTextIter         *iter, 
+                                                                 GtkTextIter         *scope);
+
+G_END_DECLS
+
+#endif /* __JAVA_COMPLETION_CACHE_H__ */
@@ -19,6 +19,7 @@
 #include <codeslayer/codeslayer-utils.h>
 #include "java-completion-class.h"
 #include "java-utils.h"
+#include "java-matcher.h"
 
 static void java_completion_provider_interface_init  (gpointer                    page, 
                                                       gpointer                    data);
@@ -32,14 +33,33 @@ static gboolean has_match                            (GtkTextIter
 
 static gchar* get_input                              (JavaCompletionKlass       *klass, 
                                                       const gchar               *file_path, 
-                                                      gchar                     *expression, 
+                                                      const gchar               *expression, 
                                                       gint                       line_number);                                                      
-static GList* render_output                          (JavaCompletionKlass       *klass, 
-                                                      gchar                     *output, 
-                                                      GtkTextMark               *mark);
-static CodeSlayerCompletionProposal*  render_line    (JavaCompletionKlass       *klass, 
-                                                      gchar                     *line, 
+static gboolean can_filter                           (JavaCompletionKlass       *klass, 
+                                                      const gchar               *file_path, 
+                                                      const gchar               *prefix);
+static gchar* get_classes                            (JavaCompletionKlass       *klass, 
+                                                      const gchar               *file_path, 
+                                                      GtkTextIter                iter, 
+                                                      const gchar               *prefix);
+static void keep_classes                             (JavaCompletionKlass       *klass, 
+                                                      const gchar               *file_path, 
+                                                      const gchar               *prefix, 
+                                                      gchar                     *output);
+static void clear_classes                            (JavaCompletionKlass       *klass);
+static gchar* get_request_prefix                     (JavaCompletionKlass       *klass, 
+                                                      const gchar               *file_path, 
+                                                      const gchar               *text);
+static GList* render_classes                         (JavaCompletionKlass       *klass, 
+                                                      const gchar               *prefix, 
                                                       GtkTextMark               *mark);
+static void insert_text_action                       (JavaCompletionKlass       *klass, 
+                                                      GtkTextIter               *location, 
+                                                      gchar                     *text, 
+                                                      gint                       length);
+
+#define MAX_CLASSES 20000
+#define MAX_PROPOSALS 200
 
 #define JAVA_COMPLETION_KLASS_GET_PRIVATE(obj) \
   (G_TYPE_INSTANCE_GET_PRIVATE ((obj), JAVA_COMPLETION_KLASS_TYPE, JavaCompletionKlassPrivate))
@@ -48,9 +68,17 @@ typedef struct _JavaCompletionKlassPrivate JavaCompletionKlassPrivate;
 
 struct _JavaCompletionKlassPrivate
 {
-  CodeSlayer       *codeslayer;
-  CodeSlayerEditor *editor;
-  JavaClient       *client;
+  CodeSlayer          *codeslayer;
+  CodeSlayerEditor    *editor;
+  JavaClient          *client;
+  JavaCompletionCache *cache;
+  gchar               *file_path;
+  gchar               *prefix;
+  JavaMatcher         *matcher;
+  JavaRanking         *ranking;
+  GHashTable          *shown;
+  guint                generation;
+  gboolean             truncated;
 };
 
 G_DEFINE_TYPE_EXTENDED (JavaCompletionKlass,
@@ -79,27 +107,52 @@ java_completion_klass_class_init (JavaCompletionKlassClass *klass)
 static void
 java_completion_klass_init (JavaCompletionKlass *klass)
 {
+  JavaCompletionKlassPrivate *priv;
+  priv = JAVA_COMPLETION_KLASS_GET_PRIVATE (klass);
+  priv->file_path = NULL;
+  priv->prefix = NULL;
+  priv->matcher = java_matcher_new ();
+  priv->shown = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
 }
 
 static void
 java_completion_klass_finalize (JavaCompletionKlass *klass)
 {
+  JavaCompletionKlassPrivate *priv;
+  priv = JAVA_COMPLETION_KLASS_GET_PRIVATE (klass);
+  clear_classes (klass);
+  g_object_unref (priv->matcher);
+  g_hash_table_destroy (priv->shown);
   G_OBJECT_CLASS (java_completion_klass_parent_class)->finalize (G_OBJECT (klass));
 }
 
 JavaCompletionKlass*
-java_completion_klass_new (CodeSlayer       *codeslayer, 
-                           CodeSlayerEditor *editor, 
-                           JavaClient       *client)
+java_completion_klass_new (CodeSlayer          *codeslayer, 
+                           CodeSlayerEditor    *editor, 
+                           JavaClient          *client, 
+                           JavaCompletionCache *cache, 
+                           JavaRanking         *ranking)
 {
   JavaCompletionKlassPrivate *priv;
   JavaCompletionKlass *klass;
+  GtkTextBuffer *buffer;
 
   klass = JAVA_COMPLETION_KLASS (g_object_new (java_completion_klass_get_type (), NULL));
   priv = JAVA_COMPLETION_KLASS_GET_PRIVATE (klass);
   priv->codeslayer = codeslayer;
   priv->editor = editor;
   priv->client = client;
+  priv->cache = cache;
+  priv->ranking = ranking;
+  
+  java_matcher_set_substrings (priv->matcher, FALSE);
+  java_matcher_set_ranking (priv->matcher, ranking);
+  
+  buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (editor));
+  
+  g_signal_connect_object (G_OBJECT (buffer), "insert-text",
+                           G_CALLBACK (insert_text_action), klass, 
+                           G_CONNECT_SWAPPED);
 
   return klass;
 }
@@ -114,9 +167,7 @@ java_completion_get_proposals (JavaCompletionKlass *klass,
   gchar *text;
   GtkTextIter start;
   GtkTextBuffer *buffer;
-  gint line_number;
-  gchar *input;
-  gchar *output;
+  GtkTextMark *mark;
   
   priv = JAVA_COMPLETION_KLASS_GET_PRIVATE (klass);
   
@@ -130,28 +181,36 @@ java_completion_get_proposals (JavaCompletionKlass *klass,
   if (!g_str_has_suffix (file_path, ".java"))
     return NULL;
   
-  line_number = gtk_text_iter_get_line (&iter);
-  
   buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (priv->editor));
 
   text = gtk_text_iter_get_text (&start, &iter);
   
-  input = get_input (klass, file_path, text, line_number);
-
-  g_print ("input: %s\n", input);
+  if (!can_filter (klass, file_path, text))
+    {
+      gchar *prefix;
+      gchar *output;
+      
+      prefix = get_request_prefix (klass, file_path, text);
+      clear_classes (klass);
+  
+      output = get_classes (klass, file_path, iter, prefix);
+      
+      if (output != NULL)
+        {
+          keep_classes (klass, file_path, prefix, output);
+          g_free (output);
+        }
 
-  output = java_client_send (priv->client, input);
+      g_free (prefix);
+    }
   
-  if (output != NULL)
+  if (java_matcher_get_count (priv->matcher) > 0)
     {
-      GtkTextMark *mark;
       mark = gtk_text_buffer_create_mark (buffer, NULL, &start, TRUE);
-      g_print ("output: %s\n", output);
-      proposals = render_output (klass, output, mark);
-      g_free (output);
+      java_matcher_set_context (priv->matcher, buffer);
+      proposals = render_classes (klass, text, mark);
     }
 
-  g_free (input);
   g_free (text);
 
   return proposals; 
@@ -160,7 +219,7 @@ java_completion_get_proposals (JavaCompletionKlass *klass,
 static gchar* 
 get_input (JavaCompletionKlass *klass, 
            const gchar         *file_path, 
-           gchar               *expression, 
+           const gchar         *expression, 
            gint                 line_number)
 {
   JavaCompletionKlassPrivate *priv;
@@ -189,79 +248,182 @@ get_input (JavaCompletionKlass *klass,
   return result;
 }
 
-static GList*
-render_output (JavaCompletionKlass *klass, 
-               gchar               *output, 
-               GtkTextMark         *mark)
+/*
+ * The classes from the last request are kept, so that as the prefix grows 
+ * they only need to be narrowed down here. That is only safe when they are 
+ * every class that starts with the letter that was sent: a longer prefix 
+ * only brings back the classes that start with it exactly, and the matcher 
+ * would miss the humps and the other case. So a new request is needed when 
+ * the prefix no longer starts with the one that was sent, when more than 
+ * one letter was sent, when the classes were cut short, or when the indexes 
+ * were rebuilt since.
+ */
+static gboolean
+can_filter (JavaCompletionKlass *klass, 
+            const gchar         *file_path, 
+            const gchar         *prefix)
 {
-  GList *proposals = NULL;
-  gchar **split;
-  gchar **tmp;
+  JavaCompletionKlassPrivate *priv;
+  priv = JAVA_COMPLETION_KLASS_GET_PRIVATE (klass);
   
-  if (!codeslayer_utils_has_text (output))
-    return NULL;
+  return priv->file_path != NULL && !priv->truncated && 
+         g_utf8_strlen (priv->prefix, -1) == 1 && 
+         priv->generation == java_completion_cache_get_generation (priv->cache) && 
+         g_strcmp0 (priv->file_path, file_path) == 0 && 
+         g_str_has_prefix (prefix, priv->prefix);
+}
+
+/*
+ * Only the first letter is sent, so that the matcher has every class that 
+ * could match the humps or the letters typed after it. When that was more 
+ * than MAX_CLASSES the whole prefix is sent instead, and then only the 
+ * classes that start with it are found.
+ */
+static gchar*
+get_request_prefix (JavaCompletionKlass *klass, 
+                    const gchar         *file_path, 
+                    const gchar         *text)
+{
+  JavaCompletionKlassPrivate *priv;
+  priv = JAVA_COMPLETION_KLASS_GET_PRIVATE (klass);
   
-  split = g_strsplit (output, "\n", -1);
+  if (priv->truncated && 
+      g_strcmp0 (priv->file_path, file_path) == 0 && 
+      g_str_has_prefix (text, priv->prefix))
+    return g_strdup (text);
+  
+  return g_strndup (text, g_utf8_next_char (text) - text);
+}
 
-  if (split != NULL)
+/*
+ * The classes for a single letter come from the cache that all the editors 
+ * share, so the thousands of them are fetched once and not once per editor.
+ */
+static gchar*
+get_classes (JavaCompletionKlass *klass, 
+             const gchar         *file_path, 
+             GtkTextIter          iter, 
+             const gchar         *prefix)
+{
+  JavaCompletionKlassPrivate *priv;
+  const gchar *cached;
+  gboolean letter;
+  gchar *input;
+  gchar *output;
+  
+  priv = JAVA_COMPLETION_KLASS_GET_PRIVATE (klass);
+  
+  letter = g_utf8_strlen (prefix, -1) == 1;
+  
+  if (letter)
     {
-      tmp = split;
-      while (*tmp != NULL)
-        {
-          CodeSlayerCompletionProposal *proposal;
-          proposal = render_line (klass, *tmp, mark);
-          if (proposal != NULL)
-            proposals = g_list_append (proposals, proposal);
-          tmp++;
-        }
-      g_strfreev (split);
+      cached = java_completion_cache_lookup_classes (priv->cache, prefix);
+      if (cached != NULL)
+        return g_strdup (cached);
     }
-    
-   return proposals;   
+  
+  input = get_input (klass, file_path, prefix, gtk_text_iter_get_line (&iter));
+  output = java_client_send (priv->client, input);
+  g_free (input);
+  
+  if (letter && output != NULL)
+    java_completion_cache_insert_classes (priv->cache, prefix, output);
+  
+  return output;
 }
 
-static CodeSlayerCompletionProposal*
-render_line (JavaCompletionKlass *klass, 
-             gchar               *line, 
-             GtkTextMark         *mark)
+/*
+ * Keeps the classes from the output. When there are more than MAX_CLASSES 
+ * only the first ones are kept for this completion, and the next keystroke 
+ * goes back to the server since the set is not complete.
+ */
+static void
+keep_classes (JavaCompletionKlass *klass, 
+              const gchar         *file_path, 
+              const gchar         *prefix, 
+              gchar               *output)
 {
+  JavaCompletionKlassPrivate *priv;
   gchar **split;
   gchar **tmp;
   
-  if (!codeslayer_utils_has_text (line))
-    return NULL;
+  priv = JAVA_COMPLETION_KLASS_GET_PRIVATE (klass);
   
-  split = g_strsplit (line, "\t", -1);
-  if (split != NULL)
+  if (!codeslayer_utils_has_text (output))
+    return;
+  
+  split = g_strsplit (output, "\n", -1);
+  for (tmp = split; *tmp != NULL; tmp++)
     {
-      CodeSlayerCompletionProposal *proposal = NULL;
-      gchar *simple_class_name;  
+      gchar **fields;
       
-      gchar *match_label;
-      gchar *match_text;
-      
-      tmp = split;
-
-      simple_class_name = *tmp;
+      if (!codeslayer_utils_has_text (*tmp) || 
+          g_strcmp0 (*tmp, "NO_RESULTS_FOUND") == 0)
+        continue;
       
-      if (simple_class_name != NULL)
-        {
-          match_label = g_strdup_printf ("%s", simple_class_name);
-          match_text = g_strdup_printf ("%s", simple_class_name);
-          
-          proposal = codeslayer_completion_proposal_new (match_label, g_strstrip (match_text), mark);
-          
-          g_free (match_label);
-          g_free (match_text);
-
-        }      
+      if (java_matcher_get_count (priv->matcher) >= MAX_CLASSES)
+        break;
+        
+      fields = g_strsplit (*tmp, "\t", 3);
+      java_matcher_add (priv->matcher, g_strstrip (fields[0]), fields[1], 
+                        fields[1] != NULL ? fields[2] : NULL);
+      g_strfreev (fields);
+    }
+  
+  priv->file_path = g_strdup (file_path);
+  priv->prefix = g_strdup (prefix);
+  priv->generation = java_completion_cache_get_generation (priv->cache);
+  priv->truncated = *tmp != NULL;
+  
+  g_strfreev (split);
+}
 
-      g_strfreev (split);
+static void
+clear_classes (JavaCompletionKlass *klass)
+{
+  JavaCompletionKlassPrivate *priv;
+  priv = JAVA_COMPLETION_KLASS_GET_PRIVATE (klass);
+  
+  java_matcher_clear (priv->matcher);
+  
+  g_free (priv->file_path);
+  g_free (priv->prefix);
+  priv->file_path = NULL;
+  priv->prefix = NULL;
+}
 
-      return proposal;
+static GList*
+render_classes (JavaCompletionKlass *klass, 
+                const gchar         *prefix, 
+                GtkTextMark         *mark)
+{
+  JavaCompletionKlassPrivate *priv;
+  GList *proposals = NULL;
+  GList *matches;
+  GList *list;
+  
+  priv = JAVA_COMPLETION_KLASS_GET_PRIVATE (klass);
+  
+  matches = java_matcher_find (priv->matcher, prefix, MAX_PROPOSALS);
+  
+  g_hash_table_remove_all (priv->shown);
+  
+  for (list = matches; list != NULL; list = g_list_next (list))
+    {
+      JavaMatch *match = list->data;
+      CodeSlayerCompletionProposal *proposal;
+      if (match->class_name != NULL && 
+          !g_hash_table_contains (priv->shown, match->simple_class_name))
+        g_hash_table_insert (priv->shown, g_strdup (match->simple_class_name), 
+                             g_strdup (match->class_name));
+      proposal = codeslayer_completion_proposal_new (match->simple_class_name, 
+                                                     match->simple_class_name, mark);
+      proposals = g_list_prepend (proposals, proposal);
     }
   
-  return NULL;
+  g_list_free (matches);
+    
+  return g_list_reverse (proposals);
 }
 
 static gboolean
@@ -283,3 +445,36 @@ has_match (GtkTextIter start)
   
   return result;
 }
+
+/*
+ * A class proposal is taken to be accepted when its name is inserted in 
+ * one go. When several classes share the name the best ranked one gets 
+ * the credit, as that is the one the popup showed first.
+ */
+static void
+insert_text_action (JavaCompletionKlass *klass, 
+                    GtkTextIter         *location, 
+                    gchar               *text, 
+                    gint                 length)
+{
+  JavaCompletionKlassPrivate *priv;
+  const gchar *class_name;
+  gchar *inserted;
+  
+  priv = JAVA_COMPLETION_KLASS_GET_PRIVATE (klass);
+  
+  if (length < 2 || g_hash_table_size (priv->shown) == 0)
+    return;
+  
+  inserted = g_strndup (text, length);
+  class_name = g_hash_table_lookup (priv->shown, inserted);
+  
+  if (class_name != NULL)
+    {
+      java_ranking_accept (priv->ranking, JAVA_RANKING_CLASS, class_name);
+      java_matcher_use (priv->matcher, class_name);
+      g_hash_table_remove_all (priv->shown);
+    }
+  
+  g_free (inserted);
+}
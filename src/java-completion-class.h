@@ -22,6 +22,8 @@
 #include <gtk/gtk.h>
 #include <codeslayer/codeslayer.h>
 #include "java-client.h"
+#include "java-completion-cache.h"
+#include "java-ranking.h"
 
 G_BEGIN_DECLS
 
@@ -46,9 +48,11 @@ struct _JavaCompletionKlassClass
 
 GType java_completion_klass_get_type (void) G_GNUC_CONST;
 
-JavaCompletionKlass*  java_completion_klass_new  (CodeSlayer       *codeslayer, 
-                                                  CodeSlayerEditor *editor,
-                                                  JavaClient       *client);
+JavaCompletionKlass*  java_completion_klass_new  (CodeSlayer          *codeslayer, 
+                                                  CodeSlayerEditor    *editor,
+                                                  JavaClient          *client, 
+                                                  JavaCompletionCache *cache, 
+                                                  JavaRanking         *ranking);
 
 G_END_DECLS
 
@@ -16,10 +16,28 @@
  * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
  */
 
+#include <string.h>
 #include <codeslayer/codeslayer-utils.h>
 #include "java-completion-method.h"
 #include "java-utils.h"
 
+typedef struct
+{
+  JavaCompletionMethod *method;
+  GCancellable         *cancellable;
+  gchar                *file_path;
+  gchar                *expression;
+  gchar                *output;
+  gint                  offset;
+} Prefetch;
+
+typedef struct
+{
+  CodeSlayerCompletionProposal *proposal;
+  guint                         score;
+  guint                         order;
+} Ranked;
+
 static void java_completion_provider_interface_init  (gpointer                    page, 
                                                       gpointer                    data);
 static void java_completion_method_class_init        (JavaCompletionMethodClass  *klass);
@@ -29,19 +47,51 @@ static void java_completion_method_finalize          (JavaCompletionMethod
 static GList* java_completion_get_proposals          (JavaCompletionMethod       *method, 
                                                       GtkTextIter                 iter);
 static gboolean has_match                            (GtkTextIter                 start);
-static gchar* get_input                              (JavaCompletionMethod       *method, 
-                                                      const gchar                *file_path, 
-                                                      gchar                      *expression, 
-                                                      gint                        line_number);                                                      
 static GList* render_output                          (JavaCompletionMethod       *method, 
                                                       gchar                      *output, 
                                                       GtkTextMark                *mark);
 static CodeSlayerCompletionProposal* render_line     (JavaCompletionMethod       *method, 
                                                       gchar                      *line, 
-                                                      GtkTextMark                *mark);
+                                                      GtkTextMark                *mark, 
+                                                      guint                      *score);
+static gint compare_ranked                           (Ranked                     *ranked1, 
+                                                      Ranked                     *ranked2);
+static void set_shown_type                           (JavaCompletionMethod       *method, 
+                                                      const gchar                *file_path, 
+                                                      const gchar                *expression, 
+                                                      GtkTextIter                *scope);
+static void accept_proposal                          (JavaCompletionMethod       *method, 
+                                                      const gchar                *text, 
+                                                      gint                        length);
                                                       
-static gchar* get_text                               (GtkTextBuffer              *buffer, 
-                                                      GtkTextIter                 iter);
+static void insert_text_action                       (JavaCompletionMethod       *method, 
+                                                      GtkTextIter                *location, 
+                                                      gchar                      *text, 
+                                                      gint                        length);
+static void delete_range_action                      (JavaCompletionMethod       *method, 
+                                                      GtkTextIter                *start, 
+                                                      GtkTextIter                *end);
+static void edited                                   (JavaCompletionMethod       *method, 
+                                                      GtkTextIter                 start, 
+                                                      GtkTextIter                 end);
+static void cursor_moved_action                      (JavaCompletionMethod       *method);
+static gboolean in_expression                        (JavaCompletionMethod       *method, 
+                                                      GtkTextIter                *iter);
+static gboolean prefetch_timeout                     (JavaCompletionMethod       *method);
+static void fetch_page                               (JavaCompletionMethod       *method, 
+                                                      const gchar                *file_path, 
+                                                      gchar                      *expression, 
+                                                      GtkTextIter                *start, 
+                                                      gint                        line_number, 
+                                                      gint                        offset);
+static void prefetch_callback                        (gchar                      *output, 
+                                                      Prefetch                   *prefetch);
+static gboolean prefetch_idle                        (Prefetch                   *prefetch);
+static void destroy_prefetch                         (Prefetch                   *prefetch);
+static void cancel_prefetch                          (JavaCompletionMethod       *method);
+
+#define PREFETCH_DELAY 300
+#define METHOD_PAGE_SIZE 100
 
 #define JAVA_COMPLETION_METHOD_GET_PRIVATE(obj) \
   (G_TYPE_INSTANCE_GET_PRIVATE ((obj), JAVA_COMPLETION_METHOD_TYPE, JavaCompletionMethodPrivate))
@@ -50,9 +100,16 @@ typedef struct _JavaCompletionMethodPrivate JavaCompletionMethodPrivate;
 
 struct _JavaCompletionMethodPrivate
 {
-  CodeSlayer         *codeslayer;
-  CodeSlayerEditor   *editor;
-  JavaClient         *client;
+  CodeSlayer          *codeslayer;
+  CodeSlayerEditor    *editor;
+  JavaClient          *client;
+  JavaCompletionCache *cache;
+  JavaRanking         *ranking;
+  GHashTable          *shown;
+  gchar               *shown_type;
+  GCancellable        *prefetch;
+  GtkTextMark         *prefetch_mark;
+  guint                prefetch_id;
 };
 
 G_DEFINE_TYPE_EXTENDED (JavaCompletionMethod,
@@ -81,31 +138,105 @@ java_completion_method_class_init (JavaCompletionMethodClass *klass)
 static void
 java_completion_method_init (JavaCompletionMethod *method)
 {
+  JavaCompletionMethodPrivate *priv;
+  priv = JAVA_COMPLETION_METHOD_GET_PRIVATE (method);
+  priv->prefetch = NULL;
+  priv->prefetch_mark = NULL;
+  priv->prefetch_id = 0;
+  priv->shown = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+  priv->shown_type = NULL;
 }
 
 static void
 java_completion_method_finalize (JavaCompletionMethod *method)
 {
+  JavaCompletionMethodPrivate *priv;
+  priv = JAVA_COMPLETION_METHOD_GET_PRIVATE (method);
+  
+  if (priv->prefetch_id != 0)
+    g_source_remove (priv->prefetch_id);
+  
+  cancel_prefetch (method);
+  
+  g_hash_table_destroy (priv->shown);
+  g_free (priv->shown_type);
+  
   G_OBJECT_CLASS (java_completion_method_parent_class)->finalize (G_OBJECT (method));
 }
 
 JavaCompletionMethod*
-java_completion_method_new (CodeSlayer       *codeslayer, 
-                            CodeSlayerEditor *editor, 
-                            JavaClient       *client)
+java_completion_method_new (CodeSlayer          *codeslayer, 
+                            CodeSlayerEditor    *editor, 
+                            JavaClient          *client, 
+                            JavaCompletionCache *cache, 
+                            JavaRanking         *ranking)
 {
   JavaCompletionMethodPrivate *priv;
   JavaCompletionMethod *method;
+  GtkTextBuffer *buffer;
 
   method = JAVA_COMPLETION_METHOD (g_object_new (java_completion_method_get_type (), NULL));
   priv = JAVA_COMPLETION_METHOD_GET_PRIVATE (method);
   priv->codeslayer = codeslayer;
   priv->editor = editor;
   priv->client = client;
+  priv->cache = cache;
+  priv->ranking = ranking;
+  
+  buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (editor));
+  
+  g_signal_connect_object (G_OBJECT (buffer), "insert-text",
+                           G_CALLBACK (insert_text_action), method, 
+                           G_CONNECT_SWAPPED | G_CONNECT_AFTER);
+  
+  g_signal_connect_object (G_OBJECT (buffer), "delete-range",
+                           G_CALLBACK (delete_range_action), method, 
+                           G_CONNECT_SWAPPED);
+  
+  g_signal_connect_object (G_OBJECT (buffer), "notify::cursor-position",
+                           G_CALLBACK (cursor_moved_action), method, 
+                           G_CONNECT_SWAPPED);
 
   return method;
 }
 
+/*
+ * The input for a page of the methods of the expression, starting at the 
+ * offset. The signature help asks for the same pages, so it is shared.
+ */
+gchar* 
+java_completion_method_get_input (CodeSlayer  *codeslayer, 
+                                  const gchar *file_path, 
+                                  const gchar *expression, 
+                                  gint         line_number, 
+                                  gint         offset)
+{
+  gchar *indexes_folders;
+  gchar *line_number_str;
+  gchar *paging;
+  gchar *result;
+  
+  line_number_str = g_strdup_printf ("%d", (line_number + 1));
+  paging = g_strdup_printf (" -limit %d -offset %d", METHOD_PAGE_SIZE, offset);
+  
+  indexes_folders = java_utils_get_indexes_folder (codeslayer);
+  
+  result = g_strconcat ("-program completion", 
+                        " -type ", "method",
+                        " -sourcefile ", file_path,
+                        " -expression ", expression,
+                        " -linenumber ", line_number_str,
+                        paging, 
+                        indexes_folders, 
+                        NULL);
+  
+  g_free (indexes_folders);
+  g_free (paging);
+  g_free (line_number_str);
+
+  return result;
+}
+
 static GList* 
 java_completion_get_proposals (JavaCompletionMethod *method, 
                                GtkTextIter           iter)
@@ -113,13 +244,14 @@ java_completion_get_proposals (JavaCompletionMethod *method,
   JavaCompletionMethodPrivate *priv;
   GList *proposals = NULL;
   const gchar *file_path;
-  gchar *text;
   gchar *expression;
   GtkTextIter start;
   GtkTextBuffer *buffer;
-  gint line_number;
+  GtkTextIter scope;
+  const gchar *cached;
   gchar *input;
   gchar *output;
+  gint next_offset = -1;
 
   priv = JAVA_COMPLETION_METHOD_GET_PRIVATE (method);
   
@@ -133,120 +265,510 @@ java_completion_get_proposals (JavaCompletionMethod *method,
   if (!g_str_has_suffix (file_path, ".java"))
     return NULL;
   
-  line_number = gtk_text_iter_get_line (&iter);
-  
   buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (priv->editor));
   
-  text = get_text (buffer, start);
-  expression = java_utils_get_expression (text);
+  expression = java_utils_get_expression (start);
+  if (expression == NULL)
+    return NULL;
   
-  input = get_input (method, file_path, expression, line_number);
-
-  g_print ("input: %s\n", input);
+  java_completion_cache_get_scope (&start, &scope);
   
-  output = java_client_send (priv->client, input);
+  cached = java_completion_cache_lookup_resolved (priv->cache, file_path, expression, 
+                                                  &start, &scope);
   
-  if (output != NULL)
+  if (cached != NULL)
     {
       GtkTextMark *mark;
       mark = gtk_text_buffer_create_mark (buffer, NULL, &start, TRUE);
-      g_print ("output: %s\n", output);
-      proposals = render_output (method, output, mark);
-      g_free (output);
+      set_shown_type (method, file_path, expression, &scope);
+      proposals = render_output (method, (gchar*) cached, mark);
+      next_offset = java_completion_cache_get_next_offset (cached, NULL);
     }
+  else
+    {
+      input = java_completion_method_get_input (priv->codeslayer, file_path, expression, 
+                                                gtk_text_iter_get_line (&iter), 0);
+      
+      output = java_client_send (priv->client, input);
+      
+      if (output != NULL)
+        {
+          GtkTextMark *mark;
+          mark = gtk_text_buffer_create_mark (buffer, NULL, &start, TRUE);
+          java_completion_cache_insert_resolved (priv->cache, file_path, expression, 
+                                                 &start, &scope, output);
+          set_shown_type (method, file_path, expression, &scope);
+          proposals = render_output (method, output, mark);
+          next_offset = java_completion_cache_get_next_offset (output, NULL);
+          g_free (output);
+        }
 
-  g_free (input);
-  g_free (text);
+      g_free (input);
+    }
+  
+  /* only the first page is waited on, the next one is fetched in the background 
+     and shows up the next time the proposals are asked for */
+  if (next_offset > 0 && priv->prefetch == NULL)
+    {
+      fetch_page (method, file_path, expression, &start, 
+                  gtk_text_iter_get_line (&iter), next_offset);
+      return proposals;
+    }
+  
   g_free (expression);
   
   return proposals;
 }
 
-static gchar*
-get_text (GtkTextBuffer *buffer, 
-          GtkTextIter    iter)
+static void
+insert_text_action (JavaCompletionMethod *method, 
+                    GtkTextIter          *location, 
+                    gchar                *text, 
+                    gint                  length)
 {
   GtkTextIter start;
+  
+  start = *location;
+  gtk_text_iter_backward_chars (&start, g_utf8_strlen (text, length));
+  
+  accept_proposal (method, text, length);
+  
+  edited (method, start, *location);
+}
+
+static void
+delete_range_action (JavaCompletionMethod *method, 
+                     GtkTextIter          *start, 
+                     GtkTextIter          *end)
+{
+  edited (method, *start, *end);
+}
+
+/*
+ * Hands the whole lines around an edit to the cache, so that it can tell 
+ * whether the edit changed a declaration it relies on.
+ */
+static void
+edited (JavaCompletionMethod *method, 
+        GtkTextIter           start, 
+        GtkTextIter           end)
+{
+  JavaCompletionMethodPrivate *priv;
+  GtkTextBuffer *buffer;
+  const gchar *file_path;
   gchar *text;
   
-  gtk_text_buffer_get_start_iter (buffer, &start);
+  priv = JAVA_COMPLETION_METHOD_GET_PRIVATE (method);
   
-  text = gtk_text_buffer_get_text (buffer, &start, &iter, FALSE);
+  file_path = codeslayer_editor_get_file_path (priv->editor);
+  if (!g_str_has_suffix (file_path, ".java"))
+    return;
+  
+  buffer = gtk_text_iter_get_buffer (&start);
+  
+  gtk_text_iter_set_line_offset (&start, 0);
+  if (!gtk_text_iter_ends_line (&end))
+    gtk_text_iter_forward_to_line_end (&end);
+  
+  text = gtk_text_buffer_get_text (buffer, &start, &end, FALSE);
+  java_completion_cache_edited (priv->cache, file_path, text);
+  g_free (text);
+}
 
-  return text;
+/*
+ * Asks the server ahead of time, so that the cache already has the members 
+ * by the time the popup wants them. That happens right after a dot is 
+ * typed, or when the caret stops after the start of a member name. The 
+ * prefetch is cancelled as soon as the caret leaves the member name.
+ */
+static void
+cursor_moved_action (JavaCompletionMethod *method)
+{
+  JavaCompletionMethodPrivate *priv;
+  GtkTextBuffer *buffer;
+  GtkTextIter iter;
+  GtkTextIter prev;
+  gunichar ch;
+  
+  priv = JAVA_COMPLETION_METHOD_GET_PRIVATE (method);
+  
+  buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (priv->editor));
+  gtk_text_buffer_get_iter_at_mark (buffer, &iter, gtk_text_buffer_get_insert (buffer));
+  
+  if (priv->prefetch != NULL && !in_expression (method, &iter))
+    cancel_prefetch (method);
+  
+  if (priv->prefetch_id != 0)
+    {
+      g_source_remove (priv->prefetch_id);
+      priv->prefetch_id = 0;
+    }
+  
+  prev = iter;
+  if (!gtk_text_iter_backward_char (&prev))
+    return;
+  
+  ch = gtk_text_iter_get_char (&prev);
+  
+  if (ch == '.')
+    priv->prefetch_id = g_idle_add_full (G_PRIORITY_LOW, (GSourceFunc) prefetch_timeout, 
+                                         method, NULL);
+  else if (g_unichar_isalnum (ch) || ch == '_')
+    priv->prefetch_id = g_timeout_add (PREFETCH_DELAY, (GSourceFunc) prefetch_timeout, method);
 }
 
-static gchar* 
-get_input (JavaCompletionMethod *method, 
-           const gchar          *file_path, 
-           gchar                *expression, 
-           gint                  line_number)
+/*
+ * Whether the iter is still on the member name that is being prefetched.
+ */
+static gboolean
+in_expression (JavaCompletionMethod *method, 
+               GtkTextIter          *iter)
 {
   JavaCompletionMethodPrivate *priv;
+  GtkTextIter start;
+  
+  priv = JAVA_COMPLETION_METHOD_GET_PRIVATE (method);
+  
+  gtk_text_buffer_get_iter_at_mark (gtk_text_iter_get_buffer (iter), &start, priv->prefetch_mark);
+  
+  if (gtk_text_iter_get_line (&start) != gtk_text_iter_get_line (iter) || 
+      gtk_text_iter_compare (&start, iter) > 0)
+    return FALSE;
+  
+  while (gtk_text_iter_compare (&start, iter) < 0)
+    {
+      gunichar ch = gtk_text_iter_get_char (&start);
+      if (!g_unichar_isalnum (ch) && ch != '_')
+        return FALSE;
+      gtk_text_iter_forward_char (&start);
+    }
+  
+  return TRUE;
+}
 
-  gchar *indexes_folders;
-  gchar *line_number_str;
-  gchar *result;
+static gboolean
+prefetch_timeout (JavaCompletionMethod *method)
+{
+  JavaCompletionMethodPrivate *priv;
+  GtkTextBuffer *buffer;
+  const gchar *file_path;
+  GtkTextIter iter;
+  GtkTextIter start;
+  GtkTextIter scope;
+  gchar *expression;
   
   priv = JAVA_COMPLETION_METHOD_GET_PRIVATE (method);
+  priv->prefetch_id = 0;
   
-  line_number_str = g_strdup_printf ("%d", (line_number + 1));
+  file_path = codeslayer_editor_get_file_path (priv->editor);
+  if (file_path == NULL || !g_str_has_suffix (file_path, ".java"))
+    return FALSE;
   
-  indexes_folders = java_utils_get_indexes_folder (priv->codeslayer);
+  buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (priv->editor));
+  gtk_text_buffer_get_iter_at_mark (buffer, &iter, gtk_text_buffer_get_insert (buffer));
   
-  result = g_strconcat ("-program completion", 
-                        " -type ", "method",
-                        " -sourcefile ", file_path,
-                        " -expression ", expression,
-                        " -linenumber ", line_number_str,
-                        indexes_folders, 
-                        NULL);
+  start = iter;
+  java_utils_move_iter_word_start (&start);
   
-  g_free (indexes_folders);
-  g_free (line_number_str);
+  if (!has_match (start))
+    return FALSE;
+  
+  if (priv->prefetch != NULL && in_expression (method, &iter))
+    return FALSE;
+  
+  expression = java_utils_get_expression (start);
+  if (expression == NULL)
+    return FALSE;
+  
+  java_completion_cache_get_scope (&start, &scope);
+  
+  if (java_completion_cache_lookup_resolved (priv->cache, file_path, expression, 
+                                             &start, &scope) != NULL)
+    {
+      g_free (expression);
+      return FALSE;
+    }
+  
+  fetch_page (method, file_path, expression, &start, gtk_text_iter_get_line (&iter), 0);
+  
+  return FALSE;
+}
 
-  return result;
+/*
+ * Asks for a page of the methods in the background, taking ownership of 
+ * the expression. The start of the member name is marked so that the scope 
+ * can be found again once the page comes back.
+ */
+static void
+fetch_page (JavaCompletionMethod *method, 
+            const gchar          *file_path, 
+            gchar                *expression, 
+            GtkTextIter          *start, 
+            gint                  line_number, 
+            gint                  offset)
+{
+  JavaCompletionMethodPrivate *priv;
+  GtkTextBuffer *buffer;
+  Prefetch *prefetch;
+  gchar *input;
+  gchar *low;
+  
+  priv = JAVA_COMPLETION_METHOD_GET_PRIVATE (method);
+  
+  cancel_prefetch (method);
+  
+  buffer = gtk_text_iter_get_buffer (start);
+  
+  priv->prefetch = g_cancellable_new ();
+  priv->prefetch_mark = gtk_text_buffer_create_mark (buffer, NULL, start, TRUE);
+  
+  prefetch = g_malloc (sizeof (Prefetch));
+  prefetch->method = g_object_ref (method);
+  prefetch->cancellable = g_object_ref (priv->prefetch);
+  prefetch->file_path = g_strdup (file_path);
+  prefetch->expression = expression;
+  prefetch->output = NULL;
+  prefetch->offset = offset;
+  
+  input = java_completion_method_get_input (priv->codeslayer, file_path, expression, 
+                                            line_number, offset);
+  low = g_strconcat (input, " -priority low", NULL);
+  
+  java_client_send_with_cancellable (priv->client, low, prefetch->cancellable, 
+                                     (ClientCallbackFunc) prefetch_callback, prefetch);
+  
+  g_free (input);
+  g_free (low);
+}
+
+static void
+prefetch_callback (gchar    *output, 
+                   Prefetch *prefetch)
+{
+  prefetch->output = output;
+  g_idle_add_full (G_PRIORITY_DEFAULT_IDLE, (GSourceFunc) prefetch_idle, 
+                   prefetch, (GDestroyNotify) destroy_prefetch);
+}
+
+/*
+ * Only a prefetch that was not cancelled can still own the mark, so the 
+ * scope is taken from there.
+ */
+static gboolean
+prefetch_idle (Prefetch *prefetch)
+{
+  JavaCompletionMethodPrivate *priv;
+  GtkTextBuffer *buffer;
+  GtkTextIter start;
+  GtkTextIter scope;
+  
+  if (g_cancellable_is_cancelled (prefetch->cancellable))
+    return FALSE;
+  
+  priv = JAVA_COMPLETION_METHOD_GET_PRIVATE (prefetch->method);
+  
+  if (prefetch->output != NULL)
+    {
+      buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (priv->editor));
+      gtk_text_buffer_get_iter_at_mark (buffer, &start, priv->prefetch_mark);
+      java_completion_cache_get_scope (&start, &scope);
+      if (prefetch->offset > 0)
+        java_completion_cache_append (priv->cache, prefetch->file_path, prefetch->expression, 
+                                      &scope, prefetch->offset, prefetch->output);
+      else
+        java_completion_cache_insert_resolved (priv->cache, prefetch->file_path, 
+                                               prefetch->expression, &start, &scope, 
+                                               prefetch->output);
+    }
+  
+  cancel_prefetch (prefetch->method);
+  
+  return FALSE;
+}
+
+static void
+destroy_prefetch (Prefetch *prefetch)
+{
+  g_object_unref (prefetch->method);
+  g_object_unref (prefetch->cancellable);
+  g_free (prefetch->file_path);
+  g_free (prefetch->expression);
+  g_free (prefetch->output);
+  g_free (prefetch);
+}
+
+static void
+cancel_prefetch (JavaCompletionMethod *method)
+{
+  JavaCompletionMethodPrivate *priv;
+  priv = JAVA_COMPLETION_METHOD_GET_PRIVATE (method);
+  
+  if (priv->prefetch == NULL)
+    return;
+  
+  g_cancellable_cancel (priv->prefetch);
+  g_object_unref (priv->prefetch);
+  priv->prefetch = NULL;
+  
+  if (!gtk_text_mark_get_deleted (priv->prefetch_mark))
+    gtk_text_buffer_delete_mark (gtk_text_mark_get_buffer (priv->prefetch_mark), 
+                                 priv->prefetch_mark);
+  priv->prefetch_mark = NULL;
+}
+
+static gint
+compare_ranked (Ranked *ranked1, 
+                Ranked *ranked2)
+{
+  if (ranked1->score != ranked2->score)
+    return ranked1->score > ranked2->score ? -1 : 1;
+  return ranked1->order < ranked2->order ? -1 : 1;
+}
+
+/*
+ * The type the receiver resolved to, if any, which is what the members 
+ * are counted against besides their name alone. The resolver key can carry 
+ * the package and imports of the file after a tab, and this is keyed as 
+ * this and its class, so only the type name is kept. That way the counts 
+ * carry over from one file to the next.
+ */
+static void
+set_shown_type (JavaCompletionMethod *method, 
+                const gchar          *file_path, 
+                const gchar          *expression, 
+                GtkTextIter          *scope)
+{
+  JavaCompletionMethodPrivate *priv;
+  const gchar *type;
+  const gchar *tab;
+  
+  priv = JAVA_COMPLETION_METHOD_GET_PRIVATE (method);
+  
+  g_free (priv->shown_type);
+  priv->shown_type = NULL;
+  
+  type = java_completion_cache_get_resolved_type (priv->cache, file_path, expression, scope);
+  if (type == NULL)
+    return;
+  
+  if (g_str_has_prefix (type, "this\t"))
+    type += strlen ("this\t");
+  
+  tab = strchr (type, '\t');
+  if (tab != NULL)
+    priv->shown_type = g_strndup (type, tab - type);
+  else
+    priv->shown_type = g_strdup (type);
+}
+
+/*
+ * A proposal is taken to be accepted when its text is inserted in one go, 
+ * which is what the completion popup does.
+ */
+static void
+accept_proposal (JavaCompletionMethod *method, 
+                 const gchar          *text, 
+                 gint                  length)
+{
+  JavaCompletionMethodPrivate *priv;
+  const gchar *member;
+  gchar *inserted;
+  
+  priv = JAVA_COMPLETION_METHOD_GET_PRIVATE (method);
+  
+  if (length < 2 || g_hash_table_size (priv->shown) == 0)
+    return;
+  
+  inserted = g_strndup (text, length);
+  member = g_hash_table_lookup (priv->shown, inserted);
+  
+  if (member != NULL)
+    {
+      java_ranking_accept (priv->ranking, JAVA_RANKING_METHOD, member);
+      if (priv->shown_type != NULL)
+        {
+          gchar *typed = g_strconcat (priv->shown_type, "\t", member, NULL);
+          java_ranking_accept (priv->ranking, JAVA_RANKING_METHOD, typed);
+          g_free (typed);
+        }
+      g_hash_table_remove_all (priv->shown);
+    }
+  
+  g_free (inserted);
 }
 
+/*
+ * The proposals keep the server order, unless some of them were accepted 
+ * before, in which case those come first.
+ */
 static GList*
 render_output (JavaCompletionMethod *method, 
                gchar                *output, 
                GtkTextMark          *mark)
 {
+  JavaCompletionMethodPrivate *priv;
   GList *proposals = NULL;
+  GArray *ranked;
+  gboolean scored = FALSE;
   gchar **split;
   gchar **tmp;
+  guint i;
+  
+  priv = JAVA_COMPLETION_METHOD_GET_PRIVATE (method);
+  
+  g_hash_table_remove_all (priv->shown);
   
   if (!codeslayer_utils_has_text (output))
     return NULL;
   
+  ranked = g_array_new (FALSE, FALSE, sizeof (Ranked));
   split = g_strsplit (output, "\n", -1);
 
-  if (split != NULL)
+  for (tmp = split; *tmp != NULL; tmp++)
     {
-      tmp = split;
-      while (*tmp != NULL)
-        {
-          CodeSlayerCompletionProposal *proposal;
-          proposal = render_line (method, *tmp, mark);
-          if (proposal != NULL)
-            proposals = g_list_append (proposals, proposal);
-          tmp++;
-        }
-      g_strfreev (split);
+      Ranked entry;
+      
+      if (g_str_has_prefix (*tmp, "MORE_RESULTS"))
+        continue;
+      
+      entry.proposal = render_line (method, *tmp, mark, &entry.score);
+      if (entry.proposal == NULL)
+        continue;
+      
+      entry.order = ranked->len;
+      if (entry.score > 0)
+        scored = TRUE;
+      
+      g_array_append_val (ranked, entry);
     }
+  
+  g_strfreev (split);
+  
+  if (scored)
+    g_array_sort (ranked, (GCompareFunc) compare_ranked);
+  
+  for (i = ranked->len; i > 0; i--)
+    proposals = g_list_prepend (proposals, g_array_index (ranked, Ranked, i - 1).proposal);
+  
+  g_array_free (ranked, TRUE);
     
-   return proposals;   
+  return proposals;
 }
 
 static CodeSlayerCompletionProposal*
 render_line (JavaCompletionMethod *method, 
              gchar                *line, 
-             GtkTextMark          *mark)
+             GtkTextMark          *mark, 
+             guint                *score)
 {
+  JavaCompletionMethodPrivate *priv;
   gchar **split;
   gchar **tmp;
   
+  priv = JAVA_COMPLETION_METHOD_GET_PRIVATE (method);
+  
+  *score = 0;
+  
   if (!codeslayer_utils_has_text (line))
     return NULL;
   
@@ -265,6 +787,7 @@ render_line (JavaCompletionMethod *method,
       
       gchar *match_label;
       gchar *match_text;
+      gchar *member;
       
       tmp = split;
 
@@ -280,8 +803,22 @@ render_line (JavaCompletionMethod *method,
           
           proposal = codeslayer_completion_proposal_new (match_label, g_strstrip (match_text), mark);
           
+          member = g_strdup_printf ("%s(%s)", method_name, method_parameters);
+          
+          if (java_ranking_has_kind (priv->ranking, JAVA_RANKING_METHOD))
+            {
+              *score = java_ranking_get_count (priv->ranking, JAVA_RANKING_METHOD, member);
+              if (priv->shown_type != NULL)
+                {
+                  gchar *typed = g_strconcat (priv->shown_type, "\t", member, NULL);
+                  *score += 4 * java_ranking_get_count (priv->ranking, JAVA_RANKING_METHOD, typed);
+                  g_free (typed);
+                }
+            }
+          
+          g_hash_table_insert (priv->shown, match_text, member);
+          
           g_free (match_label);
-          g_free (match_text);
 
         }      
 
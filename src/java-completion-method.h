@@ -22,6 +22,8 @@
 #include <gtk/gtk.h>
 #include <codeslayer/codeslayer.h>
 #include "java-client.h"
+#include "java-completion-cache.h"
+#include "java-ranking.h"
 
 G_BEGIN_DECLS
 
@@ -46,9 +48,16 @@ struct _JavaCompletionMethodClass
 
 GType java_completion_method_get_type (void) G_GNUC_CONST;
 
-JavaCompletionMethod*  java_completion_method_new  (CodeSlayer         *codeslayer, 
-                                                    CodeSlayerEditor   *editor, 
-                                                    JavaClient         *client);
+JavaCompletionMethod*  java_completion_method_new        (CodeSlayer          *codeslayer, 
+                                                          CodeSlayerEditor    *editor, 
+                                                          JavaClient          *client, 
+                                                          JavaCompletionCache *cache, 
+                                                          JavaRanking         *ranking);
+gchar*                 java_completion_method_get_input  (CodeSlayer          *codeslayer, 
+                                                          const gchar         *file_path, 
+                                                          const gchar         *expression, 
+                                                          gint                 line_number, 
+                                                          gint                 offset);
 
 G_END_DECLS
 
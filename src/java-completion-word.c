@@ -28,10 +28,6 @@ static void java_completion_word_finalize            (JavaCompletionWord       *
 
 static GList* java_completion_get_proposals          (JavaCompletionWord       *word, 
                                                       GtkTextIter               iter);
-static GList* find_matches                           (gchar                    *text,
-                                                      gchar                    *word);
-static gint compare_match                            (gchar                    *a,
-                                                      gchar                    *b);
 static gboolean has_match                            (GtkTextIter                 start);
 
 #define JAVA_COMPLETION_WORD_GET_PRIVATE(obj) \
@@ -42,6 +38,7 @@ typedef struct _JavaCompletionWordPrivate JavaCompletionWordPrivate;
 struct _JavaCompletionWordPrivate
 {
   CodeSlayerEditor *editor;
+  JavaWords        *words;
 };
 
 G_DEFINE_TYPE_EXTENDED (JavaCompletionWord,
@@ -79,7 +76,8 @@ java_completion_word_finalize (JavaCompletionWord *word)
 }
 
 JavaCompletionWord*
-java_completion_word_new (CodeSlayerEditor *editor)
+java_completion_word_new (CodeSlayerEditor *editor, 
+                          JavaWords        *words)
 {
   JavaCompletionWordPrivate *priv;
   JavaCompletionWord *word;
@@ -87,6 +85,7 @@ java_completion_word_new (CodeSlayerEditor *editor)
   word = JAVA_COMPLETION_WORD (g_object_new (java_completion_word_get_type (), NULL));
   priv = JAVA_COMPLETION_WORD_GET_PRIVATE (word);
   priv->editor = editor;
+  priv->words = words;
 
   return word;
 }
@@ -103,7 +102,6 @@ java_completion_get_proposals (JavaCompletionWord *word,
   GList *tmp = NULL;
   GtkTextIter start;
   gchar *start_word;
-  gchar *text;
   
   priv = JAVA_COMPLETION_WORD_GET_PRIVATE (word);
 
@@ -121,8 +119,7 @@ java_completion_get_proposals (JavaCompletionWord *word,
   buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (priv->editor));
   mark = gtk_text_buffer_create_mark (buffer, NULL, &start, TRUE);
 
-  text = java_utils_get_text_to_search (GTK_TEXT_VIEW (priv->editor), start);
-  list = find_matches (text, start_word);
+  list = java_words_find (priv->words, start, start_word);
   tmp = list;
 
   while (list != NULL)
@@ -133,6 +130,8 @@ java_completion_get_proposals (JavaCompletionWord *word,
       proposals = g_list_prepend (proposals, proposal);
       list = g_list_next (list);
     }
+  
+  proposals = g_list_reverse (proposals);
 
   if (tmp != NULL)
     {
@@ -142,8 +141,6 @@ java_completion_get_proposals (JavaCompletionWord *word,
   
   if (start_word != NULL)
     g_free (start_word);
-    
-  g_free (text);
 
   return proposals;
 }
@@ -175,51 +172,3 @@ has_match (GtkTextIter start)
 
   return result;
 }
-
-static GList*
-find_matches (gchar *text, 
-              gchar *word)
-{
-  GList *results = NULL;
-  GRegex *regex;
-  gchar *concat;
-  GMatchInfo *match_info;
-  GError *error = NULL;
-  
-  concat = g_strconcat ("(\\s", word, "[a-zA-Z0-9_]+)", NULL);
-  
-  regex = g_regex_new (concat, 0, 0, NULL);
-  
-  g_regex_match_full (regex, text, -1, 0, 0, &match_info, &error);
-  
-  while (g_match_info_matches (match_info))
-    {
-      gchar *match_text = NULL;
-      match_text = g_match_info_fetch (match_info, 0);
-      
-      if (g_list_find_custom (results, match_text, (GCompareFunc) compare_match) == NULL)
-        results = g_list_prepend (results, g_strdup (match_text));
-        
-      g_free (match_text);
-      g_match_info_next (match_info, &error);
-    }
-  
-  g_match_info_free (match_info);
-  g_regex_unref (regex);
-  g_free (concat);
-  
-  if (error != NULL)
-    {
-      g_printerr ("search text for completion word error: %s\n", error->message);
-      g_error_free (error);
-    }
-    
-  return results;   
-}
-
-static gint
-compare_match (gchar *a,
-               gchar *b)
-{
-  return g_strcmp0 (a, b);
-}
@@ -21,6 +21,7 @@
 
 #include <gtk/gtk.h>
 #include <codeslayer/codeslayer.h>
+#include "java-words.h"
 
 G_BEGIN_DECLS
 
@@ -45,7 +46,8 @@ struct _JavaCompletionWordClass
 
 GType java_completion_word_get_type (void) G_GNUC_CONST;
 
-JavaCompletionWord*  java_completion_word_new  (CodeSlayerEditor *editor);
+JavaCompletionWord*  java_completion_word_new  (CodeSlayerEditor *editor, 
+                                                JavaWords        *words);
 
 G_END_DECLS
 
@@ -20,12 +20,18 @@
 #include "java-completion-method.h"
 #include "java-completion-class.h"
 #include "java-completion-word.h"
+#include "java-completion-cache.h"
+#include "java-words.h"
+#include "java-signature.h"
+#include "java-ranking.h"
 
 static void java_completion_class_init  (JavaCompletionClass *klass);
 static void java_completion_init        (JavaCompletion      *completion);
 static void java_completion_finalize    (JavaCompletion      *completion);
 static void editor_added_action         (JavaCompletion      *completion,
                                          CodeSlayerEditor    *editor);
+static void indexes_updated_action      (JavaCompletion      *completion);
+static void group_changed_action        (JavaCompletion      *completion);
                                        
 #define JAVA_COMPLETION_GET_PRIVATE(obj) \
   (G_TYPE_INSTANCE_GET_PRIVATE ((obj), JAVA_COMPLETION_TYPE, JavaCompletionPrivate))
@@ -34,9 +40,15 @@ typedef struct _JavaCompletionPrivate JavaCompletionPrivate;
 
 struct _JavaCompletionPrivate
 {
-  CodeSlayer *codeslayer;
-  JavaClient *client;
-  gulong      editor_added_id;
+  CodeSlayer          *codeslayer;
+  JavaIndexer         *indexer;
+  JavaClient          *client;
+  JavaCompletionCache *cache;
+  JavaRanking         *ranking;
+  JavaWords           *words;
+  gulong               editor_added_id;
+  gulong               indexes_updated_id;
+  gulong               group_changed_id;
 };
 
 G_DEFINE_TYPE (JavaCompletion, java_completion, G_TYPE_OBJECT)
@@ -64,11 +76,20 @@ java_completion_finalize (JavaCompletion *completion)
     g_object_unref (priv->client);  
   
   g_signal_handler_disconnect (priv->codeslayer, priv->editor_added_id);
+  g_signal_handler_disconnect (priv->indexer, priv->indexes_updated_id);
+  g_signal_handler_disconnect (priv->indexer, priv->group_changed_id);
+  
+  g_object_unref (priv->ranking);
+  g_object_unref (priv->cache);
+  g_object_unref (priv->words);
   G_OBJECT_CLASS (java_completion_parent_class)->finalize (G_OBJECT (completion));
 }
 
 JavaCompletion*
-java_completion_new (CodeSlayer *codeslayer)
+java_completion_new (CodeSlayer          *codeslayer, 
+                     JavaIndexer         *indexer, 
+                     JavaToolsProperties *tools_properties, 
+                     JavaConfigurations  *configurations)
 {
   JavaCompletionPrivate *priv;
   JavaCompletion *completion;
@@ -76,11 +97,21 @@ java_completion_new (CodeSlayer *codeslayer)
   completion = JAVA_COMPLETION (g_object_new (java_completion_get_type (), NULL));
   priv = JAVA_COMPLETION_GET_PRIVATE (completion);
   priv->codeslayer = codeslayer;
+  priv->indexer = indexer;
   
   priv->client = java_client_new (codeslayer);
+  priv->cache = java_completion_cache_new ();
+  priv->ranking = java_ranking_new (codeslayer);
+  priv->words = java_words_new (tools_properties, configurations);
   
   priv->editor_added_id = g_signal_connect_swapped (G_OBJECT (codeslayer), "editor-added",
                                                     G_CALLBACK (editor_added_action), completion);
+
+  priv->indexes_updated_id = g_signal_connect_swapped (G_OBJECT (indexer), "indexes-updated",
+                                                       G_CALLBACK (indexes_updated_action), completion);
+
+  priv->group_changed_id = g_signal_connect_swapped (G_OBJECT (indexer), "group-changed",
+                                                     G_CALLBACK (group_changed_action), completion);
                      
   return completion;
 }
@@ -93,12 +124,28 @@ editor_added_action (JavaCompletion   *completion,
   JavaCompletionWord *word;
   JavaCompletionMethod *method;
   JavaCompletionKlass *class;
+  GtkTextBuffer *buffer;
+  const gchar *file_path;
   
   priv = JAVA_COMPLETION_GET_PRIVATE (completion);
+  
+  buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (editor));
+  file_path = codeslayer_editor_get_file_path (editor);
 
-  word = java_completion_word_new (editor);
-  method = java_completion_method_new (priv->codeslayer, editor, priv->client);
-  class = java_completion_klass_new (priv->codeslayer, editor, priv->client);
+  java_words_add_buffer (priv->words, buffer);
+  java_ranking_load (priv->ranking);
+  
+  if (file_path != NULL && g_str_has_suffix (file_path, ".java"))
+    {
+      java_client_mirror_buffer (priv->client, buffer, file_path);
+      java_signature_new (priv->codeslayer, editor, priv->client, priv->cache);
+    }
+
+  word = java_completion_word_new (editor, priv->words);
+  method = java_completion_method_new (priv->codeslayer, editor, priv->client, 
+                                       priv->cache, priv->ranking);
+  class = java_completion_klass_new (priv->codeslayer, editor, priv->client, 
+                                     priv->cache, priv->ranking);
   
   codeslayer_editor_add_completion_provider (editor, 
                                              CODESLAYER_COMPLETION_PROVIDER (word));
@@ -109,3 +156,21 @@ editor_added_action (JavaCompletion   *completion,
   codeslayer_editor_add_completion_provider (editor, 
                                              CODESLAYER_COMPLETION_PROVIDER (class));  
 }
+
+static void
+indexes_updated_action (JavaCompletion *completion)
+{
+  JavaCompletionPrivate *priv;
+  priv = JAVA_COMPLETION_GET_PRIVATE (completion);
+  java_completion_cache_next_generation (priv->cache);
+  java_ranking_load (priv->ranking);
+  java_words_refresh_projects (priv->words);
+}
+
+static void
+group_changed_action (JavaCompletion *completion)
+{
+  JavaCompletionPrivate *priv;
+  priv = JAVA_COMPLETION_GET_PRIVATE (completion);
+  java_ranking_load (priv->ranking);
+}
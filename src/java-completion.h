@@ -21,6 +21,9 @@
 
 #include <gtk/gtk.h>
 #include <codeslayer/codeslayer.h>
+#include "java-indexer.h"
+#include "java-tools-properties.h"
+#include "java-configurations.h"
 
 G_BEGIN_DECLS
 
@@ -45,7 +48,10 @@ struct _JavaCompletionClass
 
 GType java_completion_get_type (void) G_GNUC_CONST;
 
-JavaCompletion*  java_completion_new  (CodeSlayer *codeslayer);
+JavaCompletion*  java_completion_new  (CodeSlayer          *codeslayer, 
+                                       JavaIndexer         *indexer, 
+                                       JavaToolsProperties *tools_properties, 
+                                       JavaConfigurations  *configurations);
 
 G_END_DECLS
 
@@ -32,7 +32,10 @@
 #include "java-usage.h"
 #include "java-navigate.h"
 #include "java-search.h"
+#include "java-symbol-search.h"
+#include "java-index-report.h"
 #include "java-import.h"
+#include "java-organize-imports.h"
 #include "java-tools-properties.h"
 
 static void java_engine_class_init                       (JavaEngineClass   *klass);
@@ -53,23 +56,26 @@ typedef struct _JavaEnginePrivate JavaEnginePrivate;
 
 struct _JavaEnginePrivate
 {
-  CodeSlayer         *codeslayer;
-  JavaCompletion     *completion;
-  JavaConfigurations *configurations;
-  JavaBuild          *build;
-  JavaDebugger       *debugger;
-  JavaIndexer        *indexer;
-  JavaUsage          *usage;
-  JavaNavigate       *navigate;
-  JavaSearch         *search;
-  JavaImport         *import;
-  JavaToolsProperties     *tools_properties;
-  GtkWidget          *menu;
-  GtkWidget          *project_properties;
-  GtkWidget          *projects_popup;
-  GtkWidget          *notebook;
-  gulong              properties_opened_id;
-  gulong              properties_saved_id;
+  CodeSlayer          *codeslayer;
+  JavaCompletion      *completion;
+  JavaConfigurations  *configurations;
+  JavaBuild           *build;
+  JavaDebugger        *debugger;
+  JavaIndexer         *indexer;
+  JavaUsage           *usage;
+  JavaNavigate        *navigate;
+  JavaSearch          *search;
+  JavaSymbolSearch    *symbol_search;
+  JavaIndexReport     *index_report;
+  JavaImport          *import;
+  JavaOrganizeImports *organize_imports;
+  JavaToolsProperties *tools_properties;
+  GtkWidget           *menu;
+  GtkWidget           *project_properties;
+  GtkWidget           *projects_popup;
+  GtkWidget           *notebook;
+  gulong               properties_opened_id;
+  gulong               properties_saved_id;
 };
 
 G_DEFINE_TYPE (JavaEngine, java_engine, G_TYPE_OBJECT)
@@ -95,12 +101,15 @@ java_engine_finalize (JavaEngine *engine)
   g_object_unref (priv->build);
   g_object_unref (priv->debugger);
   g_object_unref (priv->configurations);
-  g_object_unref (priv->indexer);
   g_object_unref (priv->completion);
   g_object_unref (priv->usage);
   g_object_unref (priv->navigate);
   g_object_unref (priv->search);
+  g_object_unref (priv->symbol_search);
+  g_object_unref (priv->indexer);
+  g_object_unref (priv->index_report);
   g_object_unref (priv->import);
+  g_object_unref (priv->organize_imports);
   g_object_unref (priv->tools_properties);
   G_OBJECT_CLASS (java_engine_parent_class)->finalize (G_OBJECT(engine));
 }
@@ -133,11 +142,15 @@ java_engine_new (CodeSlayer         *codeslayer,
   priv->build = java_build_new (codeslayer, priv->configurations, menu, projects_popup, notebook);
   priv->debugger = java_debugger_new (codeslayer, priv->configurations, menu, notebook);
   priv->indexer = java_indexer_new (codeslayer, menu, priv->tools_properties, priv->configurations);
-  priv->completion = java_completion_new  (codeslayer);
+  priv->completion = java_completion_new (codeslayer, priv->indexer, 
+                                          priv->tools_properties, priv->configurations);
   priv->usage = java_usage_new (codeslayer, menu, notebook, priv->configurations);
   priv->navigate = java_navigate_new (codeslayer, menu, priv->configurations);
-  priv->search = java_search_new (codeslayer, menu);
-  priv->import = java_import_new (codeslayer, menu);
+  priv->search = java_search_new (codeslayer, menu, priv->indexer, priv->tools_properties);
+  priv->symbol_search = java_symbol_search_new (codeslayer, menu, priv->indexer, priv->tools_properties);
+  priv->index_report = java_index_report_new (codeslayer, menu, priv->tools_properties);
+  priv->import = java_import_new (codeslayer, menu, priv->tools_properties);
+  priv->organize_imports = java_organize_imports_new (codeslayer, menu, priv->tools_properties);
   
   priv->properties_opened_id =  g_signal_connect_swapped (G_OBJECT (codeslayer), "project-properties-opened",
                                                           G_CALLBACK (project_properties_opened_action), engine);
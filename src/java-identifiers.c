@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+#include "java-identifiers.h"
+
+/*
+ * A trie of the identifiers in a buffer, or in a set of files, with a 
+ * count of how many times each one occurs so that removing one occurrence 
+ * keeps the others. The children of a node are kept sorted, so a prefix 
+ * lookup walks down the prefix and then only visits the identifiers that 
+ * start with it. Each identifier is stored once no matter how many times 
+ * it occurs, so the trie doubles as the interned table of the words.
+ */
+
+typedef struct _Node Node;
+
+struct _Node
+{
+  gchar  ch;
+  guint  count;
+  Node  *child;
+  Node  *sibling;
+};
+
+static void java_identifiers_class_init  (JavaIdentifiersClass *klass);
+static void java_identifiers_init        (JavaIdentifiers      *identifiers);
+static void java_identifiers_finalize    (JavaIdentifiers      *identifiers);
+
+static Node* find_child                  (Node                 *node, 
+                                          gchar                 ch, 
+                                          gboolean              create);
+static gboolean remove_word              (Node                 *node, 
+                                          const gchar          *text, 
+                                          gint                  length);
+static void collect_words                (Node                 *node, 
+                                          GString              *word, 
+                                          GList               **results);
+static void free_node                    (Node                 *node);
+
+#define JAVA_IDENTIFIERS_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), JAVA_IDENTIFIERS_TYPE, JavaIdentifiersPrivate))
+
+typedef struct _JavaIdentifiersPrivate JavaIdentifiersPrivate;
+
+struct _JavaIdentifiersPrivate
+{
+  Node *root;
+};
+
+G_DEFINE_TYPE (JavaIdentifiers, java_identifiers, G_TYPE_OBJECT)
+
+static void 
+java_identifiers_class_init (JavaIdentifiersClass *klass)
+{
+  G_OBJECT_CLASS (klass)->finalize = (GObjectFinalizeFunc) java_identifiers_finalize;
+  g_type_class_add_private (klass, sizeof (JavaIdentifiersPrivate));
+}
+
+static void
+java_identifiers_init (JavaIdentifiers *identifiers)
+{
+  JavaIdentifiersPrivate *priv;
+  priv = JAVA_IDENTIFIERS_GET_PRIVATE (identifiers);
+  priv->root = g_slice_new0 (Node);
+}
+
+static void
+java_identifiers_finalize (JavaIdentifiers *identifiers)
+{
+  JavaIdentifiersPrivate *priv;
+  priv = JAVA_IDENTIFIERS_GET_PRIVATE (identifiers);
+  
+  free_node (priv->root);
+
+  G_OBJECT_CLASS (java_identifiers_parent_class)-> finalize (G_OBJECT (identifiers));
+}
+
+JavaIdentifiers*
+java_identifiers_new (void)
+{
+  return JAVA_IDENTIFIERS (g_object_new (java_identifiers_get_type (), NULL));
+}
+
+void
+java_identifiers_add (JavaIdentifiers *identifiers, 
+                      const gchar     *text, 
+                      gint             length)
+{
+  JavaIdentifiersPrivate *priv;
+  Node *node;
+  gint i;
+  
+  priv = JAVA_IDENTIFIERS_GET_PRIVATE (identifiers);
+  
+  node = priv->root;
+  for (i = 0; i < length; i++)
+    node = find_child (node, text[i], TRUE);
+  
+  node->count++;
+}
+
+void
+java_identifiers_remove (JavaIdentifiers *identifiers, 
+                         const gchar     *text, 
+                         gint             length)
+{
+  JavaIdentifiersPrivate *priv;
+  priv = JAVA_IDENTIFIERS_GET_PRIVATE (identifiers);
+  remove_word (priv->root, text, length);
+}
+
+/*
+ * Returns how many times the identifier occurs.
+ */
+guint
+java_identifiers_get_count (JavaIdentifiers *identifiers, 
+                            const gchar     *text)
+{
+  JavaIdentifiersPrivate *priv;
+  Node *node;
+  const gchar *ch;
+  
+  priv = JAVA_IDENTIFIERS_GET_PRIVATE (identifiers);
+  
+  node = priv->root;
+  for (ch = text; *ch != '\0' && node != NULL; ch++)
+    node = find_child (node, *ch, FALSE);
+  
+  return node != NULL ? node->count : 0;
+}
+
+/*
+ * Returns the identifiers that start with the prefix, not counting the 
+ * prefix itself, in sorted order. Free with g_list_free_full (list, g_free).
+ */
+GList*
+java_identifiers_find (JavaIdentifiers *identifiers, 
+                       const gchar     *prefix)
+{
+  JavaIdentifiersPrivate *priv;
+  GList *results = NULL;
+  GString *word;
+  Node *node;
+  const gchar *ch;
+  
+  priv = JAVA_IDENTIFIERS_GET_PRIVATE (identifiers);
+  
+  node = priv->root;
+  for (ch = prefix; *ch != '\0' && node != NULL; ch++)
+    node = find_child (node, *ch, FALSE);
+  
+  if (node == NULL)
+    return NULL;
+  
+  word = g_string_new (prefix);
+  
+  for (node = node->child; node != NULL; node = node->sibling)
+    collect_words (node, word, &results);
+  
+  g_string_free (word, TRUE);
+  
+  return g_list_reverse (results);
+}
+
+static Node*
+find_child (Node     *node, 
+            gchar     ch, 
+            gboolean  create)
+{
+  Node **link;
+  Node *child;
+  
+  for (link = &node->child; *link != NULL && (*link)->ch < ch; link = &(*link)->sibling);
+  
+  if (*link != NULL && (*link)->ch == ch)
+    return *link;
+  
+  if (!create)
+    return NULL;
+  
+  child = g_slice_new0 (Node);
+  child->ch = ch;
+  child->sibling = *link;
+  *link = child;
+  
+  return child;
+}
+
+/*
+ * Takes one occurrence of the word out, and returns whether the node is 
+ * now unused so that the parent can prune it.
+ */
+static gboolean
+remove_word (Node        *node, 
+             const gchar *text, 
+             gint         length)
+{
+  if (length == 0)
+    {
+      if (node->count > 0)
+        node->count--;
+    }
+  else
+    {
+      Node **link;
+      
+      for (link = &node->child; *link != NULL && (*link)->ch != *text; link = &(*link)->sibling);
+      
+      if (*link != NULL && remove_word (*link, text + 1, length - 1))
+        {
+          Node *child = *link;
+          *link = child->sibling;
+          g_slice_free (Node, child);
+        }
+    }
+  
+  return node->count == 0 && node->child == NULL;
+}
+
+static void
+collect_words (Node     *node, 
+               GString  *word, 
+               GList   **results)
+{
+  Node *child;
+  
+  g_string_append_c (word, node->ch);
+  
+  if (node->count > 0)
+    *results = g_list_prepend (*results, g_strdup (word->str));
+  
+  for (child = node->child; child != NULL; child = child->sibling)
+    collect_words (child, word, results);
+  
+  g_string_truncate (word, word->len - 1);
+}
+
+static void
+free_node (Node *node)
+{
+  while (node != NULL)
+    {
+      Node *sibling = node->sibling;
+      free_node (node->child);
+      g_slice_free (Node, node);
+      node = sibling;
+    }
+}
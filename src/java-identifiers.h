@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __JAVA_IDENTIFIERS_H__
+#define	__JAVA_IDENTIFIERS_H__
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+#define JAVA_IDENTIFIERS_TYPE            (java_identifiers_get_type ())
+#define JAVA_IDENTIFIERS(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), JAVA_IDENTIFIERS_TYPE, JavaIdentifiers))
+#define JAVA_IDENTIFIERS_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), JAVA_IDENTIFIERS_TYPE, JavaIdentifiersClass))
+#define IS_JAVA_IDENTIFIERS(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), JAVA_IDENTIFIERS_TYPE))
+#define IS_JAVA_IDENTIFIERS_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), JAVA_IDENTIFIERS_TYPE))
+
+typedef struct _JavaIdentifiers JavaIdentifiers;
+typedef struct _JavaIdentifiersClass JavaIdentifiersClass;
+
+struct _JavaIdentifiers
+{
+  GObject parent_instance;
+};
+
+struct _JavaIdentifiersClass
+{
+  GObjectClass parent_class;
+};
+
+GType java_identifiers_get_type (void) G_GNUC_CONST;
+
+JavaIdentifiers*  java_identifiers_new        (void);
+
+void              java_identifiers_add        (JavaIdentifiers *identifiers, 
+                                               const gchar     *text, 
+                                               gint             length);
+void              java_identifiers_remove     (JavaIdentifiers *identifiers, 
+                                               const gchar     *text, 
+                                               gint             length);
+guint             java_identifiers_get_count  (JavaIdentifiers *identifiers, 
+                                               const gchar     *text);
+GList*            java_identifiers_find       (JavaIdentifiers *identifiers, 
+                                               const gchar     *prefix);
+
+G_END_DECLS
+
+#endif /* __JAVA_IDENTIFIERS_H__ */
@@ -23,6 +23,9 @@
 #include "java-import.h"
 #include "java-utils.h"
 #include "java-client.h"
+#include "java-lexer.h"
+#include "java-tools-properties.h"
+#include "java-results-model.h"
 
 static void java_import_class_init  (JavaImportClass   *klass);
 static void java_import_init        (JavaImport        *import);
@@ -34,14 +37,16 @@ static gchar* get_input             (JavaImport        *import,
                                      const gchar       *text);
 static void render_output           (JavaImport        *import, 
                                      gchar             *output);
-static void render_line             (JavaImport        *import, 
-                                     gchar             *line);
+static void render_line             (gchar             *line, 
+                                     JavaSuppressions  *suppressions, 
+                                     GArray            *rows);
 static void row_activated_action    (JavaImport        *import,
                                      GtkTreePath       *path,
                                      GtkTreeViewColumn *column);
 static void insert_import           (JavaImport        *import, 
                                      const gchar       *text);
-static gchar* get_package_name      (GtkTextBuffer     *buffer);
+static gboolean get_package_end     (GtkTextBuffer     *buffer, 
+                                     GtkTextIter       *iter);
 
 #define JAVA_IMPORT_GET_PRIVATE(obj) \
   (G_TYPE_INSTANCE_GET_PRIVATE ((obj), JAVA_IMPORT_TYPE, JavaImportPrivate))
@@ -50,17 +55,11 @@ typedef struct _JavaImportPrivate JavaImportPrivate;
 
 struct _JavaImportPrivate
 {
-  CodeSlayer   *codeslayer;
-  JavaClient   *client;
-  GtkWidget    *dialog;
-  GtkWidget    *tree;
-  GtkListStore *store;
-};
-
-enum
-{
-  CLASS_NAME = 0,
-  COLUMNS
+  CodeSlayer          *codeslayer;
+  JavaToolsProperties *tools_properties;
+  JavaClient          *client;
+  GtkWidget           *dialog;
+  GtkWidget           *tree;
 };
 
 G_DEFINE_TYPE (JavaImport, java_import, G_TYPE_OBJECT)
@@ -96,8 +95,9 @@ java_import_finalize (JavaImport *import)
 }
 
 JavaImport*
-java_import_new (CodeSlayer *codeslayer,
-                 GtkWidget  *menu)
+java_import_new (CodeSlayer          *codeslayer,
+                 GtkWidget           *menu, 
+                 JavaToolsProperties *tools_properties)
 {
   JavaImportPrivate *priv;
   JavaImport *import;
@@ -105,6 +105,7 @@ java_import_new (CodeSlayer *codeslayer,
   import = JAVA_IMPORT (g_object_new (java_import_get_type (), NULL));
   priv = JAVA_IMPORT_GET_PRIVATE (import);
   priv->codeslayer = codeslayer;
+  priv->tools_properties = tools_properties;
   
   priv->client = java_client_new (codeslayer);
 
@@ -144,7 +145,7 @@ import_action (JavaImport *import)
     return;  
     
   run_dialog (import);
-  gtk_list_store_clear (priv->store);      
+  gtk_tree_view_set_model (GTK_TREE_VIEW (priv->tree), NULL);
     
   text = gtk_text_buffer_get_text (buffer, &start, &end, FALSE);
   
@@ -158,7 +159,6 @@ import_action (JavaImport *import)
     {
       g_print ("output: %s\n", output);
       render_output (import, output);
-      g_free (output);
     }
 
   gtk_dialog_run (GTK_DIALOG (priv->dialog));
@@ -197,19 +197,18 @@ run_dialog (JavaImport *import)
       
       /* the tree view */   
          
-      priv->store = gtk_list_store_new (COLUMNS, G_TYPE_STRING);
       priv->tree =  gtk_tree_view_new ();
       gtk_tree_view_set_headers_visible (GTK_TREE_VIEW (priv->tree), FALSE);
       gtk_tree_view_set_enable_search (GTK_TREE_VIEW (priv->tree), FALSE);
       
-      gtk_tree_view_set_model (GTK_TREE_VIEW (priv->tree), GTK_TREE_MODEL (priv->store));
-      g_object_unref (priv->store);
+      gtk_tree_view_set_fixed_height_mode (GTK_TREE_VIEW (priv->tree), TRUE);
       
       column = gtk_tree_view_column_new ();
-      gtk_tree_view_column_set_sizing (column, GTK_TREE_VIEW_COLUMN_AUTOSIZE);
+      gtk_tree_view_column_set_sizing (column, GTK_TREE_VIEW_COLUMN_FIXED);
+      gtk_tree_view_column_set_expand (column, TRUE);
       renderer = gtk_cell_renderer_text_new ();
       gtk_tree_view_column_pack_start (column, renderer, FALSE);
-      gtk_tree_view_column_add_attribute (column, renderer, "text", CLASS_NAME);
+      gtk_tree_view_column_add_attribute (column, renderer, "text", JAVA_RESULTS_CLASS_NAME);
       gtk_tree_view_append_column (GTK_TREE_VIEW (priv->tree), column);
       
       scrolled_window = gtk_scrolled_window_new (NULL, NULL);
@@ -257,67 +256,69 @@ get_input (JavaImport  *import,
   return result;
 }
 
+/*
+ * Takes the output, which is cut up in place and handed to the model, 
+ * since the rows point into it.
+ */
 static void
 render_output (JavaImport *import, 
                gchar      *output)
 {
-  gchar **split;
-  gchar **tmp;
+  JavaImportPrivate *priv;
+  JavaSuppressions *suppressions;
+  JavaResultsModel *model;
+  GArray *rows;
+  gchar *line;
+  gchar *next;
   
-  if (!codeslayer_utils_has_text (output))
-    return;
+  priv = JAVA_IMPORT_GET_PRIVATE (import);
   
-  split = g_strsplit (output, "\n", -1);
-
-  if (split != NULL)
+  rows = g_array_new (FALSE, FALSE, sizeof (JavaMatch));
+  
+  if (codeslayer_utils_has_text (output) && 
+      !g_str_has_prefix (output, "NO_RESULTS_FOUND"))
     {
-      tmp = split;
-      while (*tmp != NULL)
+      suppressions = java_tools_properties_get_suppressions (priv->tools_properties);
+      
+      for (line = output; line != NULL; line = next)
         {
-          render_line (import, *tmp);
-          tmp++;
+          next = strchr (line, '\n');
+          if (next != NULL)
+            *next++ = '\0';
+          render_line (line, suppressions, rows);
         }
-      g_strfreev (split);
     }
+  
+  model = java_results_model_new (rows, output, g_free);
+  gtk_tree_view_set_model (GTK_TREE_VIEW (priv->tree), GTK_TREE_MODEL (model));
+  g_object_unref (model);
 }
 
 static void
-render_line (JavaImport *import, 
-             gchar      *line)
+render_line (gchar            *line, 
+             JavaSuppressions *suppressions, 
+             GArray           *rows)
 {
-  JavaImportPrivate *priv;
-  GtkTreeIter iter;
-  gchar **split;
-  gchar **tmp;
-  
-  priv = JAVA_IMPORT_GET_PRIVATE (import);
+  JavaMatch match;
+  gchar *tab;
   
   if (!codeslayer_utils_has_text (line))
     return;
   
-  split = g_strsplit (line, "\t", -1);
+  tab = strchr (line, '\t');
+  if (tab != NULL)
+    *tab = '\0';
   
-  if (g_strcmp0 (*split, "NO_RESULTS_FOUND") == 0)
+  if (java_suppressions_match (suppressions, line))
     return;
   
-  if (split != NULL)
-    {
-      gchar *class_name;  
-      
-      tmp = split;
-
-      class_name = *tmp;
-      
-      if (class_name != NULL)
-        {
-          gtk_list_store_append (priv->store, &iter);
-          gtk_list_store_set (priv->store, &iter, 
-                              CLASS_NAME, class_name, 
-                              -1);
-        }
-
-      g_strfreev (split);
-    }
+  match.class_name = line;
+  match.simple_class_name = strrchr (line, '.') != NULL ? strrchr (line, '.') + 1 : line;
+  match.file_path = NULL;
+  match.detail = NULL;
+  match.line_number = 0;
+  
+  g_array_append_val (rows, match);
 }
 
 static void
@@ -346,7 +347,7 @@ row_activated_action (JavaImport        *import,
       GtkTreePath *tree_path = tmp->data;
       
       gtk_tree_model_get_iter (tree_model, &treeiter, tree_path);
-      gtk_tree_model_get (GTK_TREE_MODEL (priv->store), &treeiter, CLASS_NAME, &class_name, -1);
+      gtk_tree_model_get (tree_model, &treeiter, JAVA_RESULTS_CLASS_NAME, &class_name, -1);
       
       insert_import (import, class_name);
       
@@ -368,66 +369,76 @@ insert_import (JavaImport  *import,
   CodeSlayerEditor *editor;
   GtkTextBuffer *buffer;
   GtkTextIter iter;
-  GtkTextIter match_start;
-  GtkTextIter match_end;
-  gchar *package_name;
+  gchar *concat;
 
   priv = JAVA_IMPORT_GET_PRIVATE (import);
 
   editor = codeslayer_get_active_editor (priv->codeslayer);  
   buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (editor));
   
-  gtk_text_buffer_get_start_iter (buffer, &iter);
-  package_name = get_package_name (buffer);
+  if (get_package_end (buffer, &iter))
+    concat = g_strconcat ("\n", "import ", class_name, ";", NULL);
+  else
+    concat = g_strconcat ("import ", class_name, ";", "\n", NULL);
 
-  if (gtk_text_iter_forward_search (&iter, package_name,
-                                    GTK_TEXT_SEARCH_TEXT_ONLY,
-                                    &match_start, &match_end, NULL))
-    {
-      gchar *concat;
-      concat = g_strconcat ("\n", "import ", class_name, ";", NULL);
-      gtk_text_buffer_begin_user_action (buffer);
-      gtk_text_buffer_insert (buffer, &match_end, concat, -1);
-      gtk_text_buffer_end_user_action (buffer);
-      g_free (concat);
-    }
-  
-  if (package_name != NULL)
-    g_free (package_name);
+  gtk_text_buffer_begin_user_action (buffer);
+  gtk_text_buffer_insert (buffer, &iter, concat, -1);
+  gtk_text_buffer_end_user_action (buffer);
+  g_free (concat);
 }
 
-static gchar*
-get_package_name (GtkTextBuffer *buffer)
+/*
+ * The package statement has to come before anything else in the file, so 
+ * only the tokens up to its semicolon are looked at. The iter is set to 
+ * right after the semicolon, or to the start of the buffer when the file 
+ * is in the default package.
+ */
+static gboolean
+get_package_end (GtkTextBuffer *buffer, 
+                 GtkTextIter   *iter)
 {
-  gchar* result = NULL;
-  GRegex *regex;
-  GMatchInfo *match_info;
-  GError *error = NULL;
-  GtkTextIter start;
-  GtkTextIter end;
-  gchar   *text;
+  JavaLexer *lexer;
+  gboolean in_package = FALSE;
+  gint line_count;
+  gint line;
   
-  gtk_text_buffer_get_bounds (buffer, &start, &end);
+  gtk_text_buffer_get_start_iter (buffer, iter);
   
-  text = gtk_text_buffer_get_text (buffer, &start, &end, TRUE);
+  lexer = java_lexer_get (buffer);
+  line_count = java_lexer_get_line_count (lexer);
   
-  regex = g_regex_new ("package\\s(.*?);", 0, 0, NULL);
-  
-  g_regex_match_full (regex, text, -1, 0, 0, &match_info, &error);
-  
-  if (result == NULL && g_match_info_matches (match_info))
-    result = g_match_info_fetch (match_info, 0);
-  
-  g_match_info_free (match_info);
-  g_regex_unref (regex);
-  
-  if (error != NULL)
+  for (line = 0; line < line_count; line++)
     {
-      g_printerr ("search text for package error: %s\n", error->message);
-      g_error_free (error);
+      GArray *tokens;
+      guint i;
+      
+      tokens = java_lexer_get_tokens (lexer, line);
+      if (tokens == NULL)
+        break;
+      
+      for (i = 0; i < tokens->len; i++)
+        {
+          JavaToken *token = &g_array_index (tokens, JavaToken, i);
+          
+          if (token->type == JAVA_TOKEN_COMMENT)
+            continue;
+          
+          if (!in_package)
+            {
+              if (!java_lexer_token_equals (lexer, line, token, "package"))
+                return FALSE;
+              in_package = TRUE;
+              continue;
+            }
+          
+          if (java_lexer_token_equals (lexer, line, token, ";"))
+            {
+              gtk_text_buffer_get_iter_at_line_index (buffer, iter, line, 
+                                                      token->index + token->length);
+              return TRUE;
+            }
+        }
     }
     
-  g_free (text);
-    
-  return result;   
+  return FALSE;
 }
@@ -21,6 +21,7 @@
 
 #include <gtk/gtk.h>
 #include <codeslayer/codeslayer.h>
+#include "java-tools-properties.h"
 
 G_BEGIN_DECLS
 
@@ -45,8 +46,9 @@ struct _JavaImportClass
 
 GType java_import_get_type (void) G_GNUC_CONST;
      
-JavaImport*  java_import_new  (CodeSlayer *codeslayer,                                          
-                               GtkWidget  *menu);
+JavaImport*  java_import_new  (CodeSlayer          *codeslayer,
+                               GtkWidget           *menu, 
+                               JavaToolsProperties *tools_properties);
                                      
 G_END_DECLS
 
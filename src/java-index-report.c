@@ -0,0 +1,354 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <stdlib.h>
+#include <codeslayer/codeslayer-utils.h>
+#include "java-index-report.h"
+#include "java-utils.h"
+#include "java-client.h"
+#include "java-tools-properties.h"
+
+typedef struct
+{
+  JavaIndexReport *index_report;
+  gchar           *text;
+} Output;
+
+static void java_index_report_class_init  (JavaIndexReportClass *klass);
+static void java_index_report_init        (JavaIndexReport      *index_report);
+static void java_index_report_finalize    (JavaIndexReport      *index_report);
+
+static void index_report_action           (JavaIndexReport      *index_report);
+static void run_dialog                    (JavaIndexReport      *index_report);
+static gchar* get_input                   (JavaIndexReport      *index_report);
+static void add_idle                      (gchar                *text, 
+                                           JavaIndexReport      *index_report);
+static gboolean render_output             (Output               *output);
+static void destroy_output                (Output               *output);
+static void render_line                   (gchar                *line, 
+                                           GString              *shards, 
+                                           GString              *slowest, 
+                                           GString              *duplicates);
+static gchar* format_size                 (const gchar          *bytes);
+static gchar* get_suppressed              (JavaIndexReport      *index_report);
+
+#define JAVA_INDEX_REPORT_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), JAVA_INDEX_REPORT_TYPE, JavaIndexReportPrivate))
+
+typedef struct _JavaIndexReportPrivate JavaIndexReportPrivate;
+
+struct _JavaIndexReportPrivate
+{
+  CodeSlayer          *codeslayer;
+  JavaToolsProperties *tools_properties;
+  JavaClient          *client;
+  GtkWidget           *dialog;
+  GtkTextBuffer       *buffer;
+  gint                 process_id;
+};
+
+G_DEFINE_TYPE (JavaIndexReport, java_index_report, G_TYPE_OBJECT)
+
+static void 
+java_index_report_class_init (JavaIndexReportClass *klass)
+{
+  G_OBJECT_CLASS (klass)->finalize = (GObjectFinalizeFunc) java_index_report_finalize;
+  g_type_class_add_private (klass, sizeof (JavaIndexReportPrivate));
+}
+
+static void
+java_index_report_init (JavaIndexReport *index_report)
+{
+  JavaIndexReportPrivate *priv;
+  priv = JAVA_INDEX_REPORT_GET_PRIVATE (index_report);
+  priv->dialog = NULL;
+}
+
+static void
+java_index_report_finalize (JavaIndexReport *index_report)
+{
+  JavaIndexReportPrivate *priv;
+  priv = JAVA_INDEX_REPORT_GET_PRIVATE (index_report);
+  
+  if (priv->dialog != NULL)
+    gtk_widget_destroy (priv->dialog);
+    
+  if (priv->client)
+    g_object_unref (priv->client);
+
+  G_OBJECT_CLASS (java_index_report_parent_class)-> finalize (G_OBJECT (index_report));
+}
+
+JavaIndexReport*
+java_index_report_new (CodeSlayer          *codeslayer,
+                       GtkWidget           *menu, 
+                       JavaToolsProperties *tools_properties)
+{
+  JavaIndexReportPrivate *priv;
+  JavaIndexReport *index_report;
+
+  index_report = JAVA_INDEX_REPORT (g_object_new (java_index_report_get_type (), NULL));
+  priv = JAVA_INDEX_REPORT_GET_PRIVATE (index_report);
+  priv->codeslayer = codeslayer;
+  priv->tools_properties = tools_properties;
+  
+  priv->client = java_client_new (codeslayer);
+
+  g_signal_connect_swapped (G_OBJECT (menu), "index-report",
+                            G_CALLBACK (index_report_action), index_report);
+
+  return index_report;
+}
+
+static void
+index_report_action (JavaIndexReport *index_report)
+{
+  JavaIndexReportPrivate *priv;
+  gchar *input;
+  
+  priv = JAVA_INDEX_REPORT_GET_PRIVATE (index_report);
+  
+  priv->process_id = codeslayer_add_to_processes (priv->codeslayer, "Index Report", NULL, NULL);
+  
+  input = get_input (index_report);
+  
+  java_client_send_with_callback (priv->client, input, (ClientCallbackFunc) add_idle, index_report);
+  
+  g_free (input);
+}
+
+static gchar* 
+get_input (JavaIndexReport *index_report)
+{
+  JavaIndexReportPrivate *priv;
+  gchar *indexes_folder;
+  gchar *result;
+  
+  priv = JAVA_INDEX_REPORT_GET_PRIVATE (index_report);
+  
+  indexes_folder = java_utils_get_indexes_folder (priv->codeslayer);
+  
+  result = g_strconcat ("-program indexreport", 
+                        indexes_folder, 
+                        NULL);
+  
+  g_free (indexes_folder);
+
+  return result;
+}
+
+static void
+add_idle (gchar           *text, 
+          JavaIndexReport *index_report)
+{
+  Output *output;
+  output = g_malloc (sizeof (Output));
+  output->index_report = index_report;
+  output->text = text;    
+  g_idle_add_full (G_PRIORITY_DEFAULT_IDLE, (GSourceFunc) render_output, output, (GDestroyNotify)destroy_output);
+}
+
+static void 
+destroy_output (Output *output)
+{
+  g_free (output->text);
+  g_free (output);
+}
+
+/*
+ * The report comes back from the server as tab separated records:
+ *
+ * SHARD      name  classes  methods  files  bytes  memory bytes
+ * SLOW       file path  milliseconds
+ * DUPLICATE  class name  comma separated libs
+ */
+static gboolean
+render_output (Output *output)
+{
+  JavaIndexReportPrivate *priv;
+  GString *shards;
+  GString *slowest;
+  GString *duplicates;
+  gchar *suppressed;
+  gchar *text;
+  
+  priv = JAVA_INDEX_REPORT_GET_PRIVATE (output->index_report);
+  
+  codeslayer_remove_from_processes (priv->codeslayer, priv->process_id);
+  
+  if (!codeslayer_utils_has_text (output->text))
+    return FALSE;
+  
+  shards = g_string_new ("");
+  g_string_append_printf (shards, "%-20s %10s %10s %10s %10s %10s\n", 
+                          "Shard", "Classes", "Methods", "Files", "Size", "Memory");
+
+  slowest = g_string_new ("\nSlowest Files\n\n");
+  duplicates = g_string_new ("\nDuplicate Classes\n\n");
+  
+  if (output->text != NULL)
+    {
+      gchar **split;
+      gchar **tmp;
+      
+      split = g_strsplit (output->text, "\n", -1);
+      for (tmp = split; *tmp != NULL; tmp++)
+        render_line (*tmp, shards, slowest, duplicates);
+      g_strfreev (split);
+    }
+  
+  suppressed = get_suppressed (output->index_report);
+  
+  text = g_strconcat (shards->str, slowest->str, duplicates->str, suppressed, NULL);
+  
+  run_dialog (output->index_report);
+  gtk_text_buffer_set_text (priv->buffer, text, -1);
+  gtk_dialog_run (GTK_DIALOG (priv->dialog));
+  gtk_widget_hide (priv->dialog);
+  
+  g_string_free (shards, TRUE);
+  g_string_free (slowest, TRUE);
+  g_string_free (duplicates, TRUE);
+  g_free (suppressed);
+  g_free (text);
+  
+  return FALSE;
+}
+
+static void
+render_line (gchar   *line, 
+             GString *shards, 
+             GString *slowest, 
+             GString *duplicates)
+{
+  gchar **split;
+  guint length;
+  
+  if (!codeslayer_utils_has_text (line))
+    return;
+  
+  split = g_strsplit (line, "\t", -1);
+  length = g_strv_length (split);
+  
+  if (g_strcmp0 (split[0], "SHARD") == 0 && length >= 7)
+    {
+      gchar *size;
+      gchar *memory;
+      size = format_size (split[5]);
+      memory = format_size (split[6]);
+      g_string_append_printf (shards, "%-20s %10s %10s %10s %10s %10s\n", 
+                              split[1], split[2], split[3], split[4], size, memory);
+      g_free (size);
+      g_free (memory);
+    }
+  else if (g_strcmp0 (split[0], "SLOW") == 0 && length >= 3)
+    {
+      g_string_append_printf (slowest, "%8s ms  %s\n", split[2], split[1]);
+    }
+  else if (g_strcmp0 (split[0], "DUPLICATE") == 0 && length >= 3)
+    {
+      g_string_append_printf (duplicates, "%s\n    %s\n", split[1], split[2]);
+    }
+  
+  g_strfreev (split);
+}
+
+static gchar*
+format_size (const gchar *bytes)
+{
+  return g_format_size (g_ascii_strtoull (bytes, NULL, 10));
+}
+
+/*
+ * What the suppressions have filtered out of search and import results 
+ * since they were last loaded.
+ */
+static gchar*
+get_suppressed (JavaIndexReport *index_report)
+{
+  JavaIndexReportPrivate *priv;
+  JavaSuppressions *suppressions;
+  GString *string;
+  GList *counts;
+  GList *list;
+  
+  priv = JAVA_INDEX_REPORT_GET_PRIVATE (index_report);
+  
+  suppressions = java_tools_properties_get_suppressions (priv->tools_properties);
+  counts = java_suppressions_get_counts (suppressions);
+  
+  string = g_string_new ("");
+  g_string_append_printf (string, "\nSuppressed Classes (%u)\n\n", 
+                          java_suppressions_get_count (suppressions));
+  
+  for (list = counts; list != NULL; list = list->next)
+    {
+      gchar **split;
+      split = g_strsplit (list->data, "\t", 2);
+      if (g_strv_length (split) == 2)
+        g_string_append_printf (string, "%8s  %s\n", split[1], split[0]);
+      g_strfreev (split);
+    }
+  
+  g_list_free_full (counts, g_free);
+  
+  return g_string_free (string, FALSE);
+}
+
+static void
+run_dialog (JavaIndexReport *index_report)
+{
+  JavaIndexReportPrivate *priv;
+  priv = JAVA_INDEX_REPORT_GET_PRIVATE (index_report);
+  
+  if (priv->dialog == NULL)
+    {
+      GtkWidget *content_area;
+      GtkWidget *text_view;
+      GtkWidget *scrolled_window;
+      PangoFontDescription *font_description;
+
+      priv->dialog = gtk_dialog_new_with_buttons ("Index Report", 
+                                                  codeslayer_get_toplevel_window (priv->codeslayer),
+                                                  GTK_DIALOG_MODAL,
+                                                  GTK_STOCK_CLOSE, GTK_RESPONSE_OK,
+                                                  NULL);
+      gtk_window_set_skip_taskbar_hint (GTK_WINDOW (priv->dialog), TRUE);
+      gtk_window_set_skip_pager_hint (GTK_WINDOW (priv->dialog), TRUE);
+
+      content_area = gtk_dialog_get_content_area (GTK_DIALOG (priv->dialog));
+      
+      text_view = gtk_text_view_new ();
+      gtk_text_view_set_editable (GTK_TEXT_VIEW (text_view), FALSE);
+      font_description = pango_font_description_from_string ("Monospace");
+      gtk_widget_override_font (text_view, font_description);
+      pango_font_description_free (font_description);
+      priv->buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (text_view));
+      
+      scrolled_window = gtk_scrolled_window_new (NULL, NULL);
+      gtk_scrolled_window_set_policy (GTK_SCROLLED_WINDOW (scrolled_window),
+                                      GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+      gtk_container_add (GTK_CONTAINER (scrolled_window), text_view);
+      
+      gtk_widget_set_size_request (content_area, 700, 500);
+      
+      gtk_box_pack_start (GTK_BOX (content_area), scrolled_window, TRUE, TRUE, 0);
+
+      gtk_widget_show_all (content_area);
+    }
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __JAVA_INDEX_REPORT_H__
+#define	__JAVA_INDEX_REPORT_H__
+
+#include <gtk/gtk.h>
+#include <codeslayer/codeslayer.h>
+#include "java-tools-properties.h"
+
+G_BEGIN_DECLS
+
+#define JAVA_INDEX_REPORT_TYPE            (java_index_report_get_type ())
+#define JAVA_INDEX_REPORT(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), JAVA_INDEX_REPORT_TYPE, JavaIndexReport))
+#define JAVA_INDEX_REPORT_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), JAVA_INDEX_REPORT_TYPE, JavaIndexReportClass))
+#define IS_JAVA_INDEX_REPORT(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), JAVA_INDEX_REPORT_TYPE))
+#define IS_JAVA_INDEX_REPORT_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), JAVA_INDEX_REPORT_TYPE))
+
+typedef struct _JavaIndexReport JavaIndexReport;
+typedef struct _JavaIndexReportClass JavaIndexReportClass;
+
+struct _JavaIndexReport
+{
+  GObject parent_instance;
+};
+
+struct _JavaIndexReportClass
+{
+  GObjectClass parent_class;
+};
+
+GType java_index_report_get_type (void) G_GNUC_CONST;
+     
+JavaIndexReport*  java_index_report_new  (CodeSlayer          *codeslayer,
+                                          GtkWidget           *menu, 
+                                          JavaToolsProperties *tools_properties);
+
+G_END_DECLS
+
+#endif /* __JAVA_INDEX_REPORT_H__ */
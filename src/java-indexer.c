@@ -17,6 +17,9 @@
  */
 
 #include <codeslayer/codeslayer-utils.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib/gstdio.h>
 #include "java-indexer.h"
 #include "java-utils.h"
 #include "java-configuration.h"
@@ -24,10 +27,27 @@
 
 typedef struct
 {
-  CodeSlayer *codeslayer;
-  gint        process_id;
+  JavaIndexer  *indexer;
+  CodeSlayer   *codeslayer;
+  gint          process_id;
+  gchar        *name;
+  gchar        *phase;
+  GTimer       *timer;
+  GTimer       *phase_timer;
+  GString      *summary;
+  gint64        last_update;
+  GCancellable *cancellable;
+  GHashTable   *manifest;
+  gchar        *manifest_path;
+  gboolean      updated;
 } Process;
 
+typedef struct
+{
+  Process *process;
+  gchar   *text;
+} Progress;
+
 static void java_indexer_class_init    (JavaIndexerClass *klass);
 static void java_indexer_init          (JavaIndexer      *indexer);
 static void java_indexer_finalize      (JavaIndexer      *indexer);
@@ -39,11 +59,46 @@ static void create_libs_indexes        (JavaIndexer      *indexer);
 static void verify_dir_exists          (CodeSlayer       *codeslayer);
 static void index_projects_action      (JavaIndexer      *indexer);
 static void index_libs_action          (JavaIndexer      *indexer);
+static void check_group                (JavaIndexer      *indexer);
+static void refresh_projects_indexes   (JavaIndexer      *indexer);
+static void send_projects_indexes      (JavaIndexer      *indexer, 
+                                        const gchar      *name, 
+                                        GHashTable       *manifest, 
+                                        const gchar      *delta_path);
+static GHashTable* scan_source_files   (JavaIndexer      *indexer);
+static void scan_folder                (GHashTable       *manifest, 
+                                        GHashTable       *visited, 
+                                        const gchar      *folder_path);
+static GHashTable* load_manifest       (const gchar      *manifest_path);
+static void save_manifest              (GHashTable       *manifest, 
+                                        const gchar      *manifest_path);
+static gchar* get_manifest_path        (CodeSlayer       *codeslayer, 
+                                        const gchar      *file_name);
+static gchar* write_delta              (JavaIndexer      *indexer, 
+                                        GHashTable       *old_manifest, 
+                                        GHashTable       *new_manifest);
+static gchar* get_resource_limits      (JavaIndexer      *indexer);
+static Process* create_process         (JavaIndexer      *indexer, 
+                                        const gchar      *name);
+static void cancel_process             (Process          *process);
+static void add_progress_idle          (gchar            *line, 
+                                        Process          *process);
+static gchar* get_progress_text        (Process          *process, 
+                                        gchar            *line);
+static void end_phase                  (Process          *process);
+static gboolean update_process         (Progress         *progress);
+static void destroy_progress           (Progress         *progress);
 static void add_idle                   (gchar            *output, 
                                         Process          *process);
 static gboolean stop_process           (Process          *process);
+static gboolean remove_process         (Process          *process);
 static void destroy_process            (Process          *process);
 
+#define MANIFEST_FILE "manifest"
+#define DELTA_FILE "delta"
+#define PROGRESS_INTERVAL G_USEC_PER_SEC
+#define SUMMARY_SECONDS 10
+
 #define JAVA_INDEXER_GET_PRIVATE(obj) \
   (G_TYPE_INSTANCE_GET_PRIVATE ((obj), JAVA_INDEXER_TYPE, JavaIndexerPrivate))
 
@@ -57,15 +112,43 @@ struct _JavaIndexerPrivate
   JavaToolsProperties *tools_properties;
   JavaConfigurations  *configurations;
   /*gulong               saved_handler_id;*/
+  gulong               editor_added_id;
+  gchar               *group_folder_path;
   guint                event_source_id;  
 };
 
+enum
+{
+  INDEXES_UPDATED,
+  GROUP_CHANGED,
+  LAST_SIGNAL
+};
+
+static guint java_indexer_signals[LAST_SIGNAL] = { 0 };
+
 G_DEFINE_TYPE (JavaIndexer, java_indexer, G_TYPE_OBJECT)
      
 static void 
 java_indexer_class_init (JavaIndexerClass *klass)
 {
   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  java_indexer_signals[INDEXES_UPDATED] =
+    g_signal_new ("indexes-updated", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (JavaIndexerClass, indexes_updated),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
+
+  java_indexer_signals[GROUP_CHANGED] =
+    g_signal_new ("group-changed", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (JavaIndexerClass, group_changed),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
+
   gobject_class->finalize = (GObjectFinalizeFunc) java_indexer_finalize;
   g_type_class_add_private (klass, sizeof (JavaIndexerPrivate));
 }
@@ -85,6 +168,9 @@ java_indexer_finalize (JavaIndexer *indexer)
   if (priv->client_libs)
     g_object_unref (priv->client_libs);
   
+  g_signal_handler_disconnect (priv->codeslayer, priv->editor_added_id);
+  g_free (priv->group_folder_path);
+  
   /*g_signal_handler_disconnect (priv->codeslayer, priv->saved_handler_id);*/
   G_OBJECT_CLASS (java_indexer_parent_class)->finalize (G_OBJECT (indexer));
 }
@@ -103,14 +189,16 @@ java_indexer_new (CodeSlayer          *codeslayer,
   priv->codeslayer = codeslayer;
   priv->tools_properties = tools_properties;
   priv->configurations = configurations;
+  priv->group_folder_path = NULL;
   
   priv->client_projects = java_client_new (codeslayer);
   priv->client_libs = java_client_new (codeslayer);
 
   /*priv->saved_handler_id = g_signal_connect_swapped (G_OBJECT (codeslayer), "editors-all-saved", 
                                                      G_CALLBACK (editors_all_saved_action), indexer);*/
-                                                     
-  verify_dir_exists (codeslayer);
+
+  priv->editor_added_id = g_signal_connect_swapped (G_OBJECT (codeslayer), "editor-added", 
+                                                    G_CALLBACK (check_group), indexer);
 
   g_signal_connect_swapped (G_OBJECT (menu), "index-projects",
                             G_CALLBACK (index_projects_action), indexer);
@@ -118,9 +206,43 @@ java_indexer_new (CodeSlayer          *codeslayer,
   g_signal_connect_swapped (G_OBJECT (menu), "index-libs",
                             G_CALLBACK (index_libs_action), indexer);
 
+  check_group (indexer);
+
   return indexer;
 }
 
+/*
+ * The plugin is not told when another group is opened, but the group's 
+ * editors are added right after, so that is when the active group is 
+ * checked. When it changed the indexes of the new group are refreshed and 
+ * everything that keeps something per group is told to drop it.
+ */
+static void
+check_group (JavaIndexer *indexer)
+{
+  JavaIndexerPrivate *priv;
+  gchar *group_folder_path;
+  
+  priv = JAVA_INDEXER_GET_PRIVATE (indexer);
+  
+  group_folder_path = codeslayer_get_active_group_folder_path (priv->codeslayer);
+  
+  if (g_strcmp0 (group_folder_path, priv->group_folder_path) == 0)
+    {
+      g_free (group_folder_path);
+      return;
+    }
+  
+  g_free (priv->group_folder_path);
+  priv->group_folder_path = group_folder_path;
+  
+  verify_dir_exists (priv->codeslayer);
+  
+  g_thread_new ("Refresh Indexes", (GThreadFunc) refresh_projects_indexes, indexer);
+  
+  g_signal_emit_by_name ((gpointer) indexer, "group-changed");
+}
+
 /*static void 
 editors_all_saved_action (JavaIndexer *indexer,
                           GList      *editors)
@@ -160,31 +282,303 @@ index_libs_action (JavaIndexer *indexer)
 
 static void
 create_projects_indexes (JavaIndexer *indexer)
+{
+  send_projects_indexes (indexer, "Index Projects", scan_source_files (indexer), NULL);
+}
+
+/*
+ * Compare the mtime and size of every source file against the manifest 
+ * that was stored the last time the projects were indexed, and only send 
+ * the files that changed (or went away) over to the server to be reindexed. 
+ * Without a manifest it is not known what the indexes hold, if there are 
+ * any, so everything is indexed.
+ */
+static void
+refresh_projects_indexes (JavaIndexer *indexer)
 {
   JavaIndexerPrivate *priv;
+  GHashTable *old_manifest;
+  GHashTable *new_manifest;
+  gchar *manifest_path;
+  gchar *delta_path;
 
+  priv = JAVA_INDEXER_GET_PRIVATE (indexer);
+  
+  manifest_path = get_manifest_path (priv->codeslayer, MANIFEST_FILE);
+  old_manifest = load_manifest (manifest_path);
+  new_manifest = scan_source_files (indexer);
+  g_free (manifest_path);
+  
+  if (old_manifest == NULL)
+    {
+      send_projects_indexes (indexer, "Index Projects", new_manifest, NULL);
+      return;
+    }
+  
+  delta_path = write_delta (indexer, old_manifest, new_manifest);
+  g_hash_table_destroy (old_manifest);
+  
+  if (delta_path == NULL)
+    {
+      g_hash_table_destroy (new_manifest);
+      return;
+    }
+
+  send_projects_indexes (indexer, "Refresh Indexes", new_manifest, delta_path);
+  g_free (delta_path);
+}
+
+/*
+ * Indexes the projects, or only the files in the delta file when there is 
+ * one. The manifest is taken over by the process and saved once the 
+ * server is done, so that an index that was cut off is never taken as 
+ * up to date.
+ */
+static void
+send_projects_indexes (JavaIndexer *indexer, 
+                       const gchar *name, 
+                       GHashTable  *manifest, 
+                       const gchar *delta_path)
+{
+  JavaIndexerPrivate *priv;
   gchar *source_indexes_folders;
+  gchar *resource_limits;
   gchar *input;
   Process *process;
 
   priv = JAVA_INDEXER_GET_PRIVATE (indexer);
   
-  process = g_malloc (sizeof (Process));
-  process->codeslayer = priv->codeslayer;
-  process->process_id = codeslayer_add_to_processes (priv->codeslayer, "Index Projects", NULL, NULL);
+  process = create_process (indexer, name);
+  process->manifest = manifest;
+  process->manifest_path = get_manifest_path (priv->codeslayer, MANIFEST_FILE);
   
   source_indexes_folders = get_source_indexes_folders (priv->codeslayer, priv->configurations);
+  resource_limits = get_resource_limits (indexer);
   
-  input = g_strconcat ("-program indexer -type projects", source_indexes_folders, NULL);
+  if (delta_path != NULL)
+    input = g_strconcat ("-program indexer -type projects", source_indexes_folders, 
+                         " -deltafile ", delta_path, resource_limits, NULL);
+  else
+    input = g_strconcat ("-program indexer -type projects", source_indexes_folders, 
+                         resource_limits, NULL);
   
-  g_print ("input %s\n", input);
-
-  java_client_send_with_callback (priv->client_projects, input, (ClientCallbackFunc) add_idle, process);
+  java_client_send_with_progress (priv->client_projects, input, process->cancellable,
+                                  (ClientProgressFunc) add_progress_idle, 
+                                  (ClientCallbackFunc) add_idle, process);
   
   g_free (source_indexes_folders);
+  g_free (resource_limits);
   g_free (input);
 }
 
+static GHashTable*
+scan_source_files (JavaIndexer *indexer)
+{
+  JavaIndexerPrivate *priv;
+  GHashTable *manifest;
+  GHashTable *visited;
+  GList *list;
+  
+  priv = JAVA_INDEXER_GET_PRIVATE (indexer);
+  
+  manifest = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+  visited = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  
+  list = java_configurations_get_list (priv->configurations);
+  while (list != NULL)
+    {
+      JavaConfiguration *configuration = list->data;
+      const gchar *source_folder;
+      const gchar *test_folder;
+      source_folder = java_configuration_get_source_folder (configuration);
+      test_folder = java_configuration_get_test_folder (configuration);
+      if (codeslayer_utils_has_text (source_folder))
+        scan_folder (manifest, visited, source_folder);
+      if (codeslayer_utils_has_text (test_folder))
+        scan_folder (manifest, visited, test_folder);
+      list = g_list_next (list);
+    }
+  
+  g_hash_table_destroy (visited);
+  
+  return manifest;
+}
+
+/*
+ * The manifest maps the file path to its mtime and size, kept in the 
+ * same tab separated form that they are stored on disk. Symlinks are 
+ * followed, so every folder is remembered by its device and inode and 
+ * only scanned once, which also keeps a symlink loop from recursing.
+ */
+static void
+scan_folder (GHashTable  *manifest, 
+             GHashTable  *visited, 
+             const gchar *folder_path)
+{
+  GDir *dir;
+  const gchar *file_name;
+  GStatBuf buf;
+  gchar *key;
+  
+  if (g_stat (folder_path, &buf) != 0)
+    return;
+  
+  key = g_strdup_printf ("%lu:%lu", (gulong) buf.st_dev, (gulong) buf.st_ino);
+  if (g_hash_table_contains (visited, key))
+    {
+      g_free (key);
+      return;
+    }
+  g_hash_table_add (visited, key);
+  
+  dir = g_dir_open (folder_path, 0, NULL);
+  if (dir == NULL)
+    return;
+  
+  while ((file_name = g_dir_read_name (dir)) != NULL)
+    {
+      gchar *file_path;
+      GStatBuf file_buf;
+      
+      file_path = g_build_filename (folder_path, file_name, NULL);
+      
+      if (g_stat (file_path, &file_buf) != 0)
+        {
+          g_free (file_path);
+          continue;
+        }
+      
+      if (S_ISDIR (file_buf.st_mode))
+        {
+          scan_folder (manifest, visited, file_path);
+          g_free (file_path);
+        }
+      else if (g_str_has_suffix (file_name, ".java"))
+        {
+          g_hash_table_insert (manifest, file_path, 
+                               g_strdup_printf ("%ld\t%ld", (glong) file_buf.st_mtime, (glong) file_buf.st_size));
+        }
+      else
+        {
+          g_free (file_path);
+        }
+    }
+    
+  g_dir_close (dir);
+}
+
+static GHashTable*
+load_manifest (const gchar *manifest_path)
+{
+  GHashTable *manifest;
+  gchar *contents;
+  gchar **split;
+  gchar **tmp;
+  
+  if (!g_file_get_contents (manifest_path, &contents, NULL, NULL))
+    return NULL;
+  
+  manifest = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+  
+  split = g_strsplit (contents, "\n", -1);
+  for (tmp = split; *tmp != NULL; tmp++)
+    {
+      gchar *value;
+      value = strchr (*tmp, '\t');
+      if (value == NULL)
+        continue;
+      *value = '\0';
+      g_hash_table_insert (manifest, g_strdup (*tmp), g_strdup (value + 1));
+    }
+
+  g_strfreev (split);
+  g_free (contents);
+  
+  return manifest;
+}
+
+static void
+save_manifest (GHashTable  *manifest, 
+               const gchar *manifest_path)
+{
+  GHashTableIter iter;
+  gpointer key, value;
+  GString *string;
+  
+  string = g_string_sized_new (g_hash_table_size (manifest) * 96);
+  
+  g_hash_table_iter_init (&iter, manifest);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      g_string_append (string, key);
+      g_string_append_c (string, '\t');
+      g_string_append (string, value);
+      g_string_append_c (string, '\n');
+    }
+  
+  g_file_set_contents (manifest_path, string->str, string->len, NULL);
+  g_string_free (string, TRUE);
+}
+
+/*
+ * Write out the files that need to be reindexed, one per line, prefixed 
+ * by M for modified (or new) and D for deleted. Returns NULL when the 
+ * indexes are up to date.
+ */
+static gchar*
+write_delta (JavaIndexer *indexer, 
+             GHashTable  *old_manifest, 
+             GHashTable  *new_manifest)
+{
+  JavaIndexerPrivate *priv;
+  GHashTableIter iter;
+  gpointer key, value;
+  GString *string;
+  gchar *delta_path;
+  
+  priv = JAVA_INDEXER_GET_PRIVATE (indexer);
+  
+  string = g_string_new ("");
+
+  g_hash_table_iter_init (&iter, new_manifest);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      if (g_strcmp0 (g_hash_table_lookup (old_manifest, key), value) != 0)
+        g_string_append_printf (string, "M\t%s\n", (gchar *) key);
+    }
+  
+  g_hash_table_iter_init (&iter, old_manifest);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      if (!g_hash_table_contains (new_manifest, key))
+        g_string_append_printf (string, "D\t%s\n", (gchar *) key);
+    }
+    
+  if (string->len == 0)
+    {
+      g_string_free (string, TRUE);
+      return NULL;
+    }
+  
+  delta_path = get_manifest_path (priv->codeslayer, DELTA_FILE);
+  g_file_set_contents (delta_path, string->str, string->len, NULL);
+  g_string_free (string, TRUE);
+  
+  return delta_path;
+}
+
+static gchar*
+get_manifest_path (CodeSlayer  *codeslayer, 
+                   const gchar *file_name)
+{
+  gchar *group_folder_path;
+  gchar *result;
+  group_folder_path = codeslayer_get_active_group_folder_path (codeslayer);  
+  result = g_build_filename (group_folder_path, "indexes", file_name, NULL);
+  g_free (group_folder_path);
+  return result;
+}
+
 static void
 create_libs_indexes (JavaIndexer *indexer)
 {
@@ -193,10 +587,12 @@ create_libs_indexes (JavaIndexer *indexer)
   GString *string;
 
   gchar *lib_indexes_folders;
+  gchar *resource_limits;
 
   gchar *group_folder_path;
   gchar *tmp_folder_path;
   const gchar *jdk_folder;
+  JavaSuppressions *suppressions;
   const gchar *suppressions_file;
 
   gchar *input;
@@ -204,12 +600,11 @@ create_libs_indexes (JavaIndexer *indexer)
   
   priv = JAVA_INDEXER_GET_PRIVATE (indexer);
   
-  process = g_malloc (sizeof (Process));
-  process->codeslayer = priv->codeslayer;
-  process->process_id = codeslayer_add_to_processes (priv->codeslayer, "Index Libs", NULL, NULL);
+  process = create_process (indexer, "Index Libs");
   
   lib_indexes_folders = get_lib_indexes_folders (priv->codeslayer, priv->configurations);
   jdk_folder = java_tools_properties_get_jdk_folder (priv->tools_properties);
+  suppressions = java_tools_properties_get_suppressions (priv->tools_properties);
   suppressions_file = java_tools_properties_get_suppressions_file (priv->tools_properties);
   
   group_folder_path = codeslayer_get_active_group_folder_path (priv->codeslayer);
@@ -219,7 +614,7 @@ create_libs_indexes (JavaIndexer *indexer)
   string = g_string_append (string, "-program indexer -type libs");
   string = g_string_append (string, lib_indexes_folders);
   
-  if (codeslayer_utils_has_text (suppressions_file))
+  if (!java_suppressions_is_empty (suppressions))
     {
       string = g_string_append (string, " -suppressionsfile ");
       string = g_string_append (string, suppressions_file);
@@ -235,27 +630,243 @@ create_libs_indexes (JavaIndexer *indexer)
       string = g_string_append (string, tmp_folder_path);
     }
     
+  resource_limits = get_resource_limits (indexer);
+  string = g_string_append (string, resource_limits);
+    
   input = g_string_free (string, FALSE);    
   
-  g_print ("input %s\n", input);
-
-  java_client_send_with_callback (priv->client_libs, input, (ClientCallbackFunc) add_idle, process);
+  java_client_send_with_progress (priv->client_libs, input, process->cancellable,
+                                  (ClientProgressFunc) add_progress_idle, 
+                                  (ClientCallbackFunc) add_idle, process);
   
   g_free (lib_indexes_folders);
+  g_free (resource_limits);
   g_free (input);
 }
 
-void
-add_idle (gchar   *text, 
-          Process *process)
+/*
+ * The indexing itself happens in the server, so the limits from the tools 
+ * properties are handed over with the request for the server to apply to 
+ * its indexing threads.
+ */
+static gchar*
+get_resource_limits (JavaIndexer *indexer)
+{
+  JavaIndexerPrivate *priv;
+  GString *string;
+  gint threads;
+  gint nice;
+  const gchar *io_priority;
+  
+  priv = JAVA_INDEXER_GET_PRIVATE (indexer);
+  
+  threads = java_tools_properties_get_indexer_threads (priv->tools_properties);
+  nice = java_tools_properties_get_indexer_nice (priv->tools_properties);
+  io_priority = java_tools_properties_get_indexer_io_priority (priv->tools_properties);
+  
+  string = g_string_new ("");
+  
+  if (threads > 0)
+    g_string_append_printf (string, " -maxthreads %d", threads);
+
+  if (nice > 0)
+    g_string_append_printf (string, " -nicelevel %d", nice);
+
+  if (codeslayer_utils_has_text (io_priority))
+    g_string_append_printf (string, " -iopriority %s", io_priority);
+  
+  return g_string_free (string, FALSE);
+}
+
+static Process*
+create_process (JavaIndexer *indexer, 
+                const gchar *name)
 {
-  if (text != NULL)
+  JavaIndexerPrivate *priv;
+  Process *process;
+  
+  priv = JAVA_INDEXER_GET_PRIVATE (indexer);
+  
+  process = g_malloc (sizeof (Process));
+  process->indexer = g_object_ref (indexer);
+  process->codeslayer = priv->codeslayer;
+  process->name = g_strdup (name);
+  process->phase = NULL;
+  process->timer = g_timer_new ();
+  process->phase_timer = g_timer_new ();
+  process->summary = g_string_new ("");
+  process->last_update = 0;
+  process->cancellable = g_cancellable_new ();
+  process->manifest = NULL;
+  process->manifest_path = NULL;
+  process->updated = FALSE;
+  process->process_id = codeslayer_add_to_processes (priv->codeslayer, process->name, 
+                                                     (GFunc) cancel_process, process);
+  
+  return process;
+}
+
+/*
+ * Stopping the process from the process indicator drops the connection to 
+ * the server, the add_idle() callback then takes care of the cleanup.
+ */
+static void
+cancel_process (Process *process)
+{
+  g_cancellable_cancel (process->cancellable);
+}
+
+/*
+ * Called on the client thread for every progress record streamed back from 
+ * the server. The records look like the following (tab separated):
+ *
+ * PROGRESS  phase  files processed  files total  bytes  current jar
+ *
+ * The process indicator is only refreshed once a second so that a fast 
+ * indexer does not flood the main loop.
+ */
+static void
+add_progress_idle (gchar   *line, 
+                   Process *process)
+{
+  Progress *progress;
+  gint64 now;
+  gchar *text;
+  
+  text = get_progress_text (process, line);  
+  if (text == NULL)
+    return;
+  
+  now = g_get_monotonic_time ();
+  if (now - process->last_update < PROGRESS_INTERVAL)
     {
-      g_print ("output %s\n", text);    
       g_free (text);
+      return;
     }
     
-  g_idle_add_full (G_PRIORITY_DEFAULT_IDLE, (GSourceFunc) stop_process, process, (GDestroyNotify)destroy_process);    
+  process->last_update = now;
+  
+  progress = g_malloc (sizeof (Progress));
+  progress->process = process;
+  progress->text = text;
+  g_idle_add_full (G_PRIORITY_DEFAULT_IDLE, (GSourceFunc) update_process, progress, (GDestroyNotify)destroy_progress);    
+}
+
+static gchar*
+get_progress_text (Process *process, 
+                   gchar   *line)
+{
+  gchar **split;
+  gchar *phase;
+  gint files;
+  gint total;
+  gdouble megabytes;
+  gchar *jar;
+  gdouble elapsed;
+  gdouble rate = 0;
+  GString *string;
+  
+  split = g_strsplit (line, "\t", -1);
+  
+  if (g_strv_length (split) < 6)
+    {
+      g_strfreev (split);
+      return NULL;
+    }
+    
+  phase = split[1];
+  files = atoi (split[2]);
+  total = atoi (split[3]);
+  megabytes = g_ascii_strtod (split[4], NULL) / (1024 * 1024);
+  jar = split[5];
+  
+  if (g_strcmp0 (process->phase, phase) != 0)
+    {
+      end_phase (process);
+      process->phase = g_strdup (phase);
+      g_timer_start (process->phase_timer);
+    }
+
+  elapsed = g_timer_elapsed (process->phase_timer, NULL);
+  if (elapsed > 0)
+    rate = files / elapsed;
+
+  string = g_string_new (process->name);
+  g_string_append_printf (string, " (%s): %d", phase, files);
+  
+  if (total > 0)
+    g_string_append_printf (string, "/%d files %d%%", total, (files * 100) / total);
+  else
+    g_string_append (string, " files");
+
+  g_string_append_printf (string, ", %.1f MB, %.0f files/s", megabytes, rate);
+  
+  if (total > 0 && rate > 0)
+    g_string_append_printf (string, ", ETA %.0fs", (total - files) / rate);
+    
+  if (codeslayer_utils_has_text (jar))
+    g_string_append_printf (string, " - %s", jar);
+  
+  g_strfreev (split);
+
+  return g_string_free (string, FALSE);
+}
+
+static void
+end_phase (Process *process)
+{
+  if (process->phase == NULL)
+    return;
+
+  if (process->summary->len > 0)
+    g_string_append (process->summary, ", ");
+    
+  g_string_append_printf (process->summary, "%s %.1fs", process->phase, 
+                          g_timer_elapsed (process->phase_timer, NULL));
+  
+  g_free (process->phase);
+  process->phase = NULL;
+}
+
+static gboolean 
+update_process (Progress *progress)
+{
+  Process *process = progress->process;
+  
+  if (g_cancellable_is_cancelled (process->cancellable))
+    return FALSE;
+  
+  codeslayer_remove_from_processes (process->codeslayer, process->process_id);
+  process->process_id = codeslayer_add_to_processes (process->codeslayer, progress->text, 
+                                                     (GFunc) cancel_process, process);
+  return FALSE;
+}
+
+static void 
+destroy_progress (Progress *progress)
+{
+  g_free (progress->text);
+  g_free (progress);
+}
+
+static void
+add_idle (gchar   *text, 
+          Process *process)
+{
+  end_phase (process);
+  g_timer_stop (process->timer);
+  
+  /* only remember what was indexed once the server said it was done, 
+     a stream that was cut off or cancelled comes back as NULL */
+  
+  if (text != NULL && process->manifest != NULL)
+    save_manifest (process->manifest, process->manifest_path);
+    
+  process->updated = text != NULL;
+    
+  g_free (text);
+    
+  g_idle_add ((GSourceFunc) stop_process, process);    
 }
 
 static void
@@ -277,8 +888,38 @@ verify_dir_exists (CodeSlayer *codeslayer)
   g_object_unref (file);
 }
 
+/*
+ * Leave the per phase timing summary in the process indicator for a little 
+ * while before the process is removed.
+ */
 static gboolean 
 stop_process (Process *process)
+{
+  gchar *text;
+  
+  if (g_cancellable_is_cancelled (process->cancellable))
+    text = g_strdup_printf ("%s cancelled after %.1fs", process->name, 
+                            g_timer_elapsed (process->timer, NULL));
+  else
+    text = g_strdup_printf ("%s done in %.1fs: %s", process->name, 
+                            g_timer_elapsed (process->timer, NULL), 
+                            process->summary->str);
+  
+  if (process->updated)
+    g_signal_emit_by_name ((gpointer) process->indexer, "indexes-updated");
+  
+  codeslayer_remove_from_processes (process->codeslayer, process->process_id);
+  process->process_id = codeslayer_add_to_processes (process->codeslayer, text, NULL, NULL);
+  
+  g_timeout_add_seconds_full (G_PRIORITY_DEFAULT_IDLE, SUMMARY_SECONDS, 
+                              (GSourceFunc) remove_process, process, 
+                              (GDestroyNotify)destroy_process);
+  g_free (text);
+  return FALSE;
+}
+
+static gboolean 
+remove_process (Process *process)
 {
   codeslayer_remove_from_processes (process->codeslayer, process->process_id);
   return FALSE;
@@ -287,5 +928,15 @@ stop_process (Process *process)
 static void 
 destroy_process (Process *process)
 {
+  g_object_unref (process->indexer);
+  g_timer_destroy (process->timer);
+  g_timer_destroy (process->phase_timer);
+  g_object_unref (process->cancellable);
+  if (process->manifest != NULL)
+    g_hash_table_destroy (process->manifest);
+  g_free (process->manifest_path);
+  g_string_free (process->summary, TRUE);
+  g_free (process->phase);
+  g_free (process->name);
   g_free (process);
 }
@@ -43,6 +43,9 @@ struct _JavaIndexer
 struct _JavaIndexerClass
 {
   GObjectClass parent_class;
+  
+  void (*indexes_updated) (JavaIndexer *indexer);
+  void (*group_changed) (JavaIndexer *indexer);
 };
 
 GType java_indexer_get_type (void) G_GNUC_CONST;
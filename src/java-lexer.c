@@ -0,0 +1,820 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+#include "java-lexer.h"
+#include "java-identifiers.h"
+
+/*
+ * A Java lexer that is attached to a GtkTextBuffer and keeps the tokens of 
+ * every line in a side table. Only the lines that were edited get lexed 
+ * again, plus the lines after them whose starting state changed, such as 
+ * when a block comment is opened or closed.
+ *
+ * Characters are looked up in a class table and each class has its own 
+ * scanning rule, so a line is lexed in a single pass without any regex.
+ *
+ * The identifiers of every lexed line are also kept in a trie, which is 
+ * updated line by line as lines are lexed and thrown away. The edited 
+ * lines are lexed again on idle, so the trie keeps up with the typing 
+ * rather than catching up when it is looked at.
+ */
+
+typedef enum
+{
+  STATE_CODE,
+  STATE_BLOCK_COMMENT,
+  STATE_TEXT_BLOCK
+} State;
+
+typedef enum
+{
+  CLASS_OTHER,
+  CLASS_LETTER,
+  CLASS_DIGIT,
+  CLASS_SPACE,
+  CLASS_QUOTE,
+  CLASS_APOSTROPHE,
+  CLASS_SLASH,
+  CLASS_DOT
+} Class;
+
+typedef struct
+{
+  gchar   *text;
+  GArray  *tokens;
+  State    start_state;
+  State    end_state;
+  gboolean dirty;
+} Line;
+
+static void java_lexer_class_init  (JavaLexerClass *klass);
+static void java_lexer_init        (JavaLexer      *lexer);
+static void java_lexer_finalize    (JavaLexer      *lexer);
+
+static void insert_text_action     (JavaLexer      *lexer, 
+                                    GtkTextIter    *location, 
+                                    gchar          *text, 
+                                    gint            length);
+static void delete_range_action    (JavaLexer      *lexer, 
+                                    GtkTextIter    *start, 
+                                    GtkTextIter    *end);
+static void insert_lines           (JavaLexer      *lexer, 
+                                    gint            line, 
+                                    gint            count);
+static void mark_dirty             (JavaLexer      *lexer, 
+                                    gint            line);
+static void lex_line               (JavaLexer      *lexer, 
+                                    gint            line_number, 
+                                    State           state);
+static State lex                   (const gchar    *text, 
+                                    gint            length, 
+                                    State           state, 
+                                    GArray         *tokens);
+static gint find_end               (const gchar    *text, 
+                                    gint            length, 
+                                    gint            i, 
+                                    const gchar    *end);
+static gint find_quote             (const gchar    *text, 
+                                    gint            length, 
+                                    gint            i, 
+                                    gchar           quote);
+static gboolean is_keyword         (const gchar    *text, 
+                                    gint            length);
+static void add_token              (GArray         *tokens, 
+                                    JavaTokenType   type, 
+                                    gint            index, 
+                                    gint            length);
+static void index_line             (JavaLexer      *lexer, 
+                                    Line           *line, 
+                                    gboolean        add);
+static void index_tokens           (JavaIdentifiers *identifiers, 
+                                    const gchar    *text, 
+                                    GArray         *tokens, 
+                                    gboolean        add);
+static gboolean relex_idle         (JavaLexer      *lexer);
+static void clear_line             (JavaLexer      *lexer, 
+                                    Line           *line);
+
+#define JAVA_LEXER_KEY "java-lexer"
+#define MAX_KEYWORD_LENGTH 12
+
+#define JAVA_LEXER_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), JAVA_LEXER_TYPE, JavaLexerPrivate))
+
+typedef struct _JavaLexerPrivate JavaLexerPrivate;
+
+struct _JavaLexerPrivate
+{
+  GtkTextBuffer   *buffer;
+  GArray          *lines;
+  gint             first_unchecked;
+  gint             dirty_count;
+  JavaIdentifiers *identifiers;
+  JavaIdentifiers *shared;
+  guint            relex_id;
+};
+
+static guint8 classes[128];
+static GHashTable *keywords = NULL;
+
+static const gchar *java_keywords[] = {
+  "abstract", "assert", "boolean", "break", "byte", "case", "catch", "char", 
+  "class", "const", "continue", "default", "do", "double", "else", "enum", 
+  "extends", "final", "finally", "float", "for", "goto", "if", "implements", 
+  "import", "instanceof", "int", "interface", "long", "native", "new", 
+  "package", "private", "protected", "public", "return", "short", "static", 
+  "strictfp", "super", "switch", "synchronized", "this", "throw", "throws", 
+  "transient", "try", "void", "volatile", "while", "true", "false", "null", 
+  NULL
+};
+
+G_DEFINE_TYPE (JavaLexer, java_lexer, G_TYPE_OBJECT)
+
+static void 
+java_lexer_class_init (JavaLexerClass *klass)
+{
+  const gchar **keyword;
+  gint ch;
+  
+  G_OBJECT_CLASS (klass)->finalize = (GObjectFinalizeFunc) java_lexer_finalize;
+  g_type_class_add_private (klass, sizeof (JavaLexerPrivate));
+  
+  for (ch = 0; ch < 128; ch++)
+    {
+      if (g_ascii_isalpha (ch) || ch == '_' || ch == '$')
+        classes[ch] = CLASS_LETTER;
+      else if (g_ascii_isdigit (ch))
+        classes[ch] = CLASS_DIGIT;
+      else if (g_ascii_isspace (ch))
+        classes[ch] = CLASS_SPACE;
+      else
+        classes[ch] = CLASS_OTHER;
+    }
+  
+  classes['"'] = CLASS_QUOTE;
+  classes['\''] = CLASS_APOSTROPHE;
+  classes['/'] = CLASS_SLASH;
+  classes['.'] = CLASS_DOT;
+  
+  keywords = g_hash_table_new (g_str_hash, g_str_equal);
+  for (keyword = java_keywords; *keyword != NULL; keyword++)
+    g_hash_table_add (keywords, (gpointer) *keyword);
+}
+
+static void
+java_lexer_init (JavaLexer *lexer)
+{
+  JavaLexerPrivate *priv;
+  priv = JAVA_LEXER_GET_PRIVATE (lexer);
+  priv->lines = g_array_new (FALSE, TRUE, sizeof (Line));
+  priv->first_unchecked = 0;
+  priv->dirty_count = 0;
+  priv->identifiers = java_identifiers_new ();
+  priv->shared = NULL;
+  priv->relex_id = 0;
+}
+
+static void
+java_lexer_finalize (JavaLexer *lexer)
+{
+  JavaLexerPrivate *priv;
+  guint i;
+  
+  priv = JAVA_LEXER_GET_PRIVATE (lexer);
+  
+  if (priv->relex_id != 0)
+    g_source_remove (priv->relex_id);
+  
+  for (i = 0; i < priv->lines->len; i++)
+    clear_line (lexer, &g_array_index (priv->lines, Line, i));
+  
+  g_array_free (priv->lines, TRUE);
+  g_object_unref (priv->identifiers);
+  
+  if (priv->shared != NULL)
+    g_object_unref (priv->shared);
+
+  G_OBJECT_CLASS (java_lexer_parent_class)-> finalize (G_OBJECT (lexer));
+}
+
+/*
+ * Returns the lexer for the buffer, creating it the first time. The lexer 
+ * belongs to the buffer and goes away with it.
+ */
+JavaLexer*
+java_lexer_get (GtkTextBuffer *buffer)
+{
+  JavaLexerPrivate *priv;
+  JavaLexer *lexer;
+  
+  lexer = g_object_get_data (G_OBJECT (buffer), JAVA_LEXER_KEY);
+  if (lexer != NULL)
+    return lexer;
+
+  lexer = JAVA_LEXER (g_object_new (java_lexer_get_type (), NULL));
+  priv = JAVA_LEXER_GET_PRIVATE (lexer);
+  priv->buffer = buffer;
+  
+  insert_lines (lexer, 0, gtk_text_buffer_get_line_count (buffer));
+  
+  g_signal_connect_object (G_OBJECT (buffer), "insert-text",
+                           G_CALLBACK (insert_text_action), lexer, 
+                           G_CONNECT_SWAPPED | G_CONNECT_AFTER);
+  
+  g_signal_connect_object (G_OBJECT (buffer), "delete-range",
+                           G_CALLBACK (delete_range_action), lexer, 
+                           G_CONNECT_SWAPPED);
+  
+  g_object_set_data_full (G_OBJECT (buffer), JAVA_LEXER_KEY, lexer, g_object_unref);
+  
+  return lexer;
+}
+
+gint
+java_lexer_get_line_count (JavaLexer *lexer)
+{
+  JavaLexerPrivate *priv;
+  priv = JAVA_LEXER_GET_PRIVATE (lexer);
+  return priv->lines->len;
+}
+
+/*
+ * Returns the tokens on the line, lexing whatever is out of date up to 
+ * that line first. The array belongs to the lexer and is only good until 
+ * the buffer changes, and is NULL when there is no such line.
+ */
+GArray*
+java_lexer_get_tokens (JavaLexer *lexer, 
+                       gint       line_number)
+{
+  JavaLexerPrivate *priv;
+  gint i;
+  
+  priv = JAVA_LEXER_GET_PRIVATE (lexer);
+  
+  if (line_number < 0 || line_number >= (gint) priv->lines->len)
+    return NULL;
+  
+  for (i = priv->first_unchecked; i <= line_number; i++)
+    {
+      Line *line;
+      State state = STATE_CODE;
+      
+      if (i > 0)
+        state = g_array_index (priv->lines, Line, i - 1).end_state;
+      
+      line = &g_array_index (priv->lines, Line, i);
+      
+      if (line->dirty || line->start_state != state)
+        lex_line (lexer, i, state);
+    }
+  
+  if (priv->first_unchecked < i)
+    priv->first_unchecked = i;
+  
+  return g_array_index (priv->lines, Line, line_number).tokens;
+}
+
+const gchar*
+java_lexer_get_text (JavaLexer *lexer, 
+                     gint       line_number)
+{
+  JavaLexerPrivate *priv;
+  priv = JAVA_LEXER_GET_PRIVATE (lexer);
+  
+  if (java_lexer_get_tokens (lexer, line_number) == NULL)
+    return NULL;
+  
+  return g_array_index (priv->lines, Line, line_number).text;
+}
+
+/*
+ * Returns the identifiers of the whole buffer. The trie is normally up to 
+ * date already, since the edits are lexed on idle, and only the lines that 
+ * changed since then get lexed here.
+ */
+JavaIdentifiers*
+java_lexer_get_identifiers (JavaLexer *lexer)
+{
+  JavaLexerPrivate *priv;
+  priv = JAVA_LEXER_GET_PRIVATE (lexer);
+  
+  if (priv->dirty_count > 0 || priv->first_unchecked < (gint) priv->lines->len)
+    java_lexer_get_tokens (lexer, priv->lines->len - 1);
+  
+  return priv->identifiers;
+}
+
+/*
+ * Also counts the identifiers of this buffer in the shared trie, for as 
+ * long as the buffer is around.
+ */
+void
+java_lexer_share_identifiers (JavaLexer       *lexer, 
+                              JavaIdentifiers *shared)
+{
+  JavaLexerPrivate *priv;
+  guint i;
+  
+  priv = JAVA_LEXER_GET_PRIVATE (lexer);
+  
+  if (priv->shared != NULL)
+    return;
+  
+  priv->shared = g_object_ref (shared);
+  
+  for (i = 0; i < priv->lines->len; i++)
+    {
+      Line *line = &g_array_index (priv->lines, Line, i);
+      if (line->tokens != NULL)
+        index_tokens (priv->shared, line->text, line->tokens, TRUE);
+    }
+  
+  if (priv->first_unchecked < (gint) priv->lines->len && priv->relex_id == 0)
+    priv->relex_id = g_idle_add_full (G_PRIORITY_LOW, (GSourceFunc) relex_idle, 
+                                      lexer, NULL);
+}
+
+/*
+ * Lexes the text as a file on its own and adds its identifiers, without 
+ * keeping any of the tokens around. This is for files that are not open, 
+ * and is safe to call from another thread.
+ */
+void
+java_lexer_scan (const gchar     *text, 
+                 JavaIdentifiers *identifiers)
+{
+  GArray *tokens;
+  State state = STATE_CODE;
+  const gchar *line;
+  
+  g_type_class_unref (g_type_class_ref (JAVA_LEXER_TYPE));
+  
+  tokens = g_array_new (FALSE, FALSE, sizeof (JavaToken));
+  
+  for (line = text; line != NULL && *line != '\0';)
+    {
+      const gchar *end = strchr (line, '\n');
+      gint length = end != NULL ? end - line : (gint) strlen (line);
+      
+      g_array_set_size (tokens, 0);
+      state = lex (line, length, state, tokens);
+      index_tokens (identifiers, line, tokens, TRUE);
+      
+      line = end != NULL ? end + 1 : NULL;
+    }
+  
+  g_array_free (tokens, TRUE);
+}
+
+gboolean
+java_lexer_token_equals (JavaLexer   *lexer, 
+                         gint         line_number, 
+                         JavaToken   *token, 
+                         const gchar *text)
+{
+  const gchar *line_text;
+  
+  line_text = java_lexer_get_text (lexer, line_number);
+  if (line_text == NULL)
+    return FALSE;
+  
+  return strlen (text) == (gsize) token->length && 
+         strncmp (line_text + token->index, text, token->length) == 0;
+}
+
+/*
+ * The lines are counted the way the buffer counts them, so that \r, \r\n 
+ * and the unicode paragraph separator each start a new line as well.
+ */
+static void
+insert_text_action (JavaLexer   *lexer, 
+                    GtkTextIter *location, 
+                    gchar       *text, 
+                    gint         length)
+{
+  gint line;
+  gint count = 0;
+  
+  while (length > 0)
+    {
+      gint delimiter;
+      gint next;
+      
+      pango_find_paragraph_boundary (text, length, &delimiter, &next);
+      if (delimiter == next)
+        break;
+      
+      count++;
+      text += next;
+      length -= next;
+    }
+  
+  line = gtk_text_iter_get_line (location) - count;
+  
+  insert_lines (lexer, line + 1, count);
+  mark_dirty (lexer, line);
+}
+
+static void
+delete_range_action (JavaLexer   *lexer, 
+                     GtkTextIter *start, 
+                     GtkTextIter *end)
+{
+  JavaLexerPrivate *priv;
+  gint start_line;
+  gint end_line;
+  gint i;
+  
+  priv = JAVA_LEXER_GET_PRIVATE (lexer);
+  
+  start_line = gtk_text_iter_get_line (start);
+  end_line = gtk_text_iter_get_line (end);
+  
+  if (start_line > end_line)
+    {
+      gint tmp = start_line;
+      start_line = end_line;
+      end_line = tmp;
+    }
+  
+  end_line = MIN (end_line, (gint) priv->lines->len - 1);
+  
+  for (i = start_line + 1; i <= end_line; i++)
+    {
+      Line *line = &g_array_index (priv->lines, Line, i);
+      if (line->dirty)
+        priv->dirty_count--;
+      clear_line (lexer, line);
+    }
+  
+  if (end_line > start_line)
+    g_array_remove_range (priv->lines, start_line + 1, end_line - start_line);
+  
+  mark_dirty (lexer, start_line);
+}
+
+static void
+insert_lines (JavaLexer *lexer, 
+              gint       line, 
+              gint       count)
+{
+  JavaLexerPrivate *priv;
+  gint i;
+  
+  priv = JAVA_LEXER_GET_PRIVATE (lexer);
+  
+  if (count <= 0)
+    return;
+  
+  g_array_set_size (priv->lines, priv->lines->len + count);
+  
+  if (line + count < (gint) priv->lines->len)
+    memmove (&g_array_index (priv->lines, Line, line + count), 
+             &g_array_index (priv->lines, Line, line), 
+             (priv->lines->len - line - count) * sizeof (Line));
+  
+  for (i = line; i < line + count; i++)
+    {
+      Line *new_line = &g_array_index (priv->lines, Line, i);
+      new_line->text = NULL;
+      new_line->tokens = NULL;
+      new_line->start_state = STATE_CODE;
+      new_line->end_state = STATE_CODE;
+      new_line->dirty = TRUE;
+    }
+  
+  priv->dirty_count += count;
+  
+  if (line < priv->first_unchecked)
+    priv->first_unchecked = line;
+}
+
+static void
+mark_dirty (JavaLexer *lexer, 
+            gint       line)
+{
+  JavaLexerPrivate *priv;
+  priv = JAVA_LEXER_GET_PRIVATE (lexer);
+  
+  if (line < 0 || line >= (gint) priv->lines->len)
+    return;
+  
+  if (!g_array_index (priv->lines, Line, line).dirty)
+    {
+      g_array_index (priv->lines, Line, line).dirty = TRUE;
+      priv->dirty_count++;
+    }
+  
+  if (line < priv->first_unchecked)
+    priv->first_unchecked = line;
+  
+  if (priv->relex_id == 0)
+    priv->relex_id = g_idle_add_full (G_PRIORITY_LOW, (GSourceFunc) relex_idle, 
+                                      lexer, NULL);
+}
+
+static gboolean
+relex_idle (JavaLexer *lexer)
+{
+  JavaLexerPrivate *priv;
+  priv = JAVA_LEXER_GET_PRIVATE (lexer);
+  
+  priv->relex_id = 0;
+  java_lexer_get_tokens (lexer, priv->lines->len - 1);
+  
+  return FALSE;
+}
+
+static void
+lex_line (JavaLexer *lexer, 
+          gint       line_number, 
+          State      state)
+{
+  JavaLexerPrivate *priv;
+  GtkTextIter start;
+  GtkTextIter end;
+  Line *line;
+  
+  priv = JAVA_LEXER_GET_PRIVATE (lexer);
+  
+  line = &g_array_index (priv->lines, Line, line_number);
+  clear_line (lexer, line);
+  
+  if (line->dirty)
+    priv->dirty_count--;
+  
+  gtk_text_buffer_get_iter_at_line (priv->buffer, &start, line_number);
+  end = start;
+  if (!gtk_text_iter_ends_line (&end))
+    gtk_text_iter_forward_to_line_end (&end);
+  
+  line->text = gtk_text_buffer_get_text (priv->buffer, &start, &end, TRUE);
+  line->tokens = g_array_new (FALSE, FALSE, sizeof (JavaToken));
+  line->start_state = state;
+  line->end_state = lex (line->text, strlen (line->text), state, line->tokens);
+  line->dirty = FALSE;
+  
+  index_line (lexer, line, TRUE);
+}
+
+static State
+lex (const gchar *text, 
+     gint         length, 
+     State        state, 
+     GArray      *tokens)
+{
+  gint i = 0;
+  
+  if (state == STATE_BLOCK_COMMENT || state == STATE_TEXT_BLOCK)
+    {
+      i = find_end (text, length, 0, state == STATE_BLOCK_COMMENT ? "*/" : "\"\"\"");
+      add_token (tokens, state == STATE_BLOCK_COMMENT ? JAVA_TOKEN_COMMENT : JAVA_TOKEN_STRING, 
+                 0, i < 0 ? length : i);
+      if (i < 0)
+        return state;
+    }
+  
+  while (i < length)
+    {
+      guchar ch = text[i];
+      Class class = ch < 128 ? classes[ch] : CLASS_LETTER;
+      gint j = i + 1;
+      
+      switch (class)
+        {
+        case CLASS_SPACE:
+          i = j;
+          continue;
+          
+        case CLASS_LETTER:
+          while (j < length && ((guchar) text[j] >= 128 || 
+                 classes[(guchar) text[j]] == CLASS_LETTER || 
+                 classes[(guchar) text[j]] == CLASS_DIGIT))
+            j++;
+          add_token (tokens, is_keyword (text + i, j - i) ? 
+                     JAVA_TOKEN_KEYWORD : JAVA_TOKEN_IDENTIFIER, i, j - i);
+          break;
+          
+        case CLASS_DOT:
+          if (j >= length || (guchar) text[j] >= 128 || classes[(guchar) text[j]] != CLASS_DIGIT)
+            {
+              add_token (tokens, JAVA_TOKEN_OPERATOR, i, 1);
+              break;
+            }
+          /* fall through, a number such as .5 */
+          
+        case CLASS_DIGIT:
+          while (j < length && (guchar) text[j] < 128 && 
+                 (classes[(guchar) text[j]] == CLASS_LETTER || 
+                  classes[(guchar) text[j]] == CLASS_DIGIT || 
+                  classes[(guchar) text[j]] == CLASS_DOT))
+            j++;
+          add_token (tokens, JAVA_TOKEN_NUMBER, i, j - i);
+          break;
+          
+        case CLASS_QUOTE:
+          if (strncmp (text + i, "\"\"\"", 3) == 0)
+            {
+              j = find_end (text, length, i + 3, "\"\"\"");
+              add_token (tokens, JAVA_TOKEN_STRING, i, (j < 0 ? length : j) - i);
+              if (j < 0)
+                return STATE_TEXT_BLOCK;
+              break;
+            }
+          j = find_quote (text, length, j, '"');
+          add_token (tokens, JAVA_TOKEN_STRING, i, j - i);
+          break;
+          
+        case CLASS_APOSTROPHE:
+          j = find_quote (text, length, j, '\'');
+          add_token (tokens, JAVA_TOKEN_CHARACTER, i, j - i);
+          break;
+          
+        case CLASS_SLASH:
+          if (j < length && text[j] == '/')
+            {
+              j = length;
+              add_token (tokens, JAVA_TOKEN_COMMENT, i, j - i);
+              break;
+            }
+          if (j < length && text[j] == '*')
+            {
+              j = find_end (text, length, j + 1, "*/");
+              add_token (tokens, JAVA_TOKEN_COMMENT, i, (j < 0 ? length : j) - i);
+              if (j < 0)
+                return STATE_BLOCK_COMMENT;
+              break;
+            }
+          add_token (tokens, JAVA_TOKEN_OPERATOR, i, 1);
+          break;
+          
+        default:
+          add_token (tokens, JAVA_TOKEN_OPERATOR, i, 1);
+          break;
+        }
+      
+      i = j;
+    }
+  
+  return STATE_CODE;
+}
+
+static gboolean
+is_keyword (const gchar *text, 
+            gint         length)
+{
+  gchar word[MAX_KEYWORD_LENGTH + 1];
+  
+  if (length > MAX_KEYWORD_LENGTH)
+    return FALSE;
+  
+  memcpy (word, text, length);
+  word[length] = '\0';
+  
+  return g_hash_table_contains (keywords, word);
+}
+
+/*
+ * Returns the index right after the end marker, or -1 when the marker is 
+ * not on this line. Escapes only count inside of text blocks.
+ */
+static gint
+find_end (const gchar *text, 
+          gint         length, 
+          gint         i, 
+          const gchar *end)
+{
+  gint end_length = strlen (end);
+  
+  for (; i + end_length <= length; i++)
+    {
+      if (text[i] == '\\' && end[0] == '"')
+        {
+          i++;
+          continue;
+        }
+      if (strncmp (text + i, end, end_length) == 0)
+        return i + end_length;
+    }
+  
+  return -1;
+}
+
+/*
+ * Returns the index right after the closing quote, or the end of the line 
+ * when the literal is not closed.
+ */
+static gint
+find_quote (const gchar *text, 
+            gint         length, 
+            gint         i, 
+            gchar        quote)
+{
+  for (; i < length; i++)
+    {
+      if (text[i] == '\\')
+        i++;
+      else if (text[i] == quote)
+        return i + 1;
+    }
+  
+  return length;
+}
+
+static void
+add_token (GArray        *tokens, 
+           JavaTokenType  type, 
+           gint           index, 
+           gint           length)
+{
+  JavaToken token;
+  token.type = type;
+  token.index = index;
+  token.length = length;
+  g_array_append_val (tokens, token);
+}
+
+static void
+index_line (JavaLexer *lexer, 
+            Line      *line, 
+            gboolean   add)
+{
+  JavaLexerPrivate *priv;
+  priv = JAVA_LEXER_GET_PRIVATE (lexer);
+  
+  index_tokens (priv->identifiers, line->text, line->tokens, add);
+  
+  if (priv->shared != NULL)
+    index_tokens (priv->shared, line->text, line->tokens, add);
+}
+
+/*
+ * Adds or removes the identifiers on the line, leaving out the members 
+ * that follow a dot since those are not words in this file's scope.
+ */
+static void
+index_tokens (JavaIdentifiers *identifiers, 
+              const gchar     *text, 
+              GArray          *tokens, 
+              gboolean         add)
+{
+  guint i;
+  
+  for (i = 0; i < tokens->len; i++)
+    {
+      JavaToken *token = &g_array_index (tokens, JavaToken, i);
+      JavaToken *prev;
+      
+      if (token->type != JAVA_TOKEN_IDENTIFIER)
+        continue;
+      
+      if (i > 0)
+        {
+          prev = &g_array_index (tokens, JavaToken, i - 1);
+          if (prev->type == JAVA_TOKEN_OPERATOR && text[prev->index] == '.')
+            continue;
+        }
+      
+      if (add)
+        java_identifiers_add (identifiers, text + token->index, token->length);
+      else
+        java_identifiers_remove (identifiers, text + token->index, token->length);
+    }
+}
+
+static void
+clear_line (JavaLexer *lexer, 
+            Line      *line)
+{
+  if (line->tokens != NULL)
+    index_line (lexer, line, FALSE);
+  
+  if (line->text != NULL)
+    {
+      g_free (line->text);
+      line->text = NULL;
+    }
+  
+  if (line->tokens != NULL)
+    {
+      g_array_free (line->tokens, TRUE);
+      line->tokens = NULL;
+    }
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __JAVA_LEXER_H__
+#define	__JAVA_LEXER_H__
+
+#include <gtk/gtk.h>
+#include "java-identifiers.h"
+
+G_BEGIN_DECLS
+
+#define JAVA_LEXER_TYPE            (java_lexer_get_type ())
+#define JAVA_LEXER(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), JAVA_LEXER_TYPE, JavaLexer))
+#define JAVA_LEXER_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), JAVA_LEXER_TYPE, JavaLexerClass))
+#define IS_JAVA_LEXER(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), JAVA_LEXER_TYPE))
+#define IS_JAVA_LEXER_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), JAVA_LEXER_TYPE))
+
+typedef struct _JavaLexer JavaLexer;
+typedef struct _JavaLexerClass JavaLexerClass;
+
+struct _JavaLexer
+{
+  GObject parent_instance;
+};
+
+struct _JavaLexerClass
+{
+  GObjectClass parent_class;
+};
+
+typedef enum
+{
+  JAVA_TOKEN_IDENTIFIER,
+  JAVA_TOKEN_KEYWORD,
+  JAVA_TOKEN_NUMBER,
+  JAVA_TOKEN_STRING,
+  JAVA_TOKEN_CHARACTER,
+  JAVA_TOKEN_COMMENT,
+  JAVA_TOKEN_OPERATOR
+} JavaTokenType;
+
+/* 
+ * The index and length are in bytes, relative to the start of the line 
+ * the token is on. Operators are always one character long.
+ */
+typedef struct
+{
+  JavaTokenType type;
+  gint          index;
+  gint          length;
+} JavaToken;
+
+GType java_lexer_get_type (void) G_GNUC_CONST;
+
+JavaLexer*        java_lexer_get                (GtkTextBuffer   *buffer);
+
+gint              java_lexer_get_line_count     (JavaLexer       *lexer);
+GArray*           java_lexer_get_tokens         (JavaLexer       *lexer, 
+                                                 gint             line);
+const gchar*      java_lexer_get_text           (JavaLexer       *lexer, 
+                                                 gint             line);
+gboolean          java_lexer_token_equals       (JavaLexer       *lexer, 
+                                                 gint             line, 
+                                                 JavaToken       *token, 
+                                                 const gchar     *text);
+JavaIdentifiers*  java_lexer_get_identifiers    (JavaLexer       *lexer);
+void              java_lexer_share_identifiers  (JavaLexer       *lexer, 
+                                                 JavaIdentifiers *shared);
+void              java_lexer_scan               (const gchar     *text, 
+                                                 JavaIdentifiers *identifiers);
+
+G_END_DECLS
+
+#endif /* __JAVA_LEXER_H__ */
@@ -0,0 +1,1243 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+#include "java-matcher.h"
+#include "java-lexer.h"
+
+/*
+ * Matches class names against what was typed, and ranks the matches. 
+ * A class name matches when the pattern is a prefix of it, when it picks 
+ * out the humps of the name such as HSR for HttpServletRequest, or when 
+ * its characters appear in the name in order.
+ *
+ * The humps of every name and a mask of the characters in it are worked 
+ * out once when the name is added, so that most names are turned away by 
+ * the mask alone and the rest only walk their humps.
+ *
+ * A pattern of three or more characters also matches anywhere inside a 
+ * name, and a pattern such as util.Str matches the classes of the packages 
+ * that contain util. So that not every name has to be looked at, the names 
+ * are indexed by their first letter, by the three letter runs in them and 
+ * by their package. The index is brought up to date by the first find 
+ * after names were added.
+ *
+ * Typing more of the same pattern only narrows what matched before, so 
+ * the names that matched the last pattern are kept and looked at instead 
+ * of the index.
+ *
+ * Better matches come first, and within those the classes that are 
+ * imported, in the same package, were used lately, or are often picked.
+ */
+
+#define MAX_HUMPS 32
+#define MAX_SEGMENTS 32
+
+#define EXACT_SCORE 1000
+#define PREFIX_SCORE 900
+#define CASELESS_PREFIX_SCORE 800
+#define HUMP_SCORE 600
+#define MIN_HUMP_SCORE 400
+#define SUBSTRING_HUMP_SCORE 500
+#define SUBSTRING_SCORE 350
+#define FUZZY_SCORE 300
+#define MIN_FUZZY_SCORE 100
+
+#define IMPORTED_BONUS 80
+#define PACKAGE_BONUS 60
+#define RECENT_BONUS 50
+#define USED_BONUS 25
+#define RECENT_USES 10
+#define FREQUENCY_BONUS 10
+#define MAX_FREQUENCY_BONUS 100
+
+#define TRIGRAM_LENGTH 3
+
+typedef struct
+{
+  JavaMatch    match;
+  const gchar *package;
+  gint         length;
+  guint64      mask;
+  guint64      hump_bits;
+  guint8       humps[MAX_HUMPS];
+  guint8       hump_count;
+} Entry;
+
+typedef struct
+{
+  Entry *entry;
+  gint   score;
+} Scored;
+
+static void java_matcher_class_init  (JavaMatcherClass *klass);
+static void java_matcher_init        (JavaMatcher      *matcher);
+static void java_matcher_finalize    (JavaMatcher      *matcher);
+
+static Entry* add_entry              (JavaMatcher      *matcher, 
+                                      const gchar      *simple_class_name, 
+                                      const gchar      *class_name);
+static guint64 get_mask              (const gchar      *text);
+static void index_humps              (Entry            *entry);
+static gint get_segments             (const gchar      *pattern, 
+                                      gint             *segments);
+static gint match_entry              (Entry            *entry, 
+                                      const gchar      *pattern, 
+                                      gint              pattern_length, 
+                                      gint             *segments, 
+                                      gint              segment_count);
+static gboolean match_humps          (Entry            *entry, 
+                                      const gchar      *pattern, 
+                                      gint              pattern_length, 
+                                      gint             *segments, 
+                                      gint              segment_count, 
+                                      gint              segment, 
+                                      gint              hump, 
+                                      gint             *skipped);
+static gint match_fuzzy              (Entry            *entry, 
+                                      const gchar      *pattern);
+static gint match_substring          (Entry            *entry, 
+                                      const gchar      *pattern, 
+                                      gint              pattern_length);
+static void update_index             (JavaMatcher      *matcher);
+static guint get_trigram             (const gchar      *text);
+static void add_posting              (GHashTable       *table, 
+                                      gpointer          key, 
+                                      guint             index);
+static GArray* get_candidates        (JavaMatcher      *matcher, 
+                                      const gchar      *pattern, 
+                                      gint              pattern_length);
+static void find_unqualified         (JavaMatcher      *matcher, 
+                                      const gchar      *pattern, 
+                                      GArray           *scored);
+static gboolean find_narrowed        (JavaMatcher      *matcher, 
+                                      const gchar      *pattern, 
+                                      GArray           *scored);
+static void set_last                 (JavaMatcher      *matcher, 
+                                      const gchar      *pattern, 
+                                      GArray           *scored);
+static void find_qualified           (JavaMatcher      *matcher, 
+                                      const gchar      *package, 
+                                      const gchar      *pattern, 
+                                      GArray           *scored);
+static gint score_entry              (JavaMatcher      *matcher, 
+                                      Entry            *entry, 
+                                      const gchar      *pattern, 
+                                      gint              pattern_length, 
+                                      gint             *segments, 
+                                      gint              segment_count, 
+                                      guint64           mask);
+static gboolean contains_caseless    (const gchar      *text, 
+                                      const gchar      *pattern);
+static gint get_bonus                (JavaMatcher      *matcher, 
+                                      Entry            *entry);
+static gchar* read_statement         (JavaLexer        *lexer, 
+                                      gint              line, 
+                                      guint             index);
+static gint compare_scored           (Scored           *scored1, 
+                                      Scored           *scored2);
+static void free_entry               (Entry            *entry);
+static void free_postings            (GArray           *postings);
+
+#define JAVA_MATCHER_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), JAVA_MATCHER_TYPE, JavaMatcherPrivate))
+
+typedef struct _JavaMatcherPrivate JavaMatcherPrivate;
+
+struct _JavaMatcherPrivate
+{
+  GPtrArray    *entries;
+  GStringChunk *strings;
+  GArray       *initials[G_MAXUINT8 + 1];
+  GHashTable   *trigrams;
+  gboolean      substrings;
+  GHashTable   *packages;
+  guint         indexed;
+  gchar        *last_pattern;
+  GPtrArray    *last_entries;
+  gchar        *package;
+  GHashTable   *imports;
+  GHashTable   *wildcards;
+  GHashTable   *uses;
+  guint         tick;
+  JavaRanking  *ranking;
+};
+
+G_DEFINE_TYPE (JavaMatcher, java_matcher, G_TYPE_OBJECT)
+
+static void 
+java_matcher_class_init (JavaMatcherClass *klass)
+{
+  G_OBJECT_CLASS (klass)->finalize = (GObjectFinalizeFunc) java_matcher_finalize;
+  g_type_class_add_private (klass, sizeof (JavaMatcherPrivate));
+}
+
+static void
+java_matcher_init (JavaMatcher *matcher)
+{
+  JavaMatcherPrivate *priv;
+  priv = JAVA_MATCHER_GET_PRIVATE (matcher);
+  priv->entries = g_ptr_array_new_with_free_func ((GDestroyNotify) free_entry);
+  priv->strings = g_string_chunk_new (4096);
+  memset (priv->initials, 0, sizeof (priv->initials));
+  priv->trigrams = g_hash_table_new_full (g_direct_hash, g_direct_equal, 
+                                          NULL, (GDestroyNotify) free_postings);
+  priv->packages = g_hash_table_new_full (g_direct_hash, g_direct_equal, 
+                                          NULL, (GDestroyNotify) free_postings);
+  priv->substrings = TRUE;
+  priv->indexed = 0;
+  priv->last_pattern = NULL;
+  priv->last_entries = g_ptr_array_new ();
+  priv->package = NULL;
+  priv->imports = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  priv->wildcards = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  priv->uses = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  priv->tick = 0;
+  priv->ranking = NULL;
+}
+
+static void
+java_matcher_finalize (JavaMatcher *matcher)
+{
+  JavaMatcherPrivate *priv;
+  priv = JAVA_MATCHER_GET_PRIVATE (matcher);
+  
+  java_matcher_clear (matcher);
+  
+  g_ptr_array_free (priv->entries, TRUE);
+  g_string_chunk_free (priv->strings);
+  g_hash_table_destroy (priv->trigrams);
+  g_hash_table_destroy (priv->packages);
+  g_ptr_array_free (priv->last_entries, TRUE);
+  g_free (priv->package);
+  g_hash_table_destroy (priv->imports);
+  g_hash_table_destroy (priv->wildcards);
+  g_hash_table_destroy (priv->uses);
+  
+  if (priv->ranking != NULL)
+    g_object_unref (priv->ranking);
+
+  G_OBJECT_CLASS (java_matcher_parent_class)-> finalize (G_OBJECT (matcher));
+}
+
+JavaMatcher*
+java_matcher_new (void)
+{
+  return JAVA_MATCHER (g_object_new (java_matcher_get_type (), NULL));
+}
+
+/*
+ * Takes out all of the classes. What was used lately is kept.
+ */
+void
+java_matcher_clear (JavaMatcher *matcher)
+{
+  JavaMatcherPrivate *priv;
+  gint i;
+  
+  priv = JAVA_MATCHER_GET_PRIVATE (matcher);
+  
+  g_ptr_array_set_size (priv->entries, 0);
+  g_string_chunk_clear (priv->strings);
+  
+  for (i = 0; i <= G_MAXUINT8; i++)
+    {
+      if (priv->initials[i] != NULL)
+        {
+          g_array_free (priv->initials[i], TRUE);
+          priv->initials[i] = NULL;
+        }
+    }
+  
+  g_hash_table_remove_all (priv->trigrams);
+  g_hash_table_remove_all (priv->packages);
+  priv->indexed = 0;
+  
+  set_last (matcher, NULL, NULL);
+}
+
+void
+java_matcher_add (JavaMatcher *matcher, 
+                  const gchar *simple_class_name, 
+                  const gchar *class_name, 
+                  const gchar *file_path)
+{
+  JavaMatcherPrivate *priv;
+  Entry *entry;
+  
+  priv = JAVA_MATCHER_GET_PRIVATE (matcher);
+  
+  entry = add_entry (matcher, simple_class_name, class_name);
+  
+  if (file_path != NULL)
+    entry->match.file_path = g_string_chunk_insert (priv->strings, file_path);
+}
+
+/*
+ * Adds a method, field or constant. The class name is the one of the class 
+ * joined to the name of the member, so that a pattern such as Bar.get 
+ * matches the members of Bar. Many members share a file and a detail, so 
+ * those are only kept once.
+ */
+void
+java_matcher_add_member (JavaMatcher *matcher, 
+                         const gchar *name, 
+                         const gchar *class_name, 
+                         const gchar *file_path, 
+                         const gchar *detail, 
+                         gint         line_number)
+{
+  JavaMatcherPrivate *priv;
+  Entry *entry;
+  
+  priv = JAVA_MATCHER_GET_PRIVATE (matcher);
+  
+  entry = add_entry (matcher, name, class_name);
+  
+  if (file_path != NULL)
+    entry->match.file_path = g_string_chunk_insert_const (priv->strings, file_path);
+  
+  if (detail != NULL)
+    entry->match.detail = g_string_chunk_insert_const (priv->strings, detail);
+  
+  entry->match.line_number = line_number;
+}
+
+guint
+java_matcher_get_count (JavaMatcher *matcher)
+{
+  JavaMatcherPrivate *priv;
+  priv = JAVA_MATCHER_GET_PRIVATE (matcher);
+  return priv->entries->len;
+}
+
+/*
+ * Reads the package and the imports of the buffer, so that the classes 
+ * the buffer can already see are ranked first. The packages of the 
+ * wildcard imports are kept apart, so that they can be looked up by the 
+ * package of a class as it is. A NULL buffer means no file in particular.
+ */
+void
+java_matcher_set_context (JavaMatcher   *matcher, 
+                          GtkTextBuffer *buffer)
+{
+  JavaMatcherPrivate *priv;
+  JavaLexer *lexer;
+  gint line_count;
+  gint line;
+  
+  priv = JAVA_MATCHER_GET_PRIVATE (matcher);
+  
+  g_free (priv->package);
+  priv->package = NULL;
+  g_hash_table_remove_all (priv->imports);
+  g_hash_table_remove_all (priv->wildcards);
+  
+  if (buffer == NULL)
+    return;
+  
+  lexer = java_lexer_get (buffer);
+  line_count = java_lexer_get_line_count (lexer);
+  
+  for (line = 0; line < line_count; line++)
+    {
+      GArray *tokens;
+      JavaToken *token = NULL;
+      guint i;
+      
+      tokens = java_lexer_get_tokens (lexer, line);
+      if (tokens == NULL)
+        break;
+      
+      for (i = 0; i < tokens->len; i++)
+        {
+          token = &g_array_index (tokens, JavaToken, i);
+          if (token->type != JAVA_TOKEN_COMMENT)
+            break;
+        }
+      
+      if (i == tokens->len)
+        continue;
+      
+      if (java_lexer_token_equals (lexer, line, token, "package"))
+        {
+          g_free (priv->package);
+          priv->package = read_statement (lexer, line, i + 1);
+        }
+      else if (java_lexer_token_equals (lexer, line, token, "import"))
+        {
+          gchar *import = read_statement (lexer, line, i + 1);
+          if (import != NULL && g_str_has_suffix (import, ".*"))
+            g_hash_table_add (priv->wildcards, g_strndup (import, strlen (import) - 2));
+          if (import != NULL)
+            g_hash_table_add (priv->imports, import);
+        }
+      else
+        {
+          break;
+        }
+    }
+}
+
+/*
+ * Whether names are also matched when they only contain the pattern. When 
+ * they are not, as for completion where every name already starts with 
+ * the same letter, no trigrams are indexed. Set it before adding names.
+ */
+void
+java_matcher_set_substrings (JavaMatcher *matcher, 
+                             gboolean     substrings)
+{
+  JavaMatcherPrivate *priv;
+  priv = JAVA_MATCHER_GET_PRIVATE (matcher);
+  priv->substrings = substrings;
+}
+
+/*
+ * How often each class was accepted, across sessions, adds to its rank.
+ */
+void
+java_matcher_set_ranking (JavaMatcher *matcher, 
+                          JavaRanking *ranking)
+{
+  JavaMatcherPrivate *priv;
+  priv = JAVA_MATCHER_GET_PRIVATE (matcher);
+  
+  if (priv->ranking != NULL)
+    g_object_unref (priv->ranking);
+  
+  priv->ranking = ranking != NULL ? g_object_ref (ranking) : NULL;
+}
+
+/*
+ * Remembers that the class was picked, so that it is ranked higher.
+ */
+void
+java_matcher_use (JavaMatcher *matcher, 
+                  const gchar *class_name)
+{
+  JavaMatcherPrivate *priv;
+  priv = JAVA_MATCHER_GET_PRIVATE (matcher);
+  
+  if (class_name == NULL)
+    return;
+  
+  g_hash_table_insert (priv->uses, g_strdup (class_name), GUINT_TO_POINTER (++priv->tick));
+}
+
+/*
+ * Forgets what was picked, such as when another group is opened.
+ */
+void
+java_matcher_clear_uses (JavaMatcher *matcher)
+{
+  JavaMatcherPrivate *priv;
+  priv = JAVA_MATCHER_GET_PRIVATE (matcher);
+  g_hash_table_remove_all (priv->uses);
+  priv->tick = 0;
+}
+
+/*
+ * Takes over what was picked in the other matcher, for when a new one 
+ * with the same names replaces it.
+ */
+void
+java_matcher_copy_uses (JavaMatcher *matcher, 
+                        JavaMatcher *source)
+{
+  JavaMatcherPrivate *priv;
+  JavaMatcherPrivate *source_priv;
+  GHashTableIter iter;
+  gpointer key;
+  gpointer value;
+  
+  priv = JAVA_MATCHER_GET_PRIVATE (matcher);
+  source_priv = JAVA_MATCHER_GET_PRIVATE (source);
+  
+  g_hash_table_remove_all (priv->uses);
+  
+  g_hash_table_iter_init (&iter, source_priv->uses);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    g_hash_table_insert (priv->uses, g_strdup (key), value);
+  
+  priv->tick = source_priv->tick;
+}
+
+/*
+ * Indexes the names right away rather than on the first find, so that it 
+ * can be done on the thread that added them.
+ */
+void
+java_matcher_index (JavaMatcher *matcher)
+{
+  update_index (matcher);
+}
+
+/*
+ * Returns up to limit matches for the pattern, best first. The list holds 
+ * JavaMatch pointers that belong to the matcher, free with g_list_free.
+ */
+GList*
+java_matcher_find (JavaMatcher *matcher, 
+                   const gchar *pattern, 
+                   guint        limit)
+{
+  GList *results = NULL;
+  GArray *scored;
+  const gchar *dot;
+  guint i;
+  
+  if (*pattern == '\0')
+    return NULL;
+  
+  update_index (matcher);
+  
+  scored = g_array_new (FALSE, FALSE, sizeof (Scored));
+  
+  dot = strrchr (pattern, '.');
+  if (dot != NULL && dot != pattern)
+    {
+      gchar *package = g_strndup (pattern, dot - pattern);
+      find_qualified (matcher, package, dot + 1, scored);
+      g_free (package);
+    }
+  else
+    {
+      find_unqualified (matcher, dot != NULL ? dot + 1 : pattern, scored);
+    }
+  
+  g_array_sort (scored, (GCompareFunc) compare_scored);
+  
+  for (i = MIN (scored->len, limit); i > 0; i--)
+    results = g_list_prepend (results, &g_array_index (scored, Scored, i - 1).entry->match);
+  
+  g_array_free (scored, TRUE);
+  
+  return results;
+}
+
+/*
+ * The names that start with the first letter of the pattern are matched 
+ * in every way, the others only when they contain the pattern, and those 
+ * come out of the trigram index.
+ */
+static void
+find_unqualified (JavaMatcher *matcher, 
+                  const gchar *pattern, 
+                  GArray      *scored)
+{
+  JavaMatcherPrivate *priv;
+  GArray *initials;
+  GArray *candidates;
+  gint segments[MAX_SEGMENTS];
+  gint segment_count;
+  gint pattern_length;
+  guint64 mask;
+  guchar initial;
+  guint i;
+  
+  priv = JAVA_MATCHER_GET_PRIVATE (matcher);
+  
+  pattern_length = strlen (pattern);
+  if (pattern_length == 0)
+    return;
+  
+  if (find_narrowed (matcher, pattern, scored))
+    return;
+  
+  mask = get_mask (pattern);
+  segment_count = get_segments (pattern, segments);
+  initial = g_ascii_tolower (pattern[0]);
+  
+  initials = priv->initials[initial];
+  for (i = 0; initials != NULL && i < initials->len; i++)
+    {
+      Entry *entry = g_ptr_array_index (priv->entries, g_array_index (initials, guint, i));
+      Scored match;
+      
+      match.score = score_entry (matcher, entry, pattern, pattern_length, 
+                                 segments, segment_count, mask);
+      if (match.score == 0)
+        continue;
+      
+      match.entry = entry;
+      g_array_append_val (scored, match);
+    }
+  
+  candidates = get_candidates (matcher, pattern, pattern_length);
+  for (i = 0; candidates != NULL && i < candidates->len; i++)
+    {
+      Entry *entry = g_ptr_array_index (priv->entries, g_array_index (candidates, guint, i));
+      Scored match;
+      
+      if ((guchar) g_ascii_tolower (entry->match.simple_class_name[0]) == initial)
+        continue;
+      
+      if ((mask & ~entry->mask) != 0)
+        continue;
+      
+      match.score = match_substring (entry, pattern, pattern_length);
+      if (match.score == 0)
+        continue;
+      
+      match.entry = entry;
+      match.score += get_bonus (matcher, entry);
+      g_array_append_val (scored, match);
+    }
+  
+  set_last (matcher, pattern, scored);
+}
+
+/*
+ * Whatever matches a pattern also matches the start of it, as long as the 
+ * start was long enough to match inside of names. So when the pattern 
+ * only adds to the last one, just the names that matched the last one are 
+ * looked at again.
+ */
+static gboolean
+find_narrowed (JavaMatcher *matcher, 
+               const gchar *pattern, 
+               GArray      *scored)
+{
+  JavaMatcherPrivate *priv;
+  gint segments[MAX_SEGMENTS];
+  gint segment_count;
+  gint pattern_length;
+  guint64 mask;
+  guint i;
+  
+  priv = JAVA_MATCHER_GET_PRIVATE (matcher);
+  
+  if (priv->last_pattern == NULL || 
+      (priv->substrings && strlen (priv->last_pattern) < TRIGRAM_LENGTH) || 
+      !g_str_has_prefix (pattern, priv->last_pattern))
+    return FALSE;
+  
+  pattern_length = strlen (pattern);
+  mask = get_mask (pattern);
+  segment_count = get_segments (pattern, segments);
+  
+  for (i = 0; i < priv->last_entries->len; i++)
+    {
+      Entry *entry = g_ptr_array_index (priv->last_entries, i);
+      Scored match;
+      
+      match.score = score_entry (matcher, entry, pattern, pattern_length, 
+                                 segments, segment_count, mask);
+      if (match.score == 0)
+        continue;
+      
+      match.entry = entry;
+      g_array_append_val (scored, match);
+    }
+  
+  set_last (matcher, pattern, scored);
+  
+  return TRUE;
+}
+
+/*
+ * Remembers what matched the pattern, or forgets it when the pattern is 
+ * NULL.
+ */
+static void
+set_last (JavaMatcher *matcher, 
+          const gchar *pattern, 
+          GArray      *scored)
+{
+  JavaMatcherPrivate *priv;
+  guint i;
+  
+  priv = JAVA_MATCHER_GET_PRIVATE (matcher);
+  
+  if (priv->last_pattern == NULL && pattern == NULL)
+    return;
+  
+  g_free (priv->last_pattern);
+  priv->last_pattern = g_strdup (pattern);
+  g_ptr_array_set_size (priv->last_entries, 0);
+  
+  if (scored == NULL)
+    return;
+  
+  for (i = 0; i < scored->len; i++)
+    g_ptr_array_add (priv->last_entries, g_array_index (scored, Scored, i).entry);
+}
+
+/*
+ * Only the classes of the packages that contain the package part are 
+ * looked at, all of them when nothing follows the last dot. There are far 
+ * fewer packages than classes, so they are all checked.
+ */
+static void
+find_qualified (JavaMatcher *matcher, 
+                const gchar *package, 
+                const gchar *pattern, 
+                GArray      *scored)
+{
+  JavaMatcherPrivate *priv;
+  GHashTableIter iter;
+  gpointer key;
+  gpointer value;
+  gint segments[MAX_SEGMENTS];
+  gint segment_count;
+  gint pattern_length;
+  guint64 mask;
+  
+  priv = JAVA_MATCHER_GET_PRIVATE (matcher);
+  
+  pattern_length = strlen (pattern);
+  mask = get_mask (pattern);
+  segment_count = get_segments (pattern, segments);
+  
+  g_hash_table_iter_init (&iter, priv->packages);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      GArray *postings = value;
+      guint i;
+      
+      if (!contains_caseless (key, package))
+        continue;
+      
+      for (i = 0; i < postings->len; i++)
+        {
+          Entry *entry = g_ptr_array_index (priv->entries, g_array_index (postings, guint, i));
+          Scored match;
+          
+          if (pattern_length == 0)
+            match.score = FUZZY_SCORE + get_bonus (matcher, entry);
+          else
+            match.score = score_entry (matcher, entry, pattern, pattern_length, 
+                                       segments, segment_count, mask);
+          if (match.score == 0)
+            continue;
+          
+          match.entry = entry;
+          g_array_append_val (scored, match);
+        }
+    }
+}
+
+static gint
+score_entry (JavaMatcher *matcher, 
+             Entry       *entry, 
+             const gchar *pattern, 
+             gint         pattern_length, 
+             gint        *segments, 
+             gint         segment_count, 
+             guint64      mask)
+{
+  gint score = 0;
+  
+  if ((mask & ~entry->mask) != 0)
+    return 0;
+  
+  if (g_ascii_tolower (entry->match.simple_class_name[0]) == g_ascii_tolower (pattern[0]))
+    score = match_entry (entry, pattern, pattern_length, segments, segment_count);
+  
+  if (score == 0 && pattern_length >= TRIGRAM_LENGTH)
+    score = match_substring (entry, pattern, pattern_length);
+  
+  if (score == 0)
+    return 0;
+  
+  return score + get_bonus (matcher, entry);
+}
+
+/*
+ * The names that may contain the pattern are the ones in the shortest 
+ * list of all its trigrams. Returns NULL when the pattern is too short to 
+ * have any.
+ */
+static GArray*
+get_candidates (JavaMatcher *matcher, 
+                const gchar *pattern, 
+                gint         pattern_length)
+{
+  JavaMatcherPrivate *priv;
+  GArray *shortest = NULL;
+  gint i;
+  
+  priv = JAVA_MATCHER_GET_PRIVATE (matcher);
+  
+  for (i = 0; i + TRIGRAM_LENGTH <= pattern_length; i++)
+    {
+      GArray *postings;
+      
+      postings = g_hash_table_lookup (priv->trigrams, 
+                                      GUINT_TO_POINTER (get_trigram (pattern + i)));
+      if (postings == NULL)
+        return NULL;
+      
+      if (shortest == NULL || postings->len < shortest->len)
+        shortest = postings;
+    }
+  
+  return shortest;
+}
+
+/*
+ * Indexes the names that were added since the last time.
+ */
+static void
+update_index (JavaMatcher *matcher)
+{
+  JavaMatcherPrivate *priv;
+  
+  priv = JAVA_MATCHER_GET_PRIVATE (matcher);
+  
+  for (; priv->indexed < priv->entries->len; priv->indexed++)
+    {
+      Entry *entry = g_ptr_array_index (priv->entries, priv->indexed);
+      const gchar *name = entry->match.simple_class_name;
+      guchar initial;
+      gint i;
+      
+      initial = g_ascii_tolower (name[0]);
+      if (priv->initials[initial] == NULL)
+        priv->initials[initial] = g_array_new (FALSE, FALSE, sizeof (guint));
+      g_array_append_val (priv->initials[initial], priv->indexed);
+      
+      for (i = 0; priv->substrings && i + TRIGRAM_LENGTH <= entry->length; i++)
+        add_posting (priv->trigrams, GUINT_TO_POINTER (get_trigram (name + i)), priv->indexed);
+      
+      if (entry->package != NULL)
+        add_posting (priv->packages, (gpointer) entry->package, priv->indexed);
+    }
+}
+
+/*
+ * Three characters packed into one number, regardless of case.
+ */
+static guint
+get_trigram (const gchar *text)
+{
+  return ((guint) (guchar) g_ascii_tolower (text[0]) << 16) | 
+         ((guint) (guchar) g_ascii_tolower (text[1]) << 8) | 
+         (guint) (guchar) g_ascii_tolower (text[2]);
+}
+
+/*
+ * The names are indexed in order, so a name that has the same trigram 
+ * twice is already the last one in the list.
+ */
+static void
+add_posting (GHashTable *table, 
+             gpointer    key, 
+             guint       index)
+{
+  GArray *postings;
+  
+  postings = g_hash_table_lookup (table, key);
+  if (postings == NULL)
+    {
+      postings = g_array_sized_new (FALSE, FALSE, sizeof (guint), 4);
+      g_hash_table_insert (table, key, postings);
+    }
+  else if (g_array_index (postings, guint, postings->len - 1) == index)
+    {
+      return;
+    }
+  
+  g_array_append_val (postings, index);
+}
+
+static Entry*
+add_entry (JavaMatcher *matcher, 
+           const gchar *simple_class_name, 
+           const gchar *class_name)
+{
+  JavaMatcherPrivate *priv;
+  Entry *entry;
+  
+  priv = JAVA_MATCHER_GET_PRIVATE (matcher);
+  
+  set_last (matcher, NULL, NULL);
+  
+  entry = g_slice_new0 (Entry);
+  entry->match.simple_class_name = g_string_chunk_insert_const (priv->strings, simple_class_name);
+  entry->length = strlen (simple_class_name);
+  entry->mask = get_mask (simple_class_name);
+  index_humps (entry);
+  
+  if (class_name != NULL)
+    {
+      const gchar *dot;
+      
+      entry->match.class_name = g_string_chunk_insert (priv->strings, class_name);
+      
+      dot = strrchr (class_name, '.');
+      if (dot != NULL)
+        {
+          gchar *package = g_strndup (class_name, dot - class_name);
+          entry->package = g_string_chunk_insert_const (priv->strings, package);
+          g_free (package);
+        }
+    }
+  
+  g_ptr_array_add (priv->entries, entry);
+  
+  return entry;
+}
+
+/*
+ * One bit per letter, regardless of case, and one per digit. Everything 
+ * else shares the bits at the top.
+ */
+static guint64
+get_mask (const gchar *text)
+{
+  guint64 mask = 0;
+  
+  for (; *text != '\0'; text++)
+    {
+      guchar ch = *text;
+      
+      if (g_ascii_isalpha (ch))
+        mask |= G_GUINT64_CONSTANT (1) << (g_ascii_tolower (ch) - 'a');
+      else if (g_ascii_isdigit (ch))
+        mask |= G_GUINT64_CONSTANT (1) << (26 + ch - '0');
+      else if (ch == '_')
+        mask |= G_GUINT64_CONSTANT (1) << 36;
+      else if (ch == '$')
+        mask |= G_GUINT64_CONSTANT (1) << 37;
+      else
+        mask |= G_GUINT64_CONSTANT (1) << 38;
+    }
+  
+  return mask;
+}
+
+/*
+ * A hump starts at the beginning of the name, at an upper case letter that 
+ * follows a lower case one or starts a new word after an acronym, at the 
+ * first of a run of digits, and after an underscore.
+ */
+static void
+index_humps (Entry *entry)
+{
+  const gchar *name = entry->match.simple_class_name;
+  gint i;
+  
+  for (i = 0; i < entry->length && i < G_MAXUINT8 && entry->hump_count < MAX_HUMPS; i++)
+    {
+      guchar ch = name[i];
+      guchar prev = i > 0 ? name[i - 1] : '\0';
+      gboolean hump;
+      
+      if (i == 0)
+        hump = TRUE;
+      else if (g_ascii_isupper (ch))
+        hump = !g_ascii_isupper (prev) || g_ascii_islower (name[i + 1]);
+      else if (g_ascii_isdigit (ch))
+        hump = !g_ascii_isdigit (prev);
+      else
+        hump = prev == '_' && g_ascii_isalnum (ch);
+      
+      if (hump)
+        {
+          entry->humps[entry->hump_count++] = i;
+          if (i < 64)
+            entry->hump_bits |= G_GUINT64_CONSTANT (1) << i;
+        }
+    }
+}
+
+/*
+ * Splits the pattern where each hump should start: at its upper case 
+ * letters and its digits.
+ */
+static gint
+get_segments (const gchar *pattern, 
+              gint        *segments)
+{
+  gint count = 0;
+  gint i;
+  
+  for (i = 0; pattern[i] != '\0' && count < MAX_SEGMENTS; i++)
+    {
+      if (i == 0 || g_ascii_isupper (pattern[i]) || 
+          (g_ascii_isdigit (pattern[i]) && !g_ascii_isdigit (pattern[i - 1])))
+        segments[count++] = i;
+    }
+  
+  return count;
+}
+
+static gint
+match_entry (Entry       *entry, 
+             const gchar *pattern, 
+             gint         pattern_length, 
+             gint        *segments, 
+             gint         segment_count)
+{
+  const gchar *name = entry->match.simple_class_name;
+  gint skipped = 0;
+  
+  if (pattern_length <= entry->length)
+    {
+      if (strncmp (name, pattern, pattern_length) == 0)
+        return pattern_length == entry->length ? EXACT_SCORE : PREFIX_SCORE;
+      
+      if (g_ascii_strncasecmp (name, pattern, pattern_length) == 0)
+        return CASELESS_PREFIX_SCORE;
+    }
+  
+  if (segment_count > 1 && 
+      match_humps (entry, pattern, pattern_length, segments, segment_count, 0, 0, &skipped))
+    return MAX (HUMP_SCORE - 10 * skipped - (entry->hump_count - segment_count), MIN_HUMP_SCORE);
+  
+  return match_fuzzy (entry, pattern);
+}
+
+/*
+ * Each segment of the pattern has to start a hump of the name, in order, 
+ * with the first one on the first hump. A segment can skip humps, so HR 
+ * matches HttpServletRequest as well, but it can not run into the next 
+ * hump. Backs up and tries a later hump when the rest does not match.
+ */
+static gboolean
+match_humps (Entry       *entry, 
+             const gchar *pattern, 
+             gint         pattern_length, 
+             gint        *segments, 
+             gint         segment_count, 
+             gint         segment, 
+             gint         hump, 
+             gint        *skipped)
+{
+  const gchar *name = entry->match.simple_class_name;
+  const gchar *text;
+  gint length;
+  gint h;
+  
+  if (segment == segment_count)
+    return TRUE;
+  
+  text = pattern + segments[segment];
+  length = (segment + 1 < segment_count ? segments[segment + 1] : pattern_length) - segments[segment];
+  
+  for (h = hump; h < entry->hump_count; h++)
+    {
+      gint start = entry->humps[h];
+      gint end = h + 1 < entry->hump_count ? entry->humps[h + 1] : entry->length;
+      
+      if (segment == 0 && h > 0)
+        break;
+      
+      if (start + length > end || 
+          g_ascii_strncasecmp (name + start, text, length) != 0)
+        continue;
+      
+      if (match_humps (entry, pattern, pattern_length, segments, 
+                       segment_count, segment + 1, h + 1, skipped))
+        {
+          *skipped += h - hump;
+          return TRUE;
+        }
+    }
+  
+  return FALSE;
+}
+
+/*
+ * The characters of the pattern have to appear in the name in order, 
+ * starting with the first one. Gaps cost and landing on a hump helps.
+ */
+static gint
+match_fuzzy (Entry       *entry, 
+             const gchar *pattern)
+{
+  const gchar *name = entry->match.simple_class_name;
+  gint score = FUZZY_SCORE;
+  gint i = 0;
+  gint j;
+  
+  if (g_ascii_tolower (name[0]) != g_ascii_tolower (pattern[0]))
+    return 0;
+  
+  for (j = 1; pattern[j] != '\0'; j++)
+    {
+      gint k = i + 1;
+      
+      while (k < entry->length && g_ascii_tolower (name[k]) != g_ascii_tolower (pattern[j]))
+        k++;
+      
+      if (k >= entry->length)
+        return 0;
+      
+      if (k > i + 1)
+        score -= 10;
+      
+      if (k < 64 && (entry->hump_bits & (G_GUINT64_CONSTANT (1) << k)))
+        score += 5;
+      
+      i = k;
+    }
+  
+  return MAX (score, MIN_FUZZY_SCORE);
+}
+
+/*
+ * The pattern appears somewhere in the name, which is better when it 
+ * starts a hump, such as Map in HashMap.
+ */
+static gint
+match_substring (Entry       *entry, 
+                 const gchar *pattern, 
+                 gint         pattern_length)
+{
+  const gchar *name = entry->match.simple_class_name;
+  gint i;
+  
+  for (i = 0; i + pattern_length <= entry->length; i++)
+    {
+      if (g_ascii_strncasecmp (name + i, pattern, pattern_length) != 0)
+        continue;
+      
+      if (i < 64 && (entry->hump_bits & (G_GUINT64_CONSTANT (1) << i)))
+        return SUBSTRING_HUMP_SCORE;
+      
+      return SUBSTRING_SCORE;
+    }
+  
+  return 0;
+}
+
+static gboolean
+contains_caseless (const gchar *text, 
+                   const gchar *pattern)
+{
+  gsize length = strlen (pattern);
+  
+  for (; *text != '\0'; text++)
+    {
+      if (g_ascii_strncasecmp (text, pattern, length) == 0)
+        return TRUE;
+    }
+  
+  return length == 0;
+}
+
+static gint
+get_bonus (JavaMatcher *matcher, 
+           Entry       *entry)
+{
+  JavaMatcherPrivate *priv;
+  const gchar *class_name;
+  gint bonus = 0;
+  guint tick;
+  
+  priv = JAVA_MATCHER_GET_PRIVATE (matcher);
+  
+  class_name = entry->match.class_name;
+  if (class_name == NULL)
+    return 0;
+  
+  if (g_hash_table_contains (priv->imports, class_name))
+    {
+      bonus += IMPORTED_BONUS;
+    }
+  else if (entry->package != NULL && 
+           g_hash_table_contains (priv->wildcards, entry->package))
+    {
+      bonus += IMPORTED_BONUS;
+    }
+  
+  if (priv->package != NULL && g_strcmp0 (priv->package, entry->package) == 0)
+    bonus += PACKAGE_BONUS;
+  
+  tick = GPOINTER_TO_UINT (g_hash_table_lookup (priv->uses, class_name));
+  if (tick > 0)
+    bonus += priv->tick - tick < RECENT_USES ? RECENT_BONUS : USED_BONUS;
+  
+  if (priv->ranking != NULL)
+    bonus += MIN (java_ranking_get_count (priv->ranking, JAVA_RANKING_CLASS, class_name) * FREQUENCY_BONUS, 
+                  MAX_FREQUENCY_BONUS);
+  
+  return bonus;
+}
+
+/*
+ * Joins the names of a package or import statement, starting at the token 
+ * after the keyword, such as java.util.* out of import java.util.*;
+ */
+static gchar*
+read_statement (JavaLexer *lexer, 
+                gint       line, 
+                guint      index)
+{
+  GArray *tokens;
+  const gchar *text;
+  GString *string;
+  
+  tokens = java_lexer_get_tokens (lexer, line);
+  text = java_lexer_get_text (lexer, line);
+  if (tokens == NULL)
+    return NULL;
+  
+  string = g_string_new ("");
+  
+  for (; index < tokens->len; index++)
+    {
+      JavaToken *token = &g_array_index (tokens, JavaToken, index);
+      
+      if (token->type == JAVA_TOKEN_COMMENT || 
+          java_lexer_token_equals (lexer, line, token, "static"))
+        continue;
+      
+      if (java_lexer_token_equals (lexer, line, token, ";"))
+        break;
+      
+      g_string_append_len (string, text + token->index, token->length);
+    }
+  
+  if (string->len == 0)
+    {
+      g_string_free (string, TRUE);
+      return NULL;
+    }
+  
+  return g_string_free (string, FALSE);
+}
+
+static gint
+compare_scored (Scored *scored1, 
+                Scored *scored2)
+{
+  if (scored1->score != scored2->score)
+    return scored1->score > scored2->score ? -1 : 1;
+  
+  if (scored1->entry->length != scored2->entry->length)
+    return scored1->entry->length < scored2->entry->length ? -1 : 1;
+  
+  return g_strcmp0 (scored1->entry->match.simple_class_name, 
+                    scored2->entry->match.simple_class_name);
+}
+
+static void
+free_entry (Entry *entry)
+{
+  g_slice_free (Entry, entry);
+}
+
+static void
+free_postings (GArray *postings)
+{
+  g_array_free (postings, TRUE);
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __JAVA_MATCHER_H__
+#define	__JAVA_MATCHER_H__
+
+#include <gtk/gtk.h>
+#include "java-ranking.h"
+
+G_BEGIN_DECLS
+
+#define JAVA_MATCHER_TYPE            (java_matcher_get_type ())
+#define JAVA_MATCHER(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), JAVA_MATCHER_TYPE, JavaMatcher))
+#define JAVA_MATCHER_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), JAVA_MATCHER_TYPE, JavaMatcherClass))
+#define IS_JAVA_MATCHER(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), JAVA_MATCHER_TYPE))
+#define IS_JAVA_MATCHER_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), JAVA_MATCHER_TYPE))
+
+typedef struct _JavaMatcher JavaMatcher;
+typedef struct _JavaMatcherClass JavaMatcherClass;
+
+struct _JavaMatcher
+{
+  GObject parent_instance;
+};
+
+struct _JavaMatcherClass
+{
+  GObjectClass parent_class;
+};
+
+/* 
+ * A class that matched. The strings belong to the matcher and are good 
+ * until it is cleared. The class name and file path can be NULL, and the 
+ * detail is only there for members.
+ */
+typedef struct
+{
+  const gchar *simple_class_name;
+  const gchar *class_name;
+  const gchar *file_path;
+  const gchar *detail;
+  gint         line_number;
+} JavaMatch;
+
+GType java_matcher_get_type (void) G_GNUC_CONST;
+
+JavaMatcher*  java_matcher_new            (void);
+
+void          java_matcher_clear          (JavaMatcher   *matcher);
+void          java_matcher_add            (JavaMatcher   *matcher, 
+                                           const gchar   *simple_class_name, 
+                                           const gchar   *class_name, 
+                                           const gchar   *file_path);
+void          java_matcher_add_member     (JavaMatcher   *matcher, 
+                                           const gchar   *name, 
+                                           const gchar   *class_name, 
+                                           const gchar   *file_path, 
+                                           const gchar   *detail, 
+                                           gint           line_number);
+guint         java_matcher_get_count      (JavaMatcher   *matcher);
+void          java_matcher_set_context    (JavaMatcher   *matcher, 
+                                           GtkTextBuffer *buffer);
+void          java_matcher_set_substrings (JavaMatcher   *matcher, 
+                                           gboolean       substrings);
+void          java_matcher_set_ranking    (JavaMatcher   *matcher, 
+                                           JavaRanking   *ranking);
+void          java_matcher_use            (JavaMatcher   *matcher, 
+                                           const gchar   *class_name);
+void          java_matcher_clear_uses     (JavaMatcher   *matcher);
+void          java_matcher_copy_uses      (JavaMatcher   *matcher, 
+                                           JavaMatcher   *source);
+void          java_matcher_index          (JavaMatcher   *matcher);
+GList*        java_matcher_find           (JavaMatcher   *matcher, 
+                                           const gchar   *pattern, 
+                                           guint          limit);
+
+G_END_DECLS
+
+#endif /* __JAVA_MATCHER_H__ */
@@ -35,9 +35,12 @@ static void debug_test_file_action  (JavaMenu      *menu);
 static void attach_debugger_action  (JavaMenu      *menu);
 static void navigate_action      (JavaMenu      *menu);
 static void search_action     (JavaMenu      *menu);
+static void symbol_search_action    (JavaMenu      *menu);
 static void import_action     (JavaMenu      *menu);
+static void organize_imports_action (JavaMenu      *menu);
 static void index_projects_action   (JavaMenu      *menu);
 static void index_libs_action       (JavaMenu      *menu);
+static void index_report_action     (JavaMenu      *menu);
 static void method_usage_action     (JavaMenu      *menu);
 static void properties_action       (JavaMenu      *menu);
                                         
@@ -51,9 +54,12 @@ enum
   ATTACH_DEBUGGER,
   NAVIGATE,
   IMPORT,
+  ORGANIZE_IMPORTS,
   SEARCH,
+  SYMBOL_SEARCH,
   INDEX_PRODUCTS,
   INDEX_LIBS,
+  INDEX_REPORT,
   METHOD_USAGE,
   PROPERTIES,
   LAST_SIGNAL
@@ -130,6 +136,14 @@ java_menu_class_init (JavaMenuClass *klass)
                   NULL, NULL, 
                   g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
 
+  java_menu_signals[SYMBOL_SEARCH] =
+    g_signal_new ("symbol-search", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (JavaMenuClass, symbol_search),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
+
   java_menu_signals[IMPORT] =
     g_signal_new ("import", 
                   G_TYPE_FROM_CLASS (klass),
@@ -138,6 +152,14 @@ java_menu_class_init (JavaMenuClass *klass)
                   NULL, NULL, 
                   g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
 
+  java_menu_signals[ORGANIZE_IMPORTS] =
+    g_signal_new ("organize-imports", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (JavaMenuClass, organize_imports),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
+
   java_menu_signals[INDEX_PRODUCTS] =
     g_signal_new ("index-projects", 
                   G_TYPE_FROM_CLASS (klass),
@@ -154,6 +176,14 @@ java_menu_class_init (JavaMenuClass *klass)
                   NULL, NULL, 
                   g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
 
+  java_menu_signals[INDEX_REPORT] =
+    g_signal_new ("index-report", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (JavaMenuClass, index_report),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
+
   java_menu_signals[METHOD_USAGE] =
     g_signal_new ("method-usage", 
                   G_TYPE_FROM_CLASS (klass),
@@ -214,9 +244,12 @@ add_menu_items (JavaMenu      *menu,
   GtkWidget *attach_debugger_item;
   GtkWidget *navigate_item;
   GtkWidget *search_item;
+  GtkWidget *symbol_search_item;
   GtkWidget *import_item;
+  GtkWidget *organize_imports_item;
   GtkWidget *index_projects_item;
   GtkWidget *index_libs_item;
+  GtkWidget *index_report_item;
   GtkWidget *method_usage_item;
   GtkWidget *properties_item;
   GtkWidget *separator_item;
@@ -266,11 +299,21 @@ add_menu_items (JavaMenu      *menu,
                               accel_group, GDK_KEY_E, GDK_CONTROL_MASK, GTK_ACCEL_VISIBLE);  
   gtk_menu_shell_append (GTK_MENU_SHELL (submenu), search_item);
 
+  symbol_search_item = codeslayer_menu_item_new_with_label ("Symbol Search");
+  gtk_widget_add_accelerator (symbol_search_item, "activate", 
+                              accel_group, GDK_KEY_E, GDK_CONTROL_MASK | GDK_SHIFT_MASK, GTK_ACCEL_VISIBLE);  
+  gtk_menu_shell_append (GTK_MENU_SHELL (submenu), symbol_search_item);
+
   import_item = codeslayer_menu_item_new_with_label ("Import");
   gtk_widget_add_accelerator (import_item, "activate", 
                               accel_group, GDK_KEY_I, GDK_CONTROL_MASK, GTK_ACCEL_VISIBLE);  
   gtk_menu_shell_append (GTK_MENU_SHELL (submenu), import_item);
 
+  organize_imports_item = codeslayer_menu_item_new_with_label ("Organize Imports");
+  gtk_widget_add_accelerator (organize_imports_item, "activate", 
+                              accel_group, GDK_KEY_O, GDK_CONTROL_MASK | GDK_SHIFT_MASK, GTK_ACCEL_VISIBLE);  
+  gtk_menu_shell_append (GTK_MENU_SHELL (submenu), organize_imports_item);
+
   separator_item = gtk_separator_menu_item_new ();
   gtk_menu_shell_append (GTK_MENU_SHELL (submenu), separator_item);
   
@@ -280,6 +323,9 @@ add_menu_items (JavaMenu      *menu,
   index_libs_item = codeslayer_menu_item_new_with_label ("Index Libs");
   gtk_menu_shell_append (GTK_MENU_SHELL (submenu), index_libs_item);
 
+  index_report_item = codeslayer_menu_item_new_with_label ("Index Report");
+  gtk_menu_shell_append (GTK_MENU_SHELL (submenu), index_report_item);
+
   separator_item = gtk_separator_menu_item_new ();
   gtk_menu_shell_append (GTK_MENU_SHELL (submenu), separator_item);
   
@@ -316,15 +362,24 @@ add_menu_items (JavaMenu      *menu,
   g_signal_connect_swapped (G_OBJECT (search_item), "activate", 
                             G_CALLBACK (search_action), menu);
    
+  g_signal_connect_swapped (G_OBJECT (symbol_search_item), "activate", 
+                            G_CALLBACK (symbol_search_action), menu);
+   
   g_signal_connect_swapped (G_OBJECT (import_item), "activate", 
                             G_CALLBACK (import_action), menu);
    
+  g_signal_connect_swapped (G_OBJECT (organize_imports_item), "activate", 
+                            G_CALLBACK (organize_imports_action), menu);
+   
   g_signal_connect_swapped (G_OBJECT (index_projects_item), "activate", 
                             G_CALLBACK (index_projects_action), menu);
    
   g_signal_connect_swapped (G_OBJECT (index_libs_item), "activate", 
                             G_CALLBACK (index_libs_action), menu);
    
+  g_signal_connect_swapped (G_OBJECT (index_report_item), "activate", 
+                            G_CALLBACK (index_report_action), menu);
+   
   g_signal_connect_swapped (G_OBJECT (method_usage_item), "activate", 
                             G_CALLBACK (method_usage_action), menu);
    
@@ -380,12 +435,24 @@ search_action (JavaMenu *menu)
   g_signal_emit_by_name ((gpointer) menu, "search");
 }
 
+static void 
+symbol_search_action (JavaMenu *menu) 
+{
+  g_signal_emit_by_name ((gpointer) menu, "symbol-search");
+}
+
 static void 
 import_action (JavaMenu *menu) 
 {
   g_signal_emit_by_name ((gpointer) menu, "import");
 }
 
+static void 
+organize_imports_action (JavaMenu *menu) 
+{
+  g_signal_emit_by_name ((gpointer) menu, "organize-imports");
+}
+
 static void 
 index_projects_action (JavaMenu *menu) 
 {
@@ -398,6 +465,12 @@ index_libs_action (JavaMenu *menu)
   g_signal_emit_by_name ((gpointer) menu, "index-libs");
 }
 
+static void 
+index_report_action (JavaMenu *menu) 
+{
+  g_signal_emit_by_name ((gpointer) menu, "index-report");
+}
+
 static void 
 method_usage_action (JavaMenu *menu) 
 {
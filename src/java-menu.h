@@ -51,9 +51,12 @@ struct _JavaMenuClass
   void (*find_symbol) (JavaMenu *menu);
   void (*method_usage) (JavaMenu *menu);
   void (*search) (JavaMenu *menu);
+  void (*symbol_search) (JavaMenu *menu);
   void (*import) (JavaMenu *menu);
+  void (*organize_imports) (JavaMenu *menu);
   void (*index_projects) (JavaMenu *menu);
   void (*index_libs) (JavaMenu *menu);
+  void (*index_report) (JavaMenu *menu);
   void (*properties) (JavaMenu *menu);
 };
 
@@ -35,8 +35,6 @@ static gchar* get_input               (JavaNavigate      *navigate,
 static void render_output             (JavaNavigate      *navigate, 
                                        gchar             *output);
                                        
-static gchar* get_text                (GtkTextBuffer     *buffer, 
-                                       GtkTextIter        iter);
 
 #define JAVA_NAVIGATE_GET_PRIVATE(obj) \
   (G_TYPE_INSTANCE_GET_PRIVATE ((obj), JAVA_NAVIGATE_TYPE, JavaNavigatePrivate))
@@ -104,7 +102,6 @@ navigate_action (JavaNavigate *navigate)
   const gchar *file_path;
   GtkTextBuffer *buffer;
 
-  gchar *text;
   gchar *expression;
   GtkTextMark *insert_mark;
   GtkTextMark *selection_mark;
@@ -138,8 +135,7 @@ navigate_action (JavaNavigate *navigate)
 
   line_number = gtk_text_iter_get_line (&start);
   
-  text = get_text (buffer, end);
-  expression = java_utils_get_expression (text);
+  expression = java_utils_get_expression (end);
   
   input = get_input (navigate, file_path, expression, line_number);
 
@@ -155,24 +151,9 @@ navigate_action (JavaNavigate *navigate)
     }
 
   g_free (input);
-  g_free (text);
   g_free (expression);
 }
 
-static gchar*
-get_text (GtkTextBuffer *buffer, 
-          GtkTextIter    iter)
-{
-  GtkTextIter start;
-  gchar *text;
-  
-  gtk_text_buffer_get_start_iter (buffer, &start);
-  
-  text = gtk_text_buffer_get_text (buffer, &start, &iter, FALSE);
-
-  return text;
-}
-
 static gchar* 
 get_input (JavaNavigate *navigate, 
            const gchar  *file_path, 
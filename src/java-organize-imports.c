@@ -0,0 +1,1006 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <codeslayer/codeslayer-utils.h>
+#include "java-organize-imports.h"
+#include "java-utils.h"
+#include "java-client.h"
+#include "java-lexer.h"
+#include "java-tools-properties.h"
+
+/*
+ * Works out the imports of the whole file at once. The names that look 
+ * like types are taken from the tokens, the ones that no import covers 
+ * are sent to the server together, and the import block is written out 
+ * again sorted, without the imports that are not used. Only the names 
+ * that more than one class goes by are asked about.
+ */
+
+typedef struct
+{
+  const gchar   *text;
+  gint           length;
+  JavaTokenType  type;
+  gint           line;
+} Word;
+
+typedef struct
+{
+  gchar    *class_name;
+  gboolean  is_static;
+} Import;
+
+static void java_organize_imports_class_init  (JavaOrganizeImportsClass *klass);
+static void java_organize_imports_init        (JavaOrganizeImports      *organize);
+static void java_organize_imports_finalize    (JavaOrganizeImports      *organize);
+
+static void organize_action                   (JavaOrganizeImports      *organize);
+static GArray* get_words                      (JavaLexer                *lexer);
+static gboolean word_equals                   (Word                     *word, 
+                                               const gchar              *text);
+static gchar* read_statement                  (GArray                   *words, 
+                                               guint                    *i, 
+                                               gboolean                 *is_static);
+static guint read_header                      (GArray                   *words, 
+                                               gchar                   **package, 
+                                               GPtrArray                *imports, 
+                                               gint                     *start_line, 
+                                               gint                     *end_line);
+static void read_names                        (GArray                   *words, 
+                                               guint                     start, 
+                                               GHashTable               *used, 
+                                               GHashTable               *declared, 
+                                               GHashTable               *members);
+static gboolean can_rewrite                   (JavaLexer                *lexer, 
+                                               GArray                   *words, 
+                                               gint                      start_line, 
+                                               gint                      end_line, 
+                                               gboolean                 *grouped);
+static gboolean is_type_name                  (Word                     *word);
+static gchar* get_input                       (JavaOrganizeImports      *organize, 
+                                               GList                    *names);
+static GHashTable* render_output              (JavaOrganizeImports      *organize, 
+                                               gchar                    *output);
+static gboolean is_visible                    (GPtrArray                *candidates, 
+                                               const gchar              *package, 
+                                               GPtrArray                *imports);
+static gboolean choose_imports                (JavaOrganizeImports      *organize, 
+                                               GHashTable               *ambiguous, 
+                                               GPtrArray                *added);
+static gchar* get_block                       (GPtrArray                *imports, 
+                                               gboolean                  grouped);
+static gboolean same_root                     (const gchar              *class_name1, 
+                                               const gchar              *class_name2);
+static void write_block                       (GtkTextBuffer            *buffer, 
+                                               JavaLexer                *lexer, 
+                                               const gchar              *block, 
+                                               gint                      start_line, 
+                                               gint                      end_line, 
+                                               GArray                   *words);
+static gint compare_imports                   (Import                  **import1, 
+                                               Import                  **import2);
+static gint compare_strings                   (gchar                   **string1, 
+                                               gchar                   **string2);
+static void free_import                       (Import                   *import);
+
+#define JAVA_ORGANIZE_IMPORTS_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), JAVA_ORGANIZE_IMPORTS_TYPE, JavaOrganizeImportsPrivate))
+
+typedef struct _JavaOrganizeImportsPrivate JavaOrganizeImportsPrivate;
+
+struct _JavaOrganizeImportsPrivate
+{
+  CodeSlayer          *codeslayer;
+  JavaToolsProperties *tools_properties;
+  JavaClient          *client;
+};
+
+G_DEFINE_TYPE (JavaOrganizeImports, java_organize_imports, G_TYPE_OBJECT)
+
+static void 
+java_organize_imports_class_init (JavaOrganizeImportsClass *klass)
+{
+  G_OBJECT_CLASS (klass)->finalize = (GObjectFinalizeFunc) java_organize_imports_finalize;
+  g_type_class_add_private (klass, sizeof (JavaOrganizeImportsPrivate));
+}
+
+static void
+java_organize_imports_init (JavaOrganizeImports *organize) {}
+
+static void
+java_organize_imports_finalize (JavaOrganizeImports *organize)
+{
+  JavaOrganizeImportsPrivate *priv;
+  priv = JAVA_ORGANIZE_IMPORTS_GET_PRIVATE (organize);
+  
+  if (priv->client)
+    g_object_unref (priv->client);
+  
+  G_OBJECT_CLASS (java_organize_imports_parent_class)-> finalize (G_OBJECT (organize));
+}
+
+JavaOrganizeImports*
+java_organize_imports_new (CodeSlayer          *codeslayer,
+                           GtkWidget           *menu, 
+                           JavaToolsProperties *tools_properties)
+{
+  JavaOrganizeImportsPrivate *priv;
+  JavaOrganizeImports *organize;
+
+  organize = JAVA_ORGANIZE_IMPORTS (g_object_new (java_organize_imports_get_type (), NULL));
+  priv = JAVA_ORGANIZE_IMPORTS_GET_PRIVATE (organize);
+  priv->codeslayer = codeslayer;
+  priv->tools_properties = tools_properties;
+  
+  priv->client = java_client_new (codeslayer);
+
+  g_signal_connect_swapped (G_OBJECT (menu), "organize-imports",
+                            G_CALLBACK (organize_action), organize);
+
+  return organize;
+}
+
+static void
+organize_action (JavaOrganizeImports *organize)
+{
+  JavaOrganizeImportsPrivate *priv;
+  CodeSlayerEditor *editor;
+  const gchar *file_path;
+  GtkTextBuffer *buffer;
+  JavaLexer *lexer;
+  GArray *words;
+  gchar *package = NULL;
+  GPtrArray *imports;
+  GPtrArray *added;
+  GHashTable *used;
+  GHashTable *declared;
+  GHashTable *members;
+  GHashTable *ambiguous;
+  GHashTable *kept;
+  GList *unresolved = NULL;
+  GHashTableIter iter;
+  gpointer key;
+  gboolean chosen = TRUE;
+  gboolean grouped;
+  gint start_line;
+  gint end_line;
+  guint body;
+  guint i;
+
+  priv = JAVA_ORGANIZE_IMPORTS_GET_PRIVATE (organize);
+
+  editor = codeslayer_get_active_editor (priv->codeslayer);
+  if (editor == NULL)
+    return;
+    
+  file_path = codeslayer_editor_get_file_path (editor);
+  if (!g_str_has_suffix (file_path, ".java"))
+    return;
+  
+  buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (editor));
+  lexer = java_lexer_get (buffer);
+  
+  words = get_words (lexer);
+  imports = g_ptr_array_new_with_free_func ((GDestroyNotify) free_import);
+  
+  body = read_header (words, &package, imports, &start_line, &end_line);
+  
+  if (!can_rewrite (lexer, words, start_line, end_line, &grouped))
+    {
+      GtkWidget *dialog;
+      dialog =  gtk_message_dialog_new (NULL, 
+                                        GTK_DIALOG_MODAL,
+                                        GTK_MESSAGE_ERROR, GTK_BUTTONS_OK,
+                                        "There are comments or other code between the imports. Not able to organize them without losing it.");
+      gtk_dialog_run (GTK_DIALOG (dialog));
+      gtk_widget_destroy (dialog);
+      g_ptr_array_free (imports, TRUE);
+      g_array_free (words, TRUE);
+      g_free (package);
+      return;
+    }
+  
+  added = g_ptr_array_new ();
+  used = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  declared = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  members = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  ambiguous = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, 
+                                     (GDestroyNotify) g_ptr_array_unref);
+  kept = g_hash_table_new (g_str_hash, g_str_equal);
+  
+  read_names (words, body, used, declared, members);
+  
+  /* drop the imports that are not used, and the ones that are there twice. 
+     a static import is used when its member is named anywhere in the body */
+  for (i = 0; i < imports->len; )
+    {
+      Import *import = g_ptr_array_index (imports, i);
+      const gchar *dot = strrchr (import->class_name, '.');
+      const gchar *simple = dot != NULL ? dot + 1 : import->class_name;
+      
+      if (g_hash_table_contains (kept, import->class_name) || 
+          (g_strcmp0 (simple, "*") != 0 && 
+           !g_hash_table_contains (import->is_static ? members : used, simple)))
+        {
+          g_ptr_array_remove_index (imports, i);
+          continue;
+        }
+      
+      if (!import->is_static)
+        g_hash_table_remove (used, simple);
+      
+      g_hash_table_add (kept, import->class_name);
+      i++;
+    }
+  
+  g_hash_table_iter_init (&iter, used);
+  while (g_hash_table_iter_next (&iter, &key, NULL))
+    {
+      if (!g_hash_table_contains (declared, key))
+        unresolved = g_list_prepend (unresolved, key);
+    }
+  
+  if (unresolved != NULL)
+    {
+      gchar *input;
+      gchar *output;
+      GHashTable *candidates = NULL;
+      GList *list;
+      
+      input = get_input (organize, unresolved);
+      output = java_client_send (priv->client, input);
+      g_free (input);
+      
+      if (output != NULL)
+        {
+          candidates = render_output (organize, output);
+          g_free (output);
+        }
+      
+      for (list = unresolved; list != NULL && candidates != NULL; list = g_list_next (list))
+        {
+          GPtrArray *found = g_hash_table_lookup (candidates, list->data);
+          
+          if (found == NULL || is_visible (found, package, imports))
+            continue;
+          
+          if (found->len == 1)
+            g_ptr_array_add (added, g_ptr_array_index (found, 0));
+          else
+            g_hash_table_insert (ambiguous, list->data, g_ptr_array_ref (found));
+        }
+      
+      if (g_hash_table_size (ambiguous) > 0)
+        chosen = choose_imports (organize, ambiguous, added);
+      
+      if (chosen)
+        {
+          for (i = 0; i < added->len; i++)
+            {
+              Import *import = g_malloc (sizeof (Import));
+              import->class_name = g_strdup (g_ptr_array_index (added, i));
+              import->is_static = FALSE;
+              g_ptr_array_add (imports, import);
+            }
+        }
+      
+      if (candidates != NULL)
+        g_hash_table_destroy (candidates);
+      g_list_free (unresolved);
+    }
+  
+  /* a cancelled choice leaves the file as it was */
+  if (chosen)
+    {
+      gchar *block;
+      g_ptr_array_sort (imports, (GCompareFunc) compare_imports);
+      block = get_block (imports, grouped);
+      write_block (buffer, lexer, block, start_line, end_line, words);
+      g_free (block);
+    }
+  
+  g_hash_table_destroy (kept);
+  g_hash_table_destroy (ambiguous);
+  g_hash_table_destroy (members);
+  g_hash_table_destroy (declared);
+  g_hash_table_destroy (used);
+  g_ptr_array_free (added, TRUE);
+  g_ptr_array_free (imports, TRUE);
+  g_array_free (words, TRUE);
+  g_free (package);
+}
+
+/*
+ * All of the tokens in the buffer but the comments.
+ */
+static GArray*
+get_words (JavaLexer *lexer)
+{
+  GArray *words;
+  gint line_count;
+  gint line;
+  
+  words = g_array_new (FALSE, FALSE, sizeof (Word));
+  line_count = java_lexer_get_line_count (lexer);
+  
+  for (line = 0; line < line_count; line++)
+    {
+      GArray *tokens;
+      const gchar *text;
+      guint i;
+      
+      tokens = java_lexer_get_tokens (lexer, line);
+      text = java_lexer_get_text (lexer, line);
+      if (tokens == NULL)
+        break;
+      
+      for (i = 0; i < tokens->len; i++)
+        {
+          JavaToken *token = &g_array_index (tokens, JavaToken, i);
+          Word word;
+          
+          if (token->type == JAVA_TOKEN_COMMENT)
+            continue;
+          
+          word.text = text + token->index;
+          word.length = token->length;
+          word.type = token->type;
+          word.line = line;
+          g_array_append_val (words, word);
+        }
+    }
+  
+  return words;
+}
+
+static gboolean
+word_equals (Word        *word, 
+             const gchar *text)
+{
+  return strlen (text) == (gsize) word->length && 
+         strncmp (word->text, text, word->length) == 0;
+}
+
+/*
+ * Joins the words of a statement, starting at the keyword, and leaves i 
+ * on its semicolon.
+ */
+static gchar*
+read_statement (GArray   *words, 
+                guint    *i, 
+                gboolean *is_static)
+{
+  GString *string;
+  
+  string = g_string_new ("");
+  *is_static = FALSE;
+  
+  for ((*i)++; *i < words->len; (*i)++)
+    {
+      Word *word = &g_array_index (words, Word, *i);
+      
+      if (word_equals (word, ";"))
+        break;
+      
+      if (word_equals (word, "static"))
+        {
+          *is_static = TRUE;
+          continue;
+        }
+      
+      g_string_append_len (string, word->text, word->length);
+    }
+  
+  return g_string_free (string, FALSE);
+}
+
+/*
+ * Reads the package and import statements at the top of the file and 
+ * returns the index of the first word after them. The lines are set to 
+ * the first and last line of the imports, or to -1 when there are none.
+ */
+static guint
+read_header (GArray     *words, 
+             gchar     **package, 
+             GPtrArray  *imports, 
+             gint       *start_line, 
+             gint       *end_line)
+{
+  guint i;
+  
+  *start_line = -1;
+  *end_line = -1;
+  
+  for (i = 0; i < words->len; i++)
+    {
+      Word *word = &g_array_index (words, Word, i);
+      
+      if (word_equals (word, "package"))
+        {
+          gboolean is_static;
+          g_free (*package);
+          *package = read_statement (words, &i, &is_static);
+        }
+      else if (word_equals (word, "import"))
+        {
+          Import *import = g_malloc (sizeof (Import));
+          
+          if (*start_line == -1)
+            *start_line = word->line;
+          
+          import->class_name = read_statement (words, &i, &import->is_static);
+          g_ptr_array_add (imports, import);
+          
+          if (i < words->len)
+            *end_line = g_array_index (words, Word, i).line;
+        }
+      else if (!word_equals (word, ";"))
+        {
+          break;
+        }
+    }
+  
+  return i;
+}
+
+/*
+ * The lines of the imports are only written over when nothing but the 
+ * imports is on them, not even a comment, so that nothing is lost. Blank 
+ * lines between the imports mean that they are kept in groups.
+ */
+static gboolean
+can_rewrite (JavaLexer *lexer, 
+             GArray    *words, 
+             gint       start_line, 
+             gint       end_line, 
+             gboolean  *grouped)
+{
+  gboolean in_import = FALSE;
+  gint line;
+  guint i;
+  
+  *grouped = FALSE;
+  
+  if (start_line < 0)
+    return TRUE;
+  
+  for (line = start_line; line <= end_line; line++)
+    {
+      GArray *tokens = java_lexer_get_tokens (lexer, line);
+      
+      if (tokens == NULL || tokens->len == 0)
+        {
+          *grouped = TRUE;
+          continue;
+        }
+      
+      for (i = 0; i < tokens->len; i++)
+        {
+          if (g_array_index (tokens, JavaToken, i).type == JAVA_TOKEN_COMMENT)
+            return FALSE;
+        }
+    }
+  
+  for (i = 0; i < words->len; i++)
+    {
+      Word *word = &g_array_index (words, Word, i);
+      
+      if (word->line > end_line)
+        break;
+      
+      if (word_equals (word, "import"))
+        in_import = TRUE;
+      else if (!in_import && word->line >= start_line)
+        return FALSE;
+      else if (word_equals (word, ";"))
+        in_import = FALSE;
+    }
+  
+  return TRUE;
+}
+
+/*
+ * Collects the names that are used as types, which are the capitalized 
+ * identifiers that are not qualified by something in front of them, and 
+ * the names of the types that the file declares itself. The members are 
+ * all of the identifiers that are not qualified, whatever their case, for 
+ * the static imports.
+ */
+static void
+read_names (GArray     *words, 
+            guint       start, 
+            GHashTable *used, 
+            GHashTable *declared, 
+            GHashTable *members)
+{
+  guint i;
+  
+  for (i = start; i < words->len; i++)
+    {
+      Word *word = &g_array_index (words, Word, i);
+      Word *prev = i > start ? &g_array_index (words, Word, i - 1) : NULL;
+      
+      if (word->type != JAVA_TOKEN_IDENTIFIER)
+        continue;
+      
+      if (prev != NULL && word_equals (prev, "."))
+        continue;
+      
+      g_hash_table_add (members, g_strndup (word->text, word->length));
+      
+      if (!is_type_name (word))
+        continue;
+      
+      if (prev != NULL && 
+          (word_equals (prev, "class") || word_equals (prev, "interface") || 
+           word_equals (prev, "enum")))
+        g_hash_table_add (declared, g_strndup (word->text, word->length));
+      else
+        g_hash_table_add (used, g_strndup (word->text, word->length));
+    }
+}
+
+/*
+ * Type parameters such as T or K2, and constants such as MAX_SIZE, are 
+ * left out.
+ */
+static gboolean
+is_type_name (Word *word)
+{
+  gboolean lower = FALSE;
+  gboolean underscore = FALSE;
+  gint i;
+  
+  if (!g_ascii_isupper (word->text[0]))
+    return FALSE;
+  
+  for (i = 1; i < word->length; i++)
+    {
+      if (g_ascii_islower (word->text[i]))
+        lower = TRUE;
+      else if (word->text[i] == '_')
+        underscore = TRUE;
+    }
+  
+  if (lower)
+    return TRUE;
+  
+  for (i = 1; i < word->length; i++)
+    {
+      if (!g_ascii_isdigit (word->text[i]))
+        return !underscore;
+    }
+  
+  return FALSE;
+}
+
+/*
+ * All of the names go in one request, separated by commas.
+ */
+static gchar* 
+get_input (JavaOrganizeImports *organize, 
+           GList               *names)
+{
+  JavaOrganizeImportsPrivate *priv;
+  gchar *indexes_folder;
+  GString *string;
+  GList *list;
+  
+  priv = JAVA_ORGANIZE_IMPORTS_GET_PRIVATE (organize);
+  
+  indexes_folder = java_utils_get_indexes_folder (priv->codeslayer);
+  
+  string = g_string_new ("-program import -name ");
+  
+  for (list = names; list != NULL; list = g_list_next (list))
+    {
+      if (list != names)
+        g_string_append_c (string, ',');
+      g_string_append (string, list->data);
+    }
+  
+  g_string_append (string, indexes_folder);
+  g_free (indexes_folder);
+
+  return g_string_free (string, FALSE);
+}
+
+/*
+ * Returns the class names that came back, grouped by their simple name.
+ */
+static GHashTable*
+render_output (JavaOrganizeImports *organize, 
+               gchar               *output)
+{
+  JavaOrganizeImportsPrivate *priv;
+  JavaSuppressions *suppressions;
+  GHashTable *result;
+  gchar **lines;
+  gchar **tmp;
+  
+  priv = JAVA_ORGANIZE_IMPORTS_GET_PRIVATE (organize);
+  
+  result = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, 
+                                  (GDestroyNotify) g_ptr_array_unref);
+  
+  if (!codeslayer_utils_has_text (output) || 
+      g_str_has_prefix (output, "NO_RESULTS_FOUND"))
+    return result;
+  
+  suppressions = java_tools_properties_get_suppressions (priv->tools_properties);
+  lines = g_strsplit (output, "\n", -1);
+  
+  for (tmp = lines; *tmp != NULL; tmp++)
+    {
+      GPtrArray *found;
+      gchar *class_name;
+      const gchar *dot;
+      const gchar *simple;
+      gchar *tab;
+      
+      if (!codeslayer_utils_has_text (*tmp))
+        continue;
+      
+      tab = strchr (*tmp, '\t');
+      if (tab != NULL)
+        *tab = '\0';
+      
+      class_name = *tmp;
+      if (java_suppressions_match (suppressions, class_name))
+        continue;
+      
+      dot = strrchr (class_name, '.');
+      simple = dot != NULL ? dot + 1 : class_name;
+      
+      found = g_hash_table_lookup (result, simple);
+      if (found == NULL)
+        {
+          found = g_ptr_array_new_with_free_func (g_free);
+          g_hash_table_insert (result, g_strdup (simple), found);
+        }
+      g_ptr_array_add (found, g_strdup (class_name));
+    }
+  
+  g_strfreev (lines);
+  
+  return result;
+}
+
+/*
+ * A name needs no import when one of its classes is in java.lang, in the 
+ * package of the file, or in a package that is already imported with a 
+ * wildcard.
+ */
+static gboolean
+is_visible (GPtrArray   *candidates, 
+            const gchar *package, 
+            GPtrArray   *imports)
+{
+  guint i;
+  
+  for (i = 0; i < candidates->len; i++)
+    {
+      const gchar *class_name = g_ptr_array_index (candidates, i);
+      const gchar *dot = strrchr (class_name, '.');
+      gchar *candidate_package;
+      gboolean visible;
+      guint j;
+      
+      candidate_package = dot != NULL ? g_strndup (class_name, dot - class_name) : g_strdup ("");
+      visible = g_strcmp0 (candidate_package, "java.lang") == 0 || 
+                g_strcmp0 (candidate_package, package != NULL ? package : "") == 0;
+      
+      for (j = 0; j < imports->len && !visible; j++)
+        {
+          Import *import = g_ptr_array_index (imports, j);
+          if (!import->is_static && g_str_has_suffix (import->class_name, ".*") && 
+              strlen (import->class_name) == strlen (candidate_package) + 2 && 
+              g_str_has_prefix (import->class_name, candidate_package))
+            visible = TRUE;
+        }
+      
+      g_free (candidate_package);
+      
+      if (visible)
+        return TRUE;
+    }
+  
+  return FALSE;
+}
+
+/*
+ * Asks which class is meant for every name that more than one class goes 
+ * by, all in the one dialog. Returns FALSE when the dialog is cancelled.
+ */
+static gboolean
+choose_imports (JavaOrganizeImports *organize, 
+                GHashTable          *ambiguous, 
+                GPtrArray           *added)
+{
+  JavaOrganizeImportsPrivate *priv;
+  GtkWidget *dialog;
+  GtkWidget *content_area;
+  GtkWidget *grid;
+  GList *names;
+  GList *list;
+  GList *combos = NULL;
+  gboolean result;
+  gint row = 0;
+  
+  priv = JAVA_ORGANIZE_IMPORTS_GET_PRIVATE (organize);
+  
+  dialog = gtk_dialog_new_with_buttons ("Organize Imports", 
+                                        NULL,
+                                        GTK_DIALOG_MODAL,
+                                        GTK_STOCK_CANCEL, GTK_RESPONSE_CANCEL,
+                                        GTK_STOCK_OK, GTK_RESPONSE_OK,
+                                        NULL);
+  gtk_window_set_skip_taskbar_hint (GTK_WINDOW (dialog), TRUE);
+  gtk_window_set_skip_pager_hint (GTK_WINDOW (dialog), TRUE);
+  
+  content_area = gtk_dialog_get_content_area (GTK_DIALOG (dialog));
+  
+  grid = gtk_grid_new ();
+  gtk_grid_set_row_spacing (GTK_GRID (grid), 2);
+  gtk_grid_set_column_spacing (GTK_GRID (grid), 4);
+  gtk_container_set_border_width (GTK_CONTAINER (grid), 4);
+  
+  names = g_list_sort (g_hash_table_get_keys (ambiguous), (GCompareFunc) g_strcmp0);
+  
+  for (list = names; list != NULL; list = g_list_next (list))
+    {
+      GPtrArray *found = g_hash_table_lookup (ambiguous, list->data);
+      GtkWidget *label;
+      GtkWidget *combo;
+      guint i;
+      
+      label = gtk_label_new (list->data);
+      gtk_misc_set_alignment (GTK_MISC (label), 0, 0.5);
+      
+      combo = gtk_combo_box_text_new ();
+      g_ptr_array_sort (found, (GCompareFunc) compare_strings);
+      for (i = 0; i < found->len; i++)
+        gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (combo), g_ptr_array_index (found, i));
+      gtk_combo_box_set_active (GTK_COMBO_BOX (combo), 0);
+      gtk_widget_set_hexpand (combo, TRUE);
+      
+      gtk_grid_attach (GTK_GRID (grid), label, 0, row, 1, 1);
+      gtk_grid_attach (GTK_GRID (grid), combo, 1, row, 1, 1);
+      combos = g_list_append (combos, combo);
+      row++;
+    }
+  
+  gtk_box_pack_start (GTK_BOX (content_area), grid, TRUE, TRUE, 0);
+  gtk_widget_set_size_request (content_area, 500, -1);
+  gtk_widget_show_all (content_area);
+  
+  result = gtk_dialog_run (GTK_DIALOG (dialog)) == GTK_RESPONSE_OK;
+  
+  if (result)
+    {
+      for (list = names; list != NULL; list = g_list_next (list))
+        {
+          GPtrArray *found = g_hash_table_lookup (ambiguous, list->data);
+          GtkWidget *combo = g_list_nth_data (combos, g_list_position (names, list));
+          gint active = gtk_combo_box_get_active (GTK_COMBO_BOX (combo));
+          
+          if (active >= 0)
+            g_ptr_array_add (added, g_ptr_array_index (found, active));
+        }
+    }
+  
+  gtk_widget_destroy (dialog);
+  g_list_free (combos);
+  g_list_free (names);
+  
+  return result;
+}
+
+/*
+ * The imports one to a line, with the static ones in a group of their own. 
+ * When the imports were in groups, a group starts wherever the first part 
+ * of the package changes, such as from java to javax.
+ */
+static gchar*
+get_block (GPtrArray *imports, 
+           gboolean   grouped)
+{
+  GString *string;
+  gboolean in_static = FALSE;
+  const gchar *last = NULL;
+  guint i;
+  
+  string = g_string_new ("");
+  
+  for (i = 0; i < imports->len; i++)
+    {
+      Import *import = g_ptr_array_index (imports, i);
+      
+      if (import->is_static && !in_static)
+        {
+          if (i > 0)
+            g_string_append_c (string, '\n');
+          in_static = TRUE;
+        }
+      else if (grouped && !import->is_static && last != NULL && 
+               !same_root (last, import->class_name))
+        {
+          g_string_append_c (string, '\n');
+        }
+      
+      last = import->class_name;
+      
+      g_string_append_printf (string, "import %s%s;\n", 
+                              import->is_static ? "static " : "", import->class_name);
+    }
+  
+  return g_string_free (string, FALSE);
+}
+
+static gboolean
+same_root (const gchar *class_name1, 
+           const gchar *class_name2)
+{
+  gsize length = strcspn (class_name1, ".");
+  return strcspn (class_name2, ".") == length && 
+         strncmp (class_name1, class_name2, length) == 0;
+}
+
+/*
+ * Puts the block in place of the lines the imports were on, or after the 
+ * package statement when there were none. Without a package it goes after 
+ * the comment at the top of the file, such as the license. Nothing is 
+ * touched when the block is the same as before, so that the file is not 
+ * marked as changed.
+ */
+static void
+write_block (GtkTextBuffer *buffer, 
+             JavaLexer     *lexer, 
+             const gchar   *block, 
+             gint           start_line, 
+             gint           end_line, 
+             GArray        *words)
+{
+  GtkTextIter start;
+  GtkTextIter end;
+  gchar *text;
+  
+  if (start_line >= 0)
+    {
+      gtk_text_buffer_get_iter_at_line (buffer, &start, start_line);
+      gtk_text_buffer_get_iter_at_line (buffer, &end, end_line);
+      if (!gtk_text_iter_forward_line (&end))
+        gtk_text_buffer_get_end_iter (buffer, &end);
+      
+      text = gtk_text_buffer_get_text (buffer, &start, &end, FALSE);
+      if (g_strcmp0 (text, block) == 0)
+        {
+          g_free (text);
+          return;
+        }
+      g_free (text);
+      
+      gtk_text_buffer_begin_user_action (buffer);
+      gtk_text_buffer_delete (buffer, &start, &end);
+      gtk_text_buffer_insert (buffer, &start, block, -1);
+      gtk_text_buffer_end_user_action (buffer);
+      return;
+    }
+  
+  if (*block == '\0')
+    return;
+  
+  gtk_text_buffer_begin_user_action (buffer);
+  
+  if (words->len > 0 && word_equals (&g_array_index (words, Word, 0), "package"))
+    {
+      guint i;
+      
+      for (i = 0; i < words->len; i++)
+        {
+          if (word_equals (&g_array_index (words, Word, i), ";"))
+            break;
+        }
+      
+      gtk_text_buffer_get_iter_at_line (buffer, &start, 
+                                        i < words->len ? g_array_index (words, Word, i).line : 0);
+      if (!gtk_text_iter_ends_line (&start))
+        gtk_text_iter_forward_to_line_end (&start);
+      
+      text = g_strconcat ("\n\n", block, NULL);
+      text[strlen (text) - 1] = '\0';
+      gtk_text_buffer_insert (buffer, &start, text, -1);
+      g_free (text);
+    }
+  else
+    {
+      gint line_count;
+      gint line;
+      
+      line_count = java_lexer_get_line_count (lexer);
+      
+      for (line = 0; line < line_count; line++)
+        {
+          GArray *tokens = java_lexer_get_tokens (lexer, line);
+          guint i;
+          
+          if (tokens == NULL || tokens->len == 0)
+            break;
+          
+          for (i = 0; i < tokens->len; i++)
+            {
+              if (g_array_index (tokens, JavaToken, i).type != JAVA_TOKEN_COMMENT)
+                break;
+            }
+          
+          if (i < tokens->len)
+            break;
+        }
+      
+      /* a comment right above the code belongs to it, such as the class's own */
+      if (line < line_count && java_lexer_get_tokens (lexer, line) != NULL && 
+          java_lexer_get_tokens (lexer, line)->len > 0)
+        line = 0;
+      
+      if (line == 0)
+        {
+          gtk_text_buffer_get_start_iter (buffer, &start);
+          text = g_strconcat (block, "\n", NULL);
+        }
+      else if (line < line_count)
+        {
+          gtk_text_buffer_get_iter_at_line (buffer, &start, line);
+          text = g_strconcat ("\n", block, NULL);
+        }
+      else
+        {
+          gtk_text_buffer_get_end_iter (buffer, &start);
+          text = g_strconcat ("\n\n", block, NULL);
+        }
+      
+      gtk_text_buffer_insert (buffer, &start, text, -1);
+      g_free (text);
+    }
+  
+  gtk_text_buffer_end_user_action (buffer);
+}
+
+static gint
+compare_imports (Import **import1, 
+                 Import **import2)
+{
+  if ((*import1)->is_static != (*import2)->is_static)
+    return (*import1)->is_static ? 1 : -1;
+  return g_strcmp0 ((*import1)->class_name, (*import2)->class_name);
+}
+
+static gint
+compare_strings (gchar **string1, 
+                 gchar **string2)
+{
+  return g_strcmp0 (*string1, *string2);
+}
+
+static void
+free_import (Import *import)
+{
+  g_free (import->class_name);
+  g_free (import);
+}
@@ -0,0 +1,360 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <stdlib.h>
+#include <glib/gstdio.h>
+#include "java-ranking.h"
+
+/*
+ * Counts how often each method and class proposal was accepted, so that 
+ * the completion providers can put the ones that get picked first. The 
+ * counts are kept per group, in the ranking file of the indexes folder, 
+ * one line per key such as:
+ *
+ *   c<tab>12<tab>java.util.List
+ *   m<tab>3<tab>java.util.List<tab>add(E)
+ *
+ * Looking up a count is a single hash probe. Accepting a proposal only 
+ * bumps the count, and the file is written a little later on a thread 
+ * from a snapshot that is taken on the main loop. The snapshots are 
+ * written one at a time in the order they were taken, so an older one 
+ * never ends up on top of a newer one.
+ */
+
+typedef struct
+{
+  gchar *file_path;
+  gchar *contents;
+} Save;
+
+static void java_ranking_class_init  (JavaRankingClass *klass);
+static void java_ranking_init        (JavaRanking      *ranking);
+static void java_ranking_finalize    (JavaRanking      *ranking);
+
+static gchar* get_file_path          (JavaRanking      *ranking);
+static void read_file                (JavaRanking      *ranking);
+static gboolean save_timeout         (JavaRanking      *ranking);
+static Save* create_save             (JavaRanking      *ranking);
+static void write_save               (Save             *save);
+static void decay                    (GHashTable       *counts);
+
+#define RANKING_FILE "ranking"
+#define SAVE_DELAY 5
+#define MAX_KEYS 4096
+
+#define JAVA_RANKING_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), JAVA_RANKING_TYPE, JavaRankingPrivate))
+
+typedef struct _JavaRankingPrivate JavaRankingPrivate;
+
+struct _JavaRankingPrivate
+{
+  CodeSlayer  *codeslayer;
+  gchar       *file_path;
+  GHashTable  *counts[JAVA_RANKING_KINDS];
+  guint        save_id;
+  GThreadPool *saves;
+};
+
+static const gchar *kind_names[] = {"m", "c"};
+
+G_DEFINE_TYPE (JavaRanking, java_ranking, G_TYPE_OBJECT)
+
+static void 
+java_ranking_class_init (JavaRankingClass *klass)
+{
+  G_OBJECT_CLASS (klass)->finalize = (GObjectFinalizeFunc) java_ranking_finalize;
+  g_type_class_add_private (klass, sizeof (JavaRankingPrivate));
+}
+
+static void
+java_ranking_init (JavaRanking *ranking)
+{
+  JavaRankingPrivate *priv;
+  gint kind;
+  
+  priv = JAVA_RANKING_GET_PRIVATE (ranking);
+  priv->file_path = NULL;
+  priv->save_id = 0;
+  priv->saves = g_thread_pool_new ((GFunc) write_save, NULL, 1, FALSE, NULL);
+  
+  for (kind = 0; kind < JAVA_RANKING_KINDS; kind++)
+    priv->counts[kind] = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+}
+
+/*
+ * The snapshots that are queued are written first, and then the counts 
+ * that have not been written yet are written right away, since a thread 
+ * started now might not get to finish.
+ */
+static void
+java_ranking_finalize (JavaRanking *ranking)
+{
+  JavaRankingPrivate *priv;
+  gint kind;
+  
+  priv = JAVA_RANKING_GET_PRIVATE (ranking);
+  
+  g_thread_pool_free (priv->saves, FALSE, TRUE);
+  
+  if (priv->save_id != 0)
+    {
+      g_source_remove (priv->save_id);
+      write_save (create_save (ranking));
+    }
+  
+  for (kind = 0; kind < JAVA_RANKING_KINDS; kind++)
+    g_hash_table_destroy (priv->counts[kind]);
+  
+  g_free (priv->file_path);
+
+  G_OBJECT_CLASS (java_ranking_parent_class)->finalize (G_OBJECT (ranking));
+}
+
+JavaRanking*
+java_ranking_new (CodeSlayer *codeslayer)
+{
+  JavaRankingPrivate *priv;
+  JavaRanking *ranking;
+
+  ranking = JAVA_RANKING (g_object_new (java_ranking_get_type (), NULL));
+  priv = JAVA_RANKING_GET_PRIVATE (ranking);
+  priv->codeslayer = codeslayer;
+
+  return ranking;
+}
+
+/*
+ * Reads the counts of the active group, unless they are the ones that are 
+ * already loaded. The counts of the group that was active before are 
+ * written out first.
+ */
+void
+java_ranking_load (JavaRanking *ranking)
+{
+  JavaRankingPrivate *priv;
+  gchar *file_path;
+  gint kind;
+  
+  priv = JAVA_RANKING_GET_PRIVATE (ranking);
+  
+  file_path = get_file_path (ranking);
+  
+  if (g_strcmp0 (file_path, priv->file_path) == 0)
+    {
+      g_free (file_path);
+      return;
+    }
+  
+  if (priv->save_id != 0)
+    {
+      g_source_remove (priv->save_id);
+      save_timeout (ranking);
+    }
+  
+  for (kind = 0; kind < JAVA_RANKING_KINDS; kind++)
+    g_hash_table_remove_all (priv->counts[kind]);
+  
+  g_free (priv->file_path);
+  priv->file_path = file_path;
+  
+  read_file (ranking);
+}
+
+guint
+java_ranking_get_count (JavaRanking     *ranking, 
+                        JavaRankingKind  kind, 
+                        const gchar     *key)
+{
+  JavaRankingPrivate *priv;
+  priv = JAVA_RANKING_GET_PRIVATE (ranking);
+  return GPOINTER_TO_UINT (g_hash_table_lookup (priv->counts[kind], key));
+}
+
+/*
+ * Whether anything of the kind was ever accepted, so that the ranking can 
+ * be skipped altogether until then.
+ */
+gboolean
+java_ranking_has_kind (JavaRanking     *ranking, 
+                       JavaRankingKind  kind)
+{
+  JavaRankingPrivate *priv;
+  priv = JAVA_RANKING_GET_PRIVATE (ranking);
+  return g_hash_table_size (priv->counts[kind]) > 0;
+}
+
+void
+java_ranking_accept (JavaRanking     *ranking, 
+                     JavaRankingKind  kind, 
+                     const gchar     *key)
+{
+  JavaRankingPrivate *priv;
+  guint count;
+  
+  priv = JAVA_RANKING_GET_PRIVATE (ranking);
+  
+  if (priv->file_path == NULL)
+    return;
+  
+  count = GPOINTER_TO_UINT (g_hash_table_lookup (priv->counts[kind], key));
+  g_hash_table_insert (priv->counts[kind], g_strdup (key), GUINT_TO_POINTER (count + 1));
+  
+  if (priv->save_id == 0)
+    priv->save_id = g_timeout_add_seconds (SAVE_DELAY, (GSourceFunc) save_timeout, ranking);
+}
+
+static gchar*
+get_file_path (JavaRanking *ranking)
+{
+  JavaRankingPrivate *priv;
+  gchar *group_folder_path;
+  gchar *result;
+  
+  priv = JAVA_RANKING_GET_PRIVATE (ranking);
+  
+  group_folder_path = codeslayer_get_active_group_folder_path (priv->codeslayer);
+  result = g_build_filename (group_folder_path, "indexes", RANKING_FILE, NULL);
+  g_free (group_folder_path);
+  
+  return result;
+}
+
+static void
+read_file (JavaRanking *ranking)
+{
+  JavaRankingPrivate *priv;
+  gchar *contents;
+  gchar **lines;
+  gchar **line;
+  
+  priv = JAVA_RANKING_GET_PRIVATE (ranking);
+  
+  if (!g_file_get_contents (priv->file_path, &contents, NULL, NULL))
+    return;
+  
+  lines = g_strsplit (contents, "\n", -1);
+  
+  for (line = lines; *line != NULL; line++)
+    {
+      gchar **fields;
+      gint kind;
+      
+      fields = g_strsplit (*line, "\t", 3);
+      
+      if (g_strv_length (fields) == 3)
+        {
+          for (kind = 0; kind < JAVA_RANKING_KINDS; kind++)
+            {
+              if (g_strcmp0 (fields[0], kind_names[kind]) == 0)
+                {
+                  guint count = strtoul (fields[1], NULL, 10);
+                  if (count > 0)
+                    g_hash_table_insert (priv->counts[kind], g_strdup (fields[2]), 
+                                         GUINT_TO_POINTER (count));
+                }
+            }
+        }
+      
+      g_strfreev (fields);
+    }
+  
+  g_strfreev (lines);
+  g_free (contents);
+}
+
+static gboolean
+save_timeout (JavaRanking *ranking)
+{
+  JavaRankingPrivate *priv;
+  priv = JAVA_RANKING_GET_PRIVATE (ranking);
+  priv->save_id = 0;
+  g_thread_pool_push (priv->saves, create_save (ranking), NULL);
+  return FALSE;
+}
+
+/*
+ * Takes a snapshot of the counts for the thread to write. Once there are 
+ * too many keys every count is halved, which drops the ones that were 
+ * only picked once and lets the old favorites fade.
+ */
+static Save*
+create_save (JavaRanking *ranking)
+{
+  JavaRankingPrivate *priv;
+  GString *string;
+  Save *save;
+  gint kind;
+  
+  priv = JAVA_RANKING_GET_PRIVATE (ranking);
+  
+  string = g_string_new ("");
+  
+  for (kind = 0; kind < JAVA_RANKING_KINDS; kind++)
+    {
+      GHashTableIter iter;
+      gpointer key;
+      gpointer value;
+      
+      while (g_hash_table_size (priv->counts[kind]) > MAX_KEYS)
+        decay (priv->counts[kind]);
+      
+      g_hash_table_iter_init (&iter, priv->counts[kind]);
+      while (g_hash_table_iter_next (&iter, &key, &value))
+        g_string_append_printf (string, "%s\t%u\t%s\n", kind_names[kind], 
+                                GPOINTER_TO_UINT (value), (gchar*) key);
+    }
+  
+  save = g_malloc (sizeof (Save));
+  save->file_path = g_strdup (priv->file_path);
+  save->contents = g_string_free (string, FALSE);
+  
+  return save;
+}
+
+static void
+write_save (Save *save)
+{
+  gchar *folder_path;
+  
+  folder_path = g_path_get_dirname (save->file_path);
+  g_mkdir_with_parents (folder_path, 0755);
+  g_file_set_contents (save->file_path, save->contents, -1, NULL);
+  
+  g_free (folder_path);
+  g_free (save->file_path);
+  g_free (save->contents);
+  g_free (save);
+}
+
+static void
+decay (GHashTable *counts)
+{
+  GHashTableIter iter;
+  gpointer value;
+  
+  g_hash_table_iter_init (&iter, counts);
+  while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+      guint count = GPOINTER_TO_UINT (value) / 2;
+      if (count == 0)
+        g_hash_table_iter_remove (&iter);
+      else
+        g_hash_table_iter_replace (&iter, GUINT_TO_POINTER (count));
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __JAVA_RANKING_H__
+#define	__JAVA_RANKING_H__
+
+#include <gtk/gtk.h>
+#include <codeslayer/codeslayer.h>
+
+G_BEGIN_DECLS
+
+#define JAVA_RANKING_TYPE            (java_ranking_get_type ())
+#define JAVA_RANKING(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), JAVA_RANKING_TYPE, JavaRanking))
+#define JAVA_RANKING_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), JAVA_RANKING_TYPE, JavaRankingClass))
+#define IS_JAVA_RANKING(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), JAVA_RANKING_TYPE))
+#define IS_JAVA_RANKING_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), JAVA_RANKING_TYPE))
+
+typedef struct _JavaRanking JavaRanking;
+typedef struct _JavaRankingClass JavaRankingClass;
+
+struct _JavaRanking
+{
+  GObject parent_instance;
+};
+
+struct _JavaRankingClass
+{
+  GObjectClass parent_class;
+};
+
+typedef enum
+{
+  JAVA_RANKING_METHOD,
+  JAVA_RANKING_CLASS,
+  JAVA_RANKING_KINDS
+} JavaRankingKind;
+
+GType java_ranking_get_type (void) G_GNUC_CONST;
+
+JavaRanking*  java_ranking_new        (CodeSlayer      *codeslayer);
+
+void          java_ranking_load       (JavaRanking     *ranking);
+guint         java_ranking_get_count  (JavaRanking     *ranking, 
+                                       JavaRankingKind  kind, 
+                                       const gchar     *key);
+gboolean      java_ranking_has_kind   (JavaRanking     *ranking, 
+                                       JavaRankingKind  kind);
+void          java_ranking_accept     (JavaRanking     *ranking, 
+                                       JavaRankingKind  kind, 
+                                       const gchar     *key);
+
+G_END_DECLS
+
+#endif /* __JAVA_RANKING_H__ */
@@ -0,0 +1,554 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+#include "java-resolver.h"
+#include "java-lexer.h"
+
+/*
+ * Works out the declared type of a trivial receiver, which is this or a 
+ * plain variable, field or parameter name, from the tokens of the buffer 
+ * alone. It is a lightweight parse that only follows the braces, so the 
+ * declaration that is in scope at the iter wins over one that comes later 
+ * in the file or in a block that has already been closed.
+ *
+ * The type comes back as a key that means the same type in every file 
+ * where it is the same, such as java.util.List when it is imported. Names 
+ * that depend on the package or on wildcard imports carry those along.
+ *
+ * A name that the buffer has only once is the one at the iter, with no 
+ * declaration to find, so the identifiers that the lexer already counts 
+ * turn that away before the tokens are walked.
+ */
+
+typedef struct
+{
+  const gchar   *text;
+  gint           length;
+  JavaTokenType  type;
+  gint           line;
+  gint           index;
+} Word;
+
+typedef struct
+{
+  gint depth;
+  gint start;
+  gint end;
+} Declaration;
+
+static GArray* get_words            (JavaLexer   *lexer, 
+                                     GtkTextIter *iter, 
+                                     guint       *caret);
+static gboolean word_equals         (Word        *word, 
+                                     const gchar *text);
+static gboolean is_declaration      (GArray      *words, 
+                                     guint        i, 
+                                     gint        *start);
+static gint skip_generics           (GArray      *words, 
+                                     gint         i);
+static gint skip_qualifier          (GArray      *words, 
+                                     gint         i);
+static gchar* read_statement        (GArray      *words, 
+                                     guint       *i);
+static gchar* get_this_type         (GArray      *words);
+static gchar* get_key               (GArray      *words, 
+                                     gint         start, 
+                                     gint         end);
+
+static const gchar *primitives[] = {"boolean", "byte", "char", "short", "int", 
+                                    "long", "float", "double", NULL};
+
+/*
+ * Returns the key of the type of the expression at the iter, or NULL when 
+ * the expression is not trivial or its type can not be worked out here.
+ */
+gchar*
+java_resolver_get_type (GtkTextIter  iter, 
+                        const gchar *expression)
+{
+  JavaLexer *lexer;
+  GArray *words;
+  GArray *declarations;
+  gint depth = 0;
+  gint parens = 0;
+  guint caret;
+  guint i;
+  gchar *result = NULL;
+  
+  if (expression == NULL || *expression == '\0')
+    return NULL;
+  
+  for (i = 0; expression[i] != '\0'; i++)
+    {
+      if (!g_ascii_isalnum (expression[i]) && expression[i] != '_')
+        return NULL;
+    }
+  
+  lexer = java_lexer_get (gtk_text_iter_get_buffer (&iter));
+  
+  if (g_strcmp0 (expression, "this") != 0 && 
+      java_identifiers_get_count (java_lexer_get_identifiers (lexer), expression) < 2)
+    return NULL;
+  
+  words = get_words (lexer, &iter, &caret);
+  
+  if (g_strcmp0 (expression, "this") == 0)
+    {
+      result = get_this_type (words);
+      g_array_free (words, TRUE);
+      return result;
+    }
+  
+  declarations = g_array_new (FALSE, FALSE, sizeof (Declaration));
+  
+  for (i = 0; i < words->len; i++)
+    {
+      Word *word = &g_array_index (words, Word, i);
+      Declaration declaration;
+      
+      if (i == caret && declarations->len > 0)
+        break;
+      
+      if (word->type == JAVA_TOKEN_OPERATOR)
+        {
+          switch (*word->text)
+            {
+            case '{': depth++; break;
+            case '(': parens++; break;
+            case ')': if (parens > 0) parens--; break;
+            case '}': 
+              depth--;
+              while (declarations->len > 0 && 
+                     g_array_index (declarations, Declaration, declarations->len - 1).depth > depth)
+                g_array_set_size (declarations, declarations->len - 1);
+              break;
+            }
+          continue;
+        }
+      
+      if (word->type != JAVA_TOKEN_IDENTIFIER || !word_equals (word, expression))
+        continue;
+      
+      /* past the iter only the fields are still of interest */
+      if (i >= caret && (depth != 1 || parens != 0))
+        continue;
+      
+      if (!is_declaration (words, i, &declaration.start))
+        continue;
+      
+      declaration.depth = parens > 0 ? depth + 1 : depth;
+      declaration.end = i;
+      g_array_append_val (declarations, declaration);
+      
+      if (i >= caret)
+        break;
+    }
+  
+  if (declarations->len > 0)
+    {
+      Declaration *declaration;
+      declaration = &g_array_index (declarations, Declaration, declarations->len - 1);
+      result = get_key (words, declaration->start, declaration->end);
+    }
+  
+  g_array_free (declarations, TRUE);
+  g_array_free (words, TRUE);
+  
+  return result;
+}
+
+/*
+ * All of the tokens in the buffer but the comments. The caret is set to 
+ * the index of the first token at or after the iter.
+ */
+static GArray*
+get_words (JavaLexer   *lexer, 
+           GtkTextIter *iter, 
+           guint       *caret)
+{
+  GArray *words;
+  gint line_count;
+  gint iter_line;
+  gint iter_index;
+  gint line;
+  
+  words = g_array_new (FALSE, FALSE, sizeof (Word));
+  line_count = java_lexer_get_line_count (lexer);
+  iter_line = gtk_text_iter_get_line (iter);
+  iter_index = gtk_text_iter_get_line_index (iter);
+  *caret = G_MAXUINT;
+  
+  for (line = 0; line < line_count; line++)
+    {
+      GArray *tokens;
+      const gchar *text;
+      guint i;
+      
+      tokens = java_lexer_get_tokens (lexer, line);
+      text = java_lexer_get_text (lexer, line);
+      if (tokens == NULL)
+        break;
+      
+      for (i = 0; i < tokens->len; i++)
+        {
+          JavaToken *token = &g_array_index (tokens, JavaToken, i);
+          Word word;
+          
+          if (token->type == JAVA_TOKEN_COMMENT)
+            continue;
+          
+          if (*caret == G_MAXUINT && 
+              (line > iter_line || (line == iter_line && token->index >= iter_index)))
+            *caret = words->len;
+          
+          word.text = text + token->index;
+          word.length = token->length;
+          word.type = token->type;
+          word.line = line;
+          word.index = token->index;
+          g_array_append_val (words, word);
+        }
+    }
+  
+  if (*caret == G_MAXUINT)
+    *caret = words->len;
+  
+  return words;
+}
+
+static gboolean
+word_equals (Word        *word, 
+             const gchar *text)
+{
+  return strlen (text) == (gsize) word->length && 
+         strncmp (word->text, text, word->length) == 0;
+}
+
+/*
+ * Whether the name at i is being declared, as in Foo name = or 
+ * List<Foo> name; or (Foo name) and so on. The start is set to the first 
+ * token of the type.
+ */
+static gboolean
+is_declaration (GArray *words, 
+                guint   i, 
+                gint   *start)
+{
+  Word *prev;
+  Word *next;
+  const gchar **primitive;
+  gint j;
+  
+  if (i == 0 || i + 1 >= words->len)
+    return FALSE;
+  
+  next = &g_array_index (words, Word, i + 1);
+  if (next->type != JAVA_TOKEN_OPERATOR || strchr ("=;,):", *next->text) == NULL)
+    return FALSE;
+  
+  if (*next->text == '=' && i + 2 < words->len && 
+      word_equals (&g_array_index (words, Word, i + 2), "="))
+    return FALSE;
+  
+  prev = &g_array_index (words, Word, i - 1);
+  
+  if (prev->type == JAVA_TOKEN_KEYWORD)
+    {
+      for (primitive = primitives; *primitive != NULL; primitive++)
+        {
+          if (word_equals (prev, *primitive))
+            {
+              *start = i - 1;
+              return TRUE;
+            }
+        }
+      return FALSE;
+    }
+  
+  j = i - 1;
+  
+  if (word_equals (prev, "]"))
+    {
+      while (j >= 0 && (word_equals (&g_array_index (words, Word, j), "]") || 
+                        word_equals (&g_array_index (words, Word, j), "[")))
+        j--;
+      if (j < 0)
+        return FALSE;
+      prev = &g_array_index (words, Word, j);
+    }
+  
+  if (word_equals (prev, ">"))
+    {
+      j = skip_generics (words, j);
+      if (j < 0)
+        return FALSE;
+      prev = &g_array_index (words, Word, j);
+    }
+  
+  if (prev->type != JAVA_TOKEN_IDENTIFIER)
+    return FALSE;
+  
+  *start = skip_qualifier (words, j);
+  
+  return TRUE;
+}
+
+/*
+ * Moves from the closing > back to the name in front of the matching <, or 
+ * returns -1 when what is in between can not be a type argument, such as 
+ * in i < n && m > name.
+ */
+static gint
+skip_generics (GArray *words, 
+               gint    i)
+{
+  gint depth = 0;
+  
+  for (; i >= 0; i--)
+    {
+      Word *word = &g_array_index (words, Word, i);
+      
+      if (word_equals (word, ">"))
+        {
+          depth++;
+        }
+      else if (word_equals (word, "<"))
+        {
+          if (--depth == 0)
+            return i > 0 ? i - 1 : -1;
+        }
+      else if (word->type == JAVA_TOKEN_OPERATOR)
+        {
+          if (strchr (",.?[]", *word->text) == NULL)
+            return -1;
+        }
+      else if (word->type == JAVA_TOKEN_KEYWORD)
+        {
+          if (!word_equals (word, "extends") && !word_equals (word, "super"))
+            return -1;
+        }
+      else if (word->type != JAVA_TOKEN_IDENTIFIER)
+        {
+          return -1;
+        }
+    }
+  
+  return -1;
+}
+
+static gint
+skip_qualifier (GArray *words, 
+                gint    i)
+{
+  while (i >= 2 && 
+         word_equals (&g_array_index (words, Word, i - 1), ".") && 
+         g_array_index (words, Word, i - 2).type == JAVA_TOKEN_IDENTIFIER)
+    i -= 2;
+  
+  return i;
+}
+
+/*
+ * Joins the tokens of a package or import statement, starting at the token 
+ * after the keyword, and leaves i on the semicolon.
+ */
+static gchar*
+read_statement (GArray *words, 
+                guint  *i)
+{
+  GString *string;
+  
+  string = g_string_new ("");
+  
+  for ((*i)++; *i < words->len; (*i)++)
+    {
+      Word *word = &g_array_index (words, Word, *i);
+      
+      if (word_equals (word, ";"))
+        break;
+      
+      if (word_equals (word, "static"))
+        continue;
+      
+      g_string_append_len (string, word->text, word->length);
+    }
+  
+  return g_string_free (string, FALSE);
+}
+
+/*
+ * The type that this means is only certain when the file declares a single 
+ * type and no anonymous classes.
+ */
+static gchar*
+get_this_type (GArray *words)
+{
+  Word *name = NULL;
+  gchar *package = NULL;
+  gchar *result;
+  gboolean after_new = FALSE;
+  guint i;
+  
+  for (i = 0; i < words->len; i++)
+    {
+      Word *word = &g_array_index (words, Word, i);
+      
+      if (word_equals (word, "package"))
+        {
+          g_free (package);
+          package = read_statement (words, &i);
+        }
+      else if (word_equals (word, "class") || word_equals (word, "interface") || 
+               word_equals (word, "enum"))
+        {
+          if (i > 0 && word_equals (&g_array_index (words, Word, i - 1), "."))
+            continue;
+          
+          if (name != NULL || i + 1 >= words->len)
+            {
+              g_free (package);
+              return NULL;
+            }
+          
+          name = &g_array_index (words, Word, i + 1);
+        }
+      else if (word_equals (word, "new"))
+        {
+          after_new = TRUE;
+        }
+      else if (word_equals (word, ";"))
+        {
+          after_new = FALSE;
+        }
+      else if (word_equals (word, "{"))
+        {
+          if (after_new && word_equals (&g_array_index (words, Word, i - 1), ")"))
+            {
+              g_free (package);
+              return NULL;
+            }
+          after_new = FALSE;
+        }
+    }
+  
+  if (name == NULL || name->type != JAVA_TOKEN_IDENTIFIER)
+    {
+      g_free (package);
+      return NULL;
+    }
+  
+  if (package != NULL)
+    result = g_strdup_printf ("this\t%s.%.*s", package, name->length, name->text);
+  else
+    result = g_strdup_printf ("this\t%.*s", name->length, name->text);
+  
+  g_free (package);
+  
+  return result;
+}
+
+/*
+ * Builds the key of the type from start to end. A type that is imported 
+ * by name, or is written out in full, stands on its own. Anything else 
+ * could be in the package or come in through a wildcard, and a type with 
+ * arguments depends on how those resolve, so the package and the imports 
+ * are made part of the key.
+ */
+static gchar*
+get_key (GArray *words, 
+         gint    start, 
+         gint    end)
+{
+  Word *first;
+  GString *type;
+  GString *context;
+  gchar *qualified = NULL;
+  gboolean contextual = FALSE;
+  gint i;
+  guint j;
+  
+  first = &g_array_index (words, Word, start);
+  
+  if (first->type != JAVA_TOKEN_IDENTIFIER || word_equals (first, "var"))
+    return NULL;
+  
+  for (i = start; i < end; i++)
+    {
+      Word *word = &g_array_index (words, Word, i);
+      if (word_equals (word, "["))
+        return NULL;
+      if (word_equals (word, "<"))
+        contextual = TRUE;
+    }
+  
+  type = g_string_new ("");
+  for (i = start; i < end; i++)
+    {
+      Word *word = &g_array_index (words, Word, i);
+      g_string_append_len (type, word->text, word->length);
+    }
+  
+  context = g_string_new ("");
+  
+  for (j = 0; j < words->len; j++)
+    {
+      Word *word = &g_array_index (words, Word, j);
+      gchar *statement;
+      
+      if (!word_equals (word, "package") && !word_equals (word, "import"))
+        {
+          if (word->type == JAVA_TOKEN_KEYWORD || word->type == JAVA_TOKEN_IDENTIFIER)
+            break;
+          continue;
+        }
+      
+      statement = read_statement (words, &j);
+      g_string_append_printf (context, "%s;", statement);
+      
+      if (qualified == NULL && word_equals (word, "import"))
+        {
+          const gchar *dot = strrchr (statement, '.');
+          if (dot != NULL && 
+              strlen (dot + 1) == (gsize) first->length && 
+              strncmp (dot + 1, first->text, first->length) == 0)
+            qualified = g_strndup (statement, dot - statement);
+        }
+      
+      g_free (statement);
+    }
+  
+  if (qualified != NULL)
+    {
+      g_string_prepend_c (type, '.');
+      g_string_prepend (type, qualified);
+      g_free (qualified);
+    }
+  else if (!g_ascii_islower (*first->text) || start + 1 >= end || 
+           !word_equals (&g_array_index (words, Word, start + 1), "."))
+    {
+      contextual = TRUE;
+    }
+  
+  if (contextual)
+    g_string_append_printf (type, "\t%s", context->str);
+  
+  g_string_free (context, TRUE);
+  
+  return g_string_free (type, FALSE);
+}
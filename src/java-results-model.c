@@ -0,0 +1,322 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include "java-results-model.h"
+
+/*
+ * A list model over an array of matches that never changes once it is 
+ * made. The rows are not copied into the model, they are read out of the 
+ * array only when the view asks for them, and the strings are handed out 
+ * without copying either. The owner is whatever the strings belong to, 
+ * and is kept alive for as long as the model is.
+ *
+ * New results mean a new model, which is cheap compared to filling a list 
+ * store. Put in a tree view in fixed height mode, only the rows that are 
+ * visible are ever looked at.
+ */
+
+static void java_results_model_tree_model_init  (GtkTreeModelIface     *iface);
+static void java_results_model_class_init       (JavaResultsModelClass *klass);
+static void java_results_model_init             (JavaResultsModel      *model);
+static void java_results_model_finalize         (JavaResultsModel      *model);
+
+static GtkTreeModelFlags get_flags              (GtkTreeModel          *tree_model);
+static gint get_n_columns                       (GtkTreeModel          *tree_model);
+static GType get_column_type                    (GtkTreeModel          *tree_model, 
+                                                 gint                  column);
+static gboolean get_iter                        (GtkTreeModel          *tree_model, 
+                                                 GtkTreeIter           *iter, 
+                                                 GtkTreePath           *path);
+static GtkTreePath* get_path                    (GtkTreeModel          *tree_model, 
+                                                 GtkTreeIter           *iter);
+static void get_value                           (GtkTreeModel          *tree_model, 
+                                                 GtkTreeIter           *iter, 
+                                                 gint                  column, 
+                                                 GValue                *value);
+static gboolean iter_next                       (GtkTreeModel          *tree_model, 
+                                                 GtkTreeIter           *iter);
+static gboolean iter_children                   (GtkTreeModel          *tree_model, 
+                                                 GtkTreeIter           *iter, 
+                                                 GtkTreeIter           *parent);
+static gboolean iter_has_child                  (GtkTreeModel          *tree_model, 
+                                                 GtkTreeIter           *iter);
+static gint iter_n_children                     (GtkTreeModel          *tree_model, 
+                                                 GtkTreeIter           *iter);
+static gboolean iter_nth_child                  (GtkTreeModel          *tree_model, 
+                                                 GtkTreeIter           *iter, 
+                                                 GtkTreeIter           *parent, 
+                                                 gint                  n);
+static gboolean iter_parent                     (GtkTreeModel          *tree_model, 
+                                                 GtkTreeIter           *iter, 
+                                                 GtkTreeIter           *child);
+static gboolean set_iter                        (JavaResultsModel      *model, 
+                                                 GtkTreeIter           *iter, 
+                                                 gint                  index);
+
+#define JAVA_RESULTS_MODEL_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), JAVA_RESULTS_MODEL_TYPE, JavaResultsModelPrivate))
+
+typedef struct _JavaResultsModelPrivate JavaResultsModelPrivate;
+
+struct _JavaResultsModelPrivate
+{
+  GArray         *matches;
+  gint            stamp;
+  gpointer        owner;
+  GDestroyNotify  owner_destroy;
+};
+
+G_DEFINE_TYPE_EXTENDED (JavaResultsModel,
+                        java_results_model,
+                        G_TYPE_OBJECT,
+                        0,
+                        G_IMPLEMENT_INTERFACE (GTK_TYPE_TREE_MODEL,
+                                               java_results_model_tree_model_init));
+
+static void
+java_results_model_tree_model_init (GtkTreeModelIface *iface)
+{
+  iface->get_flags = get_flags;
+  iface->get_n_columns = get_n_columns;
+  iface->get_column_type = get_column_type;
+  iface->get_iter = get_iter;
+  iface->get_path = get_path;
+  iface->get_value = get_value;
+  iface->iter_next = iter_next;
+  iface->iter_children = iter_children;
+  iface->iter_has_child = iter_has_child;
+  iface->iter_n_children = iter_n_children;
+  iface->iter_nth_child = iter_nth_child;
+  iface->iter_parent = iter_parent;
+}
+
+static void 
+java_results_model_class_init (JavaResultsModelClass *klass)
+{
+  G_OBJECT_CLASS (klass)->finalize = (GObjectFinalizeFunc) java_results_model_finalize;
+  g_type_class_add_private (klass, sizeof (JavaResultsModelPrivate));
+}
+
+static void
+java_results_model_init (JavaResultsModel *model)
+{
+  JavaResultsModelPrivate *priv;
+  priv = JAVA_RESULTS_MODEL_GET_PRIVATE (model);
+  priv->matches = NULL;
+  priv->stamp = g_random_int ();
+  priv->owner = NULL;
+  priv->owner_destroy = NULL;
+}
+
+static void
+java_results_model_finalize (JavaResultsModel *model)
+{
+  JavaResultsModelPrivate *priv;
+  priv = JAVA_RESULTS_MODEL_GET_PRIVATE (model);
+  
+  if (priv->matches != NULL)
+    g_array_free (priv->matches, TRUE);
+  
+  if (priv->owner_destroy != NULL)
+    priv->owner_destroy (priv->owner);
+
+  G_OBJECT_CLASS (java_results_model_parent_class)-> finalize (G_OBJECT (model));
+}
+
+/*
+ * Takes the array of JavaMatch, which can be NULL for no rows.
+ */
+JavaResultsModel*
+java_results_model_new (GArray         *matches, 
+                        gpointer        owner, 
+                        GDestroyNotify  owner_destroy)
+{
+  JavaResultsModelPrivate *priv;
+  JavaResultsModel *model;
+
+  model = JAVA_RESULTS_MODEL (g_object_new (java_results_model_get_type (), NULL));
+  priv = JAVA_RESULTS_MODEL_GET_PRIVATE (model);
+  priv->matches = matches;
+  priv->owner = owner;
+  priv->owner_destroy = owner_destroy;
+
+  return model;
+}
+
+const JavaMatch*
+java_results_model_get_match (JavaResultsModel *model, 
+                              GtkTreeIter      *iter)
+{
+  JavaResultsModelPrivate *priv;
+  priv = JAVA_RESULTS_MODEL_GET_PRIVATE (model);
+  
+  g_return_val_if_fail (iter->stamp == priv->stamp, NULL);
+  
+  return &g_array_index (priv->matches, JavaMatch, GPOINTER_TO_INT (iter->user_data));
+}
+
+static GtkTreeModelFlags
+get_flags (GtkTreeModel *tree_model)
+{
+  return GTK_TREE_MODEL_LIST_ONLY | GTK_TREE_MODEL_ITERS_PERSIST;
+}
+
+static gint
+get_n_columns (GtkTreeModel *tree_model)
+{
+  return JAVA_RESULTS_COLUMNS;
+}
+
+static GType
+get_column_type (GtkTreeModel *tree_model, 
+                 gint          column)
+{
+  return G_TYPE_STRING;
+}
+
+static gboolean
+get_iter (GtkTreeModel *tree_model, 
+          GtkTreeIter  *iter, 
+          GtkTreePath  *path)
+{
+  if (gtk_tree_path_get_depth (path) != 1)
+    return FALSE;
+  
+  return set_iter (JAVA_RESULTS_MODEL (tree_model), iter, 
+                   gtk_tree_path_get_indices (path)[0]);
+}
+
+static GtkTreePath*
+get_path (GtkTreeModel *tree_model, 
+          GtkTreeIter  *iter)
+{
+  return gtk_tree_path_new_from_indices (GPOINTER_TO_INT (iter->user_data), -1);
+}
+
+static void
+get_value (GtkTreeModel *tree_model, 
+           GtkTreeIter  *iter, 
+           gint          column, 
+           GValue       *value)
+{
+  const JavaMatch *match;
+  
+  match = java_results_model_get_match (JAVA_RESULTS_MODEL (tree_model), iter);
+  
+  g_value_init (value, G_TYPE_STRING);
+  
+  switch (column)
+    {
+    case JAVA_RESULTS_SIMPLE_CLASS_NAME:
+      g_value_set_static_string (value, match->simple_class_name);
+      break;
+    case JAVA_RESULTS_CLASS_NAME:
+      g_value_set_static_string (value, match->class_name);
+      break;
+    case JAVA_RESULTS_FILE_PATH:
+      g_value_set_static_string (value, match->file_path);
+      break;
+    case JAVA_RESULTS_DETAIL:
+      g_value_set_static_string (value, match->detail);
+      break;
+    }
+}
+
+static gboolean
+iter_next (GtkTreeModel *tree_model, 
+           GtkTreeIter  *iter)
+{
+  return set_iter (JAVA_RESULTS_MODEL (tree_model), iter, 
+                   GPOINTER_TO_INT (iter->user_data) + 1);
+}
+
+static gboolean
+iter_children (GtkTreeModel *tree_model, 
+               GtkTreeIter  *iter, 
+               GtkTreeIter  *parent)
+{
+  if (parent != NULL)
+    return FALSE;
+  
+  return set_iter (JAVA_RESULTS_MODEL (tree_model), iter, 0);
+}
+
+static gboolean
+iter_has_child (GtkTreeModel *tree_model, 
+                GtkTreeIter  *iter)
+{
+  return FALSE;
+}
+
+static gint
+iter_n_children (GtkTreeModel *tree_model, 
+                 GtkTreeIter  *iter)
+{
+  JavaResultsModelPrivate *priv;
+  
+  if (iter != NULL)
+    return 0;
+  
+  priv = JAVA_RESULTS_MODEL_GET_PRIVATE (tree_model);
+  
+  return priv->matches != NULL ? priv->matches->len : 0;
+}
+
+static gboolean
+iter_nth_child (GtkTreeModel *tree_model, 
+                GtkTreeIter  *iter, 
+                GtkTreeIter  *parent, 
+                gint          n)
+{
+  if (parent != NULL)
+    return FALSE;
+  
+  return set_iter (JAVA_RESULTS_MODEL (tree_model), iter, n);
+}
+
+static gboolean
+iter_parent (GtkTreeModel *tree_model, 
+             GtkTreeIter  *iter, 
+             GtkTreeIter  *child)
+{
+  return FALSE;
+}
+
+/*
+ * The row is the index into the array, so an iter stays good for as long 
+ * as the model is around.
+ */
+static gboolean
+set_iter (JavaResultsModel *model, 
+          GtkTreeIter      *iter, 
+          gint              index)
+{
+  JavaResultsModelPrivate *priv;
+  priv = JAVA_RESULTS_MODEL_GET_PRIVATE (model);
+  
+  if (priv->matches == NULL || index < 0 || index >= (gint) priv->matches->len)
+    {
+      iter->stamp = 0;
+      return FALSE;
+    }
+  
+  iter->stamp = priv->stamp;
+  iter->user_data = GINT_TO_POINTER (index);
+  
+  return TRUE;
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __JAVA_RESULTS_MODEL_H__
+#define	__JAVA_RESULTS_MODEL_H__
+
+#include <gtk/gtk.h>
+#include "java-matcher.h"
+
+G_BEGIN_DECLS
+
+#define JAVA_RESULTS_MODEL_TYPE            (java_results_model_get_type ())
+#define JAVA_RESULTS_MODEL(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), JAVA_RESULTS_MODEL_TYPE, JavaResultsModel))
+#define JAVA_RESULTS_MODEL_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), JAVA_RESULTS_MODEL_TYPE, JavaResultsModelClass))
+#define IS_JAVA_RESULTS_MODEL(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), JAVA_RESULTS_MODEL_TYPE))
+#define IS_JAVA_RESULTS_MODEL_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), JAVA_RESULTS_MODEL_TYPE))
+
+typedef struct _JavaResultsModel JavaResultsModel;
+typedef struct _JavaResultsModelClass JavaResultsModelClass;
+
+struct _JavaResultsModel
+{
+  GObject parent_instance;
+};
+
+struct _JavaResultsModelClass
+{
+  GObjectClass parent_class;
+};
+
+/* the columns follow the string fields of a JavaMatch */
+enum
+{
+  JAVA_RESULTS_SIMPLE_CLASS_NAME = 0,
+  JAVA_RESULTS_CLASS_NAME,
+  JAVA_RESULTS_FILE_PATH,
+  JAVA_RESULTS_DETAIL,
+  JAVA_RESULTS_COLUMNS
+};
+
+GType java_results_model_get_type (void) G_GNUC_CONST;
+
+JavaResultsModel*  java_results_model_new        (GArray           *matches, 
+                                                  gpointer          owner, 
+                                                  GDestroyNotify    owner_destroy);
+const JavaMatch*   java_results_model_get_match  (JavaResultsModel *model, 
+                                                  GtkTreeIter      *iter);
+
+G_END_DECLS
+
+#endif /* __JAVA_RESULTS_MODEL_H__ */
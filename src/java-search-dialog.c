@@ -0,0 +1,666 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+
+#include <string.h>
+#include <codeslayer/codeslayer-utils.h>
+#include "java-search-dialog.h"
+#include "java-utils.h"
+#include "java-client.h"
+
+/*
+ * The dialog that Class Search and Symbol Search share. All of the names 
+ * are loaded once into a matcher and matched there as they are typed. What 
+ * the names are, and how they are read, is up to the search.
+ */
+
+typedef struct
+{
+  JavaSearchDialog *dialog;
+  GCancellable     *cancellable;
+  JavaSuppressions *suppressions;
+  SearchParseFunc   parse;
+  JavaMatcher      *matcher;
+} Fetch;
+
+static void java_search_dialog_class_init  (JavaSearchDialogClass *klass);
+static void java_search_dialog_init        (JavaSearchDialog      *dialog);
+static void java_search_dialog_finalize    (JavaSearchDialog      *dialog);
+
+static void create_dialog                  (JavaSearchDialog      *dialog);
+static gboolean key_release_action         (JavaSearchDialog      *dialog,
+                                            GdkEventKey           *event);
+static gboolean search_timeout             (JavaSearchDialog      *dialog);
+static void load_names                     (JavaSearchDialog      *dialog);
+static void indexes_updated_action         (JavaSearchDialog      *dialog);
+static void group_changed_action           (JavaSearchDialog      *dialog);
+static void cancel_search                  (JavaSearchDialog      *dialog);
+static void fetch_callback                 (gchar                 *output, 
+                                            Fetch                 *fetch);
+static gboolean fetch_idle                 (Fetch                 *fetch);
+static void destroy_fetch                  (Fetch                 *fetch);
+static gchar* get_input                    (JavaSearchDialog      *dialog);
+static void render_empty                   (JavaSearchDialog      *dialog);
+static void render_matches                 (JavaSearchDialog      *dialog, 
+                                            const gchar           *text);
+static void row_activated_action           (JavaSearchDialog      *dialog,
+                                            GtkTreePath           *path,
+                                            GtkTreeViewColumn     *column);
+
+#define MAX_ROWS 100000
+#define SEARCH_DELAY 150
+
+#define JAVA_SEARCH_DIALOG_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), JAVA_SEARCH_DIALOG_TYPE, JavaSearchDialogPrivate))
+
+typedef struct _JavaSearchDialogPrivate JavaSearchDialogPrivate;
+
+struct _JavaSearchDialogPrivate
+{
+  CodeSlayer          *codeslayer;
+  JavaIndexer         *indexer;
+  JavaToolsProperties *tools_properties;
+  JavaClient          *client;
+  gchar               *name;
+  gchar               *type;
+  gint                 column;
+  gint                 width;
+  SearchParseFunc      parse;
+  GtkWidget           *dialog;
+  GtkWidget           *entry;
+  GtkWidget           *tree;
+  JavaMatcher         *matcher;
+  gchar               *loaded;
+  GCancellable        *fetch;
+  guint                search_id;
+  gulong               indexes_updated_id;
+  gulong               group_changed_id;
+};
+
+enum
+{
+  EMPTY,
+  ACTIVATED,
+  LAST_SIGNAL
+};
+
+static guint java_search_dialog_signals[LAST_SIGNAL] = { 0 };
+
+G_DEFINE_TYPE (JavaSearchDialog, java_search_dialog, G_TYPE_OBJECT)
+
+static void 
+java_search_dialog_class_init (JavaSearchDialogClass *klass)
+{
+  /* nothing is typed, so the search can show something else */
+  java_search_dialog_signals[EMPTY] =
+    g_signal_new ("empty", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (JavaSearchDialogClass, empty),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
+
+  /* a row was picked, and is handed over as a JavaMatch before it is opened */
+  java_search_dialog_signals[ACTIVATED] =
+    g_signal_new ("activated", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (JavaSearchDialogClass, activated),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__POINTER, G_TYPE_NONE, 1, G_TYPE_POINTER);
+
+  G_OBJECT_CLASS (klass)->finalize = (GObjectFinalizeFunc) java_search_dialog_finalize;
+  g_type_class_add_private (klass, sizeof (JavaSearchDialogPrivate));
+}
+
+static void
+java_search_dialog_init (JavaSearchDialog *dialog)
+{
+  JavaSearchDialogPrivate *priv;
+  priv = JAVA_SEARCH_DIALOG_GET_PRIVATE (dialog);
+  priv->dialog = NULL;
+  priv->matcher = java_matcher_new ();
+  priv->loaded = NULL;
+  priv->fetch = NULL;
+  priv->search_id = 0;
+}
+
+static void
+java_search_dialog_finalize (JavaSearchDialog *dialog)
+{
+  JavaSearchDialogPrivate *priv;
+  priv = JAVA_SEARCH_DIALOG_GET_PRIVATE (dialog);
+  
+  g_signal_handler_disconnect (priv->indexer, priv->indexes_updated_id);
+  g_signal_handler_disconnect (priv->indexer, priv->group_changed_id);
+  
+  cancel_search (dialog);
+  
+  if (priv->dialog != NULL)
+    gtk_widget_destroy (priv->dialog);
+    
+  g_object_unref (priv->client);
+  g_object_unref (priv->matcher);
+  g_free (priv->loaded);
+  g_free (priv->name);
+  g_free (priv->type);
+
+  G_OBJECT_CLASS (java_search_dialog_parent_class)-> finalize (G_OBJECT (dialog));
+}
+
+/*
+ * The name is what is searched for, such as Class. The type asks the 
+ * server for something other than classes, and the names it sends back 
+ * are read with parse. The first column shows the part of the row given 
+ * by column, at the width, and the class name comes after it.
+ */
+JavaSearchDialog*
+java_search_dialog_new (CodeSlayer          *codeslayer,
+                        JavaIndexer         *indexer, 
+                        JavaToolsProperties *tools_properties, 
+                        const gchar         *name, 
+                        const gchar         *type, 
+                        gint                 column, 
+                        gint                 width, 
+                        SearchParseFunc      parse)
+{
+  JavaSearchDialogPrivate *priv;
+  JavaSearchDialog *dialog;
+
+  dialog = JAVA_SEARCH_DIALOG (g_object_new (java_search_dialog_get_type (), NULL));
+  priv = JAVA_SEARCH_DIALOG_GET_PRIVATE (dialog);
+  priv->codeslayer = codeslayer;
+  priv->indexer = indexer;
+  priv->tools_properties = tools_properties;
+  priv->name = g_strdup (name);
+  priv->type = g_strdup (type);
+  priv->column = column;
+  priv->width = width;
+  priv->parse = parse;
+  
+  priv->client = java_client_new (codeslayer);
+
+  priv->indexes_updated_id = g_signal_connect_swapped (G_OBJECT (indexer), "indexes-updated",
+                                                       G_CALLBACK (indexes_updated_action), dialog);
+
+  priv->group_changed_id = g_signal_connect_swapped (G_OBJECT (indexer), "group-changed",
+                                                     G_CALLBACK (group_changed_action), dialog);
+
+  return dialog;
+}
+
+void
+java_search_dialog_run (JavaSearchDialog *dialog)
+{
+  JavaSearchDialogPrivate *priv;
+  priv = JAVA_SEARCH_DIALOG_GET_PRIVATE (dialog);
+  
+  if (priv->dialog == NULL)
+    create_dialog (dialog);
+    
+  load_names (dialog);
+  
+  if (gtk_entry_get_text_length (GTK_ENTRY (priv->entry)) == 0)
+    render_empty (dialog);
+  
+  gtk_widget_grab_focus (priv->entry);
+  gtk_dialog_run (GTK_DIALOG (priv->dialog));
+  gtk_widget_hide (priv->dialog);
+}
+
+/*
+ * What was picked is remembered here, so that it ranks higher.
+ */
+JavaMatcher*
+java_search_dialog_get_matcher (JavaSearchDialog *dialog)
+{
+  JavaSearchDialogPrivate *priv;
+  priv = JAVA_SEARCH_DIALOG_GET_PRIVATE (dialog);
+  return priv->matcher;
+}
+
+/*
+ * Shows rows of the search's own, such as when nothing is typed. A NULL 
+ * model shows nothing.
+ */
+void
+java_search_dialog_set_model (JavaSearchDialog *dialog, 
+                              JavaResultsModel *model)
+{
+  JavaSearchDialogPrivate *priv;
+  priv = JAVA_SEARCH_DIALOG_GET_PRIVATE (dialog);
+  gtk_tree_view_set_model (GTK_TREE_VIEW (priv->tree), GTK_TREE_MODEL (model));
+}
+
+static void
+create_dialog (JavaSearchDialog *dialog)
+{
+  JavaSearchDialogPrivate *priv;
+  GtkWidget *content_area;
+  GtkWidget *vbox;
+  GtkWidget *hbox;
+  GtkWidget *label;
+  GtkWidget *scrolled_window;
+  GtkTreeViewColumn *column;
+  GtkCellRenderer *renderer;
+  gchar *text;
+  
+  priv = JAVA_SEARCH_DIALOG_GET_PRIVATE (dialog);
+
+  text = g_strconcat (priv->name, " Search", NULL);
+  priv->dialog = gtk_dialog_new_with_buttons (text, 
+                                              codeslayer_get_toplevel_window (priv->codeslayer),
+                                              GTK_DIALOG_MODAL,
+                                              GTK_STOCK_CLOSE, GTK_RESPONSE_OK,
+                                              NULL);
+  g_free (text);
+  gtk_window_set_skip_taskbar_hint (GTK_WINDOW (priv->dialog), TRUE);
+  gtk_window_set_skip_pager_hint (GTK_WINDOW (priv->dialog), TRUE);
+
+  content_area = gtk_dialog_get_content_area (GTK_DIALOG (priv->dialog));
+  
+  vbox = gtk_box_new (GTK_ORIENTATION_VERTICAL, 1);
+  gtk_box_set_homogeneous (GTK_BOX (vbox), FALSE);
+  
+  /* the completion box */
+  
+  hbox = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 2);
+  gtk_box_set_homogeneous (GTK_BOX (hbox), FALSE);
+  
+  text = g_strconcat (priv->name, ": ", NULL);
+  label = gtk_label_new (text);
+  g_free (text);
+  priv->entry = gtk_entry_new ();
+  gtk_box_pack_start (GTK_BOX (hbox), label, FALSE, FALSE, 2);
+  gtk_box_pack_start (GTK_BOX (hbox), priv->entry, TRUE, TRUE, 2);
+  
+  /* the tree view */   
+     
+  priv->tree =  gtk_tree_view_new ();
+  gtk_tree_view_set_headers_visible (GTK_TREE_VIEW (priv->tree), FALSE);
+  gtk_tree_view_set_enable_search (GTK_TREE_VIEW (priv->tree), FALSE);
+  gtk_tree_view_set_fixed_height_mode (GTK_TREE_VIEW (priv->tree), TRUE);
+
+  column = gtk_tree_view_column_new ();
+  gtk_tree_view_column_set_sizing (column, GTK_TREE_VIEW_COLUMN_FIXED);
+  gtk_tree_view_column_set_fixed_width (column, priv->width);
+  renderer = gtk_cell_renderer_text_new ();
+  gtk_tree_view_column_pack_start (column, renderer, FALSE);
+  gtk_tree_view_column_add_attribute (column, renderer, "text", priv->column);
+  gtk_tree_view_append_column (GTK_TREE_VIEW (priv->tree), column);
+  
+  column = gtk_tree_view_column_new ();
+  gtk_tree_view_column_set_sizing (column, GTK_TREE_VIEW_COLUMN_FIXED);
+  gtk_tree_view_column_set_expand (column, TRUE);
+  renderer = gtk_cell_renderer_text_new ();
+  gtk_tree_view_column_pack_start (column, renderer, FALSE);
+  gtk_tree_view_column_add_attribute (column, renderer, "text", JAVA_RESULTS_CLASS_NAME);
+  gtk_tree_view_append_column (GTK_TREE_VIEW (priv->tree), column);
+  
+  scrolled_window = gtk_scrolled_window_new (NULL, NULL);
+  gtk_scrolled_window_set_policy (GTK_SCROLLED_WINDOW (scrolled_window),
+                                  GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+  gtk_container_add (GTK_CONTAINER (scrolled_window), GTK_WIDGET (priv->tree));
+  
+  /* hook up the signals */
+  
+  g_signal_connect_swapped (G_OBJECT (priv->entry), "key-release-event",
+                            G_CALLBACK (key_release_action), dialog);
+                            
+  g_signal_connect_swapped (G_OBJECT (priv->tree), "row-activated",
+                            G_CALLBACK (row_activated_action), dialog);
+  
+  /* render everything, with the class names always getting the same room */
+  
+  gtk_widget_set_size_request (content_area, priv->width + 400, 400);
+  
+  gtk_box_pack_start (GTK_BOX (vbox), hbox, FALSE, FALSE, 0);
+  gtk_box_pack_start (GTK_BOX (vbox), scrolled_window, TRUE, TRUE, 0);
+  gtk_box_pack_start (GTK_BOX (content_area), vbox, TRUE, TRUE, 0);
+
+  gtk_widget_show_all (content_area);
+}
+
+/*
+ * Everything typed is matched here against all of the names, so that 
+ * humps, letters in between and parts of the package can be typed as well 
+ * as a prefix. Nothing is looked up until the typing pauses.
+ */
+static gboolean
+key_release_action (JavaSearchDialog *dialog,
+                    GdkEventKey      *event)
+{
+  JavaSearchDialogPrivate *priv;
+  
+  priv = JAVA_SEARCH_DIALOG_GET_PRIVATE (dialog);
+  
+  if (priv->search_id != 0)
+    {
+      g_source_remove (priv->search_id);
+      priv->search_id = 0;
+    }
+  
+  if (gtk_entry_get_text_length (GTK_ENTRY (priv->entry)) == 0)
+    {
+      render_empty (dialog);
+      return FALSE;
+    }
+  
+  priv->search_id = g_timeout_add (SEARCH_DELAY, (GSourceFunc) search_timeout, dialog);
+  
+  return FALSE;
+}
+
+/*
+ * While the names are still loading there is nothing to match, and they 
+ * are matched against the entry once they are in.
+ */
+static gboolean
+search_timeout (JavaSearchDialog *dialog)
+{
+  JavaSearchDialogPrivate *priv;
+  
+  priv = JAVA_SEARCH_DIALOG_GET_PRIVATE (dialog);
+  priv->search_id = 0;
+  
+  if (priv->fetch == NULL)
+    render_matches (dialog, gtk_entry_get_text (GTK_ENTRY (priv->entry)));
+  
+  return FALSE;
+}
+
+/*
+ * The server is asked for all of the names once, in the background, and 
+ * again only when the indexes folder is another one than they came from, 
+ * or the indexes were built again.
+ */
+static void
+load_names (JavaSearchDialog *dialog)
+{
+  JavaSearchDialogPrivate *priv;
+  gchar *indexes_folder;
+  Fetch *fetch;
+  gchar *input;
+  
+  priv = JAVA_SEARCH_DIALOG_GET_PRIVATE (dialog);
+  
+  if (priv->fetch != NULL)
+    return;
+  
+  indexes_folder = java_utils_get_indexes_folder (priv->codeslayer);
+  if (g_strcmp0 (indexes_folder, priv->loaded) == 0)
+    {
+      g_free (indexes_folder);
+      return;
+    }
+  g_free (indexes_folder);
+  
+  priv->fetch = g_cancellable_new ();
+  
+  fetch = g_malloc (sizeof (Fetch));
+  fetch->dialog = g_object_ref (dialog);
+  fetch->cancellable = g_object_ref (priv->fetch);
+  fetch->suppressions = java_tools_properties_get_suppressions (priv->tools_properties);
+  fetch->parse = priv->parse;
+  fetch->matcher = NULL;
+
+  input = get_input (dialog);
+  java_client_send_with_cancellable (priv->client, input, fetch->cancellable, 
+                                     (ClientCallbackFunc) fetch_callback, fetch);
+  g_free (input);
+}
+
+/*
+ * The names come back on the thread of the client, and are parsed and 
+ * indexed there into a matcher of their own, so that there is nothing 
+ * left to do on the main loop but to swap it in.
+ */
+static void
+fetch_callback (gchar *output, 
+                Fetch *fetch)
+{
+  if (codeslayer_utils_has_text (output) && 
+      !g_str_has_prefix (output, "NO_RESULTS_FOUND") &&
+      !g_cancellable_is_cancelled (fetch->cancellable))
+    {
+      fetch->matcher = java_matcher_new ();
+      fetch->parse (fetch->matcher, output, fetch->suppressions);
+      java_matcher_index (fetch->matcher);
+    }
+  
+  g_free (output);
+  
+  g_idle_add_full (G_PRIORITY_DEFAULT_IDLE, (GSourceFunc) fetch_idle, 
+                   fetch, (GDestroyNotify) destroy_fetch);
+}
+
+/*
+ * The names are matched against what is in the entry by now, which is 
+ * whatever was typed while they were loading. What was picked carries over 
+ * to the new matcher, and the rows that are still showing keep the old one 
+ * alive until they go.
+ */
+static gboolean
+fetch_idle (Fetch *fetch)
+{
+  JavaSearchDialogPrivate *priv;
+  
+  if (g_cancellable_is_cancelled (fetch->cancellable))
+    return FALSE;
+  
+  priv = JAVA_SEARCH_DIALOG_GET_PRIVATE (fetch->dialog);
+  
+  g_object_unref (priv->fetch);
+  priv->fetch = NULL;
+  
+  if (fetch->matcher == NULL)
+    return FALSE;
+  
+  java_matcher_copy_uses (fetch->matcher, priv->matcher);
+  g_object_unref (priv->matcher);
+  priv->matcher = g_object_ref (fetch->matcher);
+  
+  g_free (priv->loaded);
+  priv->loaded = java_utils_get_indexes_folder (priv->codeslayer);
+  
+  if (gtk_entry_get_text_length (GTK_ENTRY (priv->entry)) == 0)
+    render_empty (fetch->dialog);
+  else
+    render_matches (fetch->dialog, gtk_entry_get_text (GTK_ENTRY (priv->entry)));
+  
+  return FALSE;
+}
+
+static void
+destroy_fetch (Fetch *fetch)
+{
+  g_object_unref (fetch->dialog);
+  g_object_unref (fetch->cancellable);
+  if (fetch->matcher != NULL)
+    g_object_unref (fetch->matcher);
+  g_free (fetch);
+}
+
+/*
+ * The names are asked for again the next time the dialog is opened, or 
+ * right away if it is open now.
+ */
+static void
+indexes_updated_action (JavaSearchDialog *dialog)
+{
+  JavaSearchDialogPrivate *priv;
+  priv = JAVA_SEARCH_DIALOG_GET_PRIVATE (dialog);
+  
+  cancel_search (dialog);
+  
+  g_free (priv->loaded);
+  priv->loaded = NULL;
+  
+  if (priv->dialog != NULL && gtk_widget_get_visible (priv->dialog))
+    load_names (dialog);
+}
+
+/*
+ * What was picked in one group says nothing about another one. A matcher 
+ * that is still loading takes over the uses when it is swapped in, so it 
+ * starts out empty as well.
+ */
+static void
+group_changed_action (JavaSearchDialog *dialog)
+{
+  JavaSearchDialogPrivate *priv;
+  priv = JAVA_SEARCH_DIALOG_GET_PRIVATE (dialog);
+  java_matcher_clear_uses (priv->matcher);
+}
+
+static void
+cancel_search (JavaSearchDialog *dialog)
+{
+  JavaSearchDialogPrivate *priv;
+  priv = JAVA_SEARCH_DIALOG_GET_PRIVATE (dialog);
+  
+  if (priv->search_id != 0)
+    {
+      g_source_remove (priv->search_id);
+      priv->search_id = 0;
+    }
+  
+  if (priv->fetch == NULL)
+    return;
+  
+  g_cancellable_cancel (priv->fetch);
+  g_object_unref (priv->fetch);
+  priv->fetch = NULL;
+}
+
+/*
+ * A name of * asks for every name of the type in the indexes.
+ */
+static gchar* 
+get_input (JavaSearchDialog *dialog)
+{
+  JavaSearchDialogPrivate *priv;
+  gchar *indexes_folder;
+  gchar *result;
+  
+  priv = JAVA_SEARCH_DIALOG_GET_PRIVATE (dialog);
+  
+  indexes_folder = java_utils_get_indexes_folder (priv->codeslayer);
+  
+  if (priv->type != NULL)
+    result = g_strconcat ("-program search", 
+                          " -type ", priv->type,
+                          " -name *",
+                          indexes_folder, 
+                          NULL);
+  else
+    result = g_strconcat ("-program search", 
+                          " -name *",
+                          indexes_folder, 
+                          NULL);
+  
+  g_free (indexes_folder);
+
+  return result;
+}
+
+/*
+ * Nothing shows unless the search puts in rows of its own.
+ */
+static void
+render_empty (JavaSearchDialog *dialog)
+{
+  java_search_dialog_set_model (dialog, NULL);
+  g_signal_emit_by_name ((gpointer) dialog, "empty");
+}
+
+/*
+ * Shows the best matches, ranked against the file in the active editor. 
+ * The rows are read straight out of the matcher, and only the ones that 
+ * are on screen, so even a single letter with tens of thousands of 
+ * matches is shown right away.
+ */
+static void
+render_matches (JavaSearchDialog *dialog, 
+                const gchar      *text)
+{
+  JavaSearchDialogPrivate *priv;
+  CodeSlayerEditor *editor;
+  JavaResultsModel *model;
+  GArray *rows;
+  GList *matches;
+  GList *list;
+  
+  priv = JAVA_SEARCH_DIALOG_GET_PRIVATE (dialog);
+  
+  editor = codeslayer_get_active_editor (priv->codeslayer);
+  java_matcher_set_context (priv->matcher, editor != NULL ? 
+                            gtk_text_view_get_buffer (GTK_TEXT_VIEW (editor)) : NULL);
+  
+  matches = java_matcher_find (priv->matcher, text, MAX_ROWS);
+  
+  rows = g_array_sized_new (FALSE, FALSE, sizeof (JavaMatch), g_list_length (matches));
+  for (list = matches; list != NULL; list = g_list_next (list))
+    g_array_append_vals (rows, list->data, 1);
+  g_list_free (matches);
+  
+  model = java_results_model_new (rows, g_object_ref (priv->matcher), g_object_unref);
+  java_search_dialog_set_model (dialog, model);
+  g_object_unref (model);
+}
+
+/*
+ * Opens the file of the row, at the line when there is one.
+ */
+static void
+row_activated_action (JavaSearchDialog  *dialog,
+                      GtkTreePath       *path,
+                      GtkTreeViewColumn *column)
+{
+  JavaSearchDialogPrivate *priv;
+  GtkTreeModel *tree_model;
+  GtkTreeIter treeiter;
+  const JavaMatch *match;
+  CodeSlayerProject *project;
+  CodeSlayerDocument *document;
+  
+  priv = JAVA_SEARCH_DIALOG_GET_PRIVATE (dialog);
+
+  tree_model = gtk_tree_view_get_model (GTK_TREE_VIEW (priv->tree));
+  if (tree_model == NULL || !gtk_tree_model_get_iter (tree_model, &treeiter, path))
+    return;
+  
+  match = java_results_model_get_match (JAVA_RESULTS_MODEL (tree_model), &treeiter);
+  if (match->file_path == NULL)
+    return;
+  
+  java_matcher_use (priv->matcher, match->class_name);
+  g_signal_emit_by_name ((gpointer) dialog, "activated", match);
+  
+  document = codeslayer_document_new ();
+  project = codeslayer_get_project_by_file_path (priv->codeslayer, match->file_path);
+  codeslayer_document_set_file_path (document, match->file_path);
+  if (match->line_number > 0)
+    codeslayer_document_set_line_number (document, match->line_number);
+  codeslayer_document_set_project (document, project);
+  
+  codeslayer_select_editor (priv->codeslayer, document);
+  gtk_widget_hide (priv->dialog);
+  
+  g_object_unref (document);
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+
+#ifndef __JAVA_SEARCH_DIALOG_H__
+#define	__JAVA_SEARCH_DIALOG_H__
+
+#include <gtk/gtk.h>
+#include <codeslayer/codeslayer.h>
+#include "java-tools-properties.h"
+#include "java-indexer.h"
+#include "java-matcher.h"
+#include "java-results-model.h"
+
+G_BEGIN_DECLS
+
+#define JAVA_SEARCH_DIALOG_TYPE            (java_search_dialog_get_type ())
+#define JAVA_SEARCH_DIALOG(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), JAVA_SEARCH_DIALOG_TYPE, JavaSearchDialog))
+#define JAVA_SEARCH_DIALOG_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), JAVA_SEARCH_DIALOG_TYPE, JavaSearchDialogClass))
+#define IS_JAVA_SEARCH_DIALOG(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), JAVA_SEARCH_DIALOG_TYPE))
+#define IS_JAVA_SEARCH_DIALOG_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), JAVA_SEARCH_DIALOG_TYPE))
+
+/* 
+ * Adds the names in the output of the server to the matcher. It is called 
+ * on the thread of the client, and can cut up the output in place.
+ */
+typedef void (*SearchParseFunc) (JavaMatcher *matcher, gchar *output, JavaSuppressions *suppressions);
+
+typedef struct _JavaSearchDialog JavaSearchDialog;
+typedef struct _JavaSearchDialogClass JavaSearchDialogClass;
+
+struct _JavaSearchDialog
+{
+  GObject parent_instance;
+};
+
+struct _JavaSearchDialogClass
+{
+  GObjectClass parent_class;
+
+  void (*empty) (JavaSearchDialog *dialog);
+  void (*activated) (JavaSearchDialog *dialog, const JavaMatch *match);
+};
+
+GType java_search_dialog_get_type (void) G_GNUC_CONST;
+     
+JavaSearchDialog*  java_search_dialog_new          (CodeSlayer          *codeslayer,
+                                                    JavaIndexer         *indexer, 
+                                                    JavaToolsProperties *tools_properties, 
+                                                    const gchar         *name, 
+                                                    const gchar         *type, 
+                                                    gint                 column, 
+                                                    gint                 width, 
+                                                    SearchParseFunc      parse);
+
+void               java_search_dialog_run          (JavaSearchDialog    *dialog);
+JavaMatcher*       java_search_dialog_get_matcher  (JavaSearchDialog    *dialog);
+void               java_search_dialog_set_model    (JavaSearchDialog    *dialog, 
+                                                    JavaResultsModel    *model);
+                                     
+G_END_DECLS
+
+#endif /* __JAVA_SEARCH_DIALOG_H__ */
@@ -21,29 +21,29 @@
 #include <string.h>
 #include <codeslayer/codeslayer-utils.h>
 #include "java-search.h"
-#include "java-utils.h"
-#include "java-client.h"
+#include "java-search-dialog.h"
 
 static void java_search_class_init  (JavaSearchClass   *klass);
 static void java_search_init        (JavaSearch        *search);
 static void java_search_finalize    (JavaSearch        *search);
 
 static void search_action           (JavaSearch        *search);
-static void run_dialog              (JavaSearch        *search);
-static gboolean key_release_action  (JavaSearch        *search,
-                                     GdkEventKey       *event);
-static gchar* get_input             (JavaSearch        *search, 
-                                     const gchar       *text);
-static void render_output           (JavaSearch        *search, 
-                                     gchar             *output);
-static void render_line             (JavaSearch        *search, 
-                                     gchar             *line);
-static void row_activated_action    (JavaSearch        *search,
-                                     GtkTreePath       *path,
-                                     GtkTreeViewColumn *column);
-static gboolean filter_callback     (GtkTreeModel      *model,
-                                     GtkTreeIter       *iter,
-                                     JavaSearch        *search);                                     
+static void render_output           (JavaMatcher       *matcher, 
+                                     gchar             *output, 
+                                     JavaSuppressions  *suppressions);
+static void render_line             (JavaMatcher       *matcher, 
+                                     gchar             *line, 
+                                     JavaSuppressions  *suppressions);
+static void activated_action        (JavaSearch        *search,
+                                     const JavaMatch   *match);
+static void load_history            (JavaSearch        *search);
+static void render_history          (JavaSearch        *search);
+static void add_history             (JavaSearch        *search, 
+                                     const gchar       *class_name, 
+                                     const gchar       *file_path);
+
+#define MAX_HISTORY 50
+#define HISTORY_FILE "history"
 
 #define JAVA_SEARCH_GET_PRIVATE(obj) \
   (G_TYPE_INSTANCE_GET_PRIVATE ((obj), JAVA_SEARCH_TYPE, JavaSearchPrivate))
@@ -52,21 +52,10 @@ typedef struct _JavaSearchPrivate JavaSearchPrivate;
 
 struct _JavaSearchPrivate
 {
-  CodeSlayer   *codeslayer;
-  JavaClient   *client;
-  GtkWidget    *dialog;
-  GtkWidget    *entry;
-  GtkWidget    *tree;
-  GtkListStore *store;
-  GtkTreeModel *filter;  
-};
-
-enum
-{
-  SIMPLE_CLASS_NAME = 0,
-  CLASS_NAME,
-  FILE_PATH,
-  COLUMNS
+  CodeSlayer       *codeslayer;
+  JavaSearchDialog *dialog;
+  GPtrArray        *history;
+  gchar            *history_path;
 };
 
 G_DEFINE_TYPE (JavaSearch, java_search, G_TYPE_OBJECT)
@@ -83,8 +72,8 @@ java_search_init (JavaSearch *search)
 {
   JavaSearchPrivate *priv;
   priv = JAVA_SEARCH_GET_PRIVATE (search);
-  priv->dialog = NULL;
-  priv->filter = NULL;
+  priv->history = g_ptr_array_new_with_free_func (g_free);
+  priv->history_path = NULL;
 }
 
 static void
@@ -93,18 +82,18 @@ java_search_finalize (JavaSearch *search)
   JavaSearchPrivate *priv;
   priv = JAVA_SEARCH_GET_PRIVATE (search);
   
-  if (priv->dialog != NULL)
-    gtk_widget_destroy (priv->dialog);
-    
-  if (priv->client)
-    g_object_unref (priv->client);
+  g_object_unref (priv->dialog);
+  g_ptr_array_free (priv->history, TRUE);
+  g_free (priv->history_path);
 
   G_OBJECT_CLASS (java_search_parent_class)-> finalize (G_OBJECT (search));
 }
 
 JavaSearch*
-java_search_new (CodeSlayer *codeslayer,
-                 GtkWidget  *menu)
+java_search_new (CodeSlayer          *codeslayer,
+                 GtkWidget           *menu, 
+                 JavaIndexer         *indexer, 
+                 JavaToolsProperties *tools_properties)
 {
   JavaSearchPrivate *priv;
   JavaSearch *search;
@@ -113,325 +102,242 @@ java_search_new (CodeSlayer *codeslayer,
   priv = JAVA_SEARCH_GET_PRIVATE (search);
   priv->codeslayer = codeslayer;
   
-  priv->client = java_client_new (codeslayer);
+  priv->dialog = java_search_dialog_new (codeslayer, indexer, tools_properties, 
+                                         "Class", NULL, JAVA_RESULTS_SIMPLE_CLASS_NAME, 200, 
+                                         render_output);
 
   g_signal_connect_swapped (G_OBJECT (menu), "search",
                             G_CALLBACK (search_action), search);
 
+  g_signal_connect_swapped (G_OBJECT (priv->dialog), "empty",
+                            G_CALLBACK (render_history), search);
+
+  g_signal_connect_swapped (G_OBJECT (priv->dialog), "activated",
+                            G_CALLBACK (activated_action), search);
+
   return search;
 }
 
 static void
 search_action (JavaSearch *search)
 {
-  run_dialog (search);
+  JavaSearchPrivate *priv;
+  priv = JAVA_SEARCH_GET_PRIVATE (search);
+  
+  load_history (search);
+  java_search_dialog_run (priv->dialog);
 }
 
+/*
+ * There can be hundreds of thousands of lines, so they are cut up in place 
+ * rather than split into copies.
+ */
 static void
-run_dialog (JavaSearch *search)
+render_output (JavaMatcher      *matcher, 
+               gchar            *output, 
+               JavaSuppressions *suppressions)
 {
-  JavaSearchPrivate *priv;
-  priv = JAVA_SEARCH_GET_PRIVATE (search);
+  gchar *line;
+  gchar *next;
   
-  if (priv->dialog == NULL)
+  for (line = output; line != NULL; line = next)
     {
-      GtkWidget *content_area;
-      GtkWidget *vbox;
-      GtkWidget *hbox;
-      GtkWidget *label;
-      GtkWidget *scrolled_window;
-      GtkTreeViewColumn *column;
-      GtkCellRenderer *renderer;
-
-      priv->dialog = gtk_dialog_new_with_buttons ("Class Search", 
-                                                  codeslayer_get_toplevel_window (priv->codeslayer),
-                                                  GTK_DIALOG_MODAL,
-                                                  GTK_STOCK_CLOSE, GTK_RESPONSE_OK,
-                                                  NULL);
-      gtk_window_set_skip_taskbar_hint (GTK_WINDOW (priv->dialog), TRUE);
-      gtk_window_set_skip_pager_hint (GTK_WINDOW (priv->dialog), TRUE);
-
-      content_area = gtk_dialog_get_content_area (GTK_DIALOG (priv->dialog));
-      
-      vbox = gtk_box_new (GTK_ORIENTATION_VERTICAL, 1);
-      gtk_box_set_homogeneous (GTK_BOX (vbox), FALSE);
-      
-      /* the completion box */
-      
-      hbox = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 2);
-      gtk_box_set_homogeneous (GTK_BOX (hbox), FALSE);
-      
-      label = gtk_label_new ("Class: ");
-      priv->entry = gtk_entry_new ();
-      gtk_box_pack_start (GTK_BOX (hbox), label, FALSE, FALSE, 2);
-      gtk_box_pack_start (GTK_BOX (hbox), priv->entry, TRUE, TRUE, 2);
-      
-      /* the tree view */   
-         
-      priv->store = gtk_list_store_new (COLUMNS, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING);
-      priv->tree =  gtk_tree_view_new ();
-      gtk_tree_view_set_headers_visible (GTK_TREE_VIEW (priv->tree), FALSE);
-      gtk_tree_view_set_enable_search (GTK_TREE_VIEW (priv->tree), FALSE);
-      
-      priv->filter = gtk_tree_model_filter_new (GTK_TREE_MODEL (priv->store), NULL);
-      gtk_tree_model_filter_set_visible_func (GTK_TREE_MODEL_FILTER (priv->filter),
-                                              (GtkTreeModelFilterVisibleFunc) filter_callback,
-                                               search, NULL);
-      
-      gtk_tree_view_set_model (GTK_TREE_VIEW (priv->tree), GTK_TREE_MODEL (priv->filter));
-      g_object_unref (priv->store);
-      
+      next = strchr (line, '\n');
+      if (next != NULL)
+        *next++ = '\0';
+      render_line (matcher, line, suppressions);
+    }
+}
 
-      column = gtk_tree_view_column_new ();
-      gtk_tree_view_column_set_sizing (column, GTK_TREE_VIEW_COLUMN_AUTOSIZE);
-      renderer = gtk_cell_renderer_text_new ();
-      gtk_tree_view_column_pack_start (column, renderer, FALSE);
-      gtk_tree_view_column_add_attribute (column, renderer, "text", SIMPLE_CLASS_NAME);
-      gtk_tree_view_append_column (GTK_TREE_VIEW (priv->tree), column);
-      
-      column = gtk_tree_view_column_new ();
-      gtk_tree_view_column_set_sizing (column, GTK_TREE_VIEW_COLUMN_AUTOSIZE);
-      renderer = gtk_cell_renderer_text_new ();
-      gtk_tree_view_column_pack_start (column, renderer, FALSE);
-      gtk_tree_view_column_add_attribute (column, renderer, "text", CLASS_NAME);
-      gtk_tree_view_append_column (GTK_TREE_VIEW (priv->tree), column);
-      
-      scrolled_window = gtk_scrolled_window_new (NULL, NULL);
-      gtk_scrolled_window_set_policy (GTK_SCROLLED_WINDOW (scrolled_window),
-                                      GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
-      gtk_container_add (GTK_CONTAINER (scrolled_window), GTK_WIDGET (priv->tree));
-      
-      /* hook up the signals */
-      
-      g_signal_connect_swapped (G_OBJECT (priv->entry), "key-release-event",
-                                G_CALLBACK (key_release_action), search);
-                                
-      g_signal_connect_swapped (G_OBJECT (priv->tree), "row-activated",
-                                G_CALLBACK (row_activated_action), search);
-                                
-      
-      /* render everything */
-      
-      gtk_widget_set_size_request (content_area, 600, 400);
-      
-      gtk_box_pack_start (GTK_BOX (vbox), hbox, FALSE, FALSE, 0);
-      gtk_box_pack_start (GTK_BOX (vbox), scrolled_window, TRUE, TRUE, 0);
-      gtk_box_pack_start (GTK_BOX (content_area), vbox, TRUE, TRUE, 0);
+static void
+render_line (JavaMatcher      *matcher, 
+             gchar            *line, 
+             JavaSuppressions *suppressions)
+{
+  gchar *simple_class_name;  
+  gchar *class_name;  
+  gchar *file_path;
+  gchar *end;
+  
+  if (!codeslayer_utils_has_text (line))
+    return;
+  
+  simple_class_name = line;
+  
+  class_name = strchr (simple_class_name, '\t');
+  if (class_name == NULL)
+    return;
+  *class_name++ = '\0';
+  
+  file_path = strchr (class_name, '\t');
+  if (file_path == NULL)
+    return;
+  *file_path++ = '\0';
+  
+  end = strchr (file_path, '\t');
+  if (end != NULL)
+    *end = '\0';
+  
+  if (!java_suppressions_match (suppressions, class_name))
+    java_matcher_add (matcher, simple_class_name, class_name, file_path);
+}
 
-      gtk_widget_show_all (content_area);
-    }
-    
-  gtk_widget_grab_focus (priv->entry);
-  gtk_dialog_run (GTK_DIALOG (priv->dialog));
-  gtk_widget_hide (priv->dialog);
+static void
+activated_action (JavaSearch      *search,
+                  const JavaMatch *match)
+{
+  add_history (search, match->class_name, match->file_path);
 }
 
-static gboolean
-key_release_action (JavaSearch  *search,
-                    GdkEventKey *event)
+/*
+ * The classes that were opened lately are kept per group, newest first, 
+ * one class name and file path to a line. They are only read when the 
+ * dialog is first opened for the group, and are handed to the matcher as 
+ * if they were just used, oldest first, so that they rank in that order.
+ */
+static void
+load_history (JavaSearch *search)
 {
   JavaSearchPrivate *priv;
-  gint text_length;
+  gchar *group_folder_path;
+  gchar *history_path;
+  gchar *contents;
   
   priv = JAVA_SEARCH_GET_PRIVATE (search);
   
-  text_length = gtk_entry_get_text_length (GTK_ENTRY (priv->entry));
+  group_folder_path = codeslayer_get_active_group_folder_path (priv->codeslayer);
+  history_path = g_build_filename (group_folder_path, "indexes", HISTORY_FILE, NULL);
+  g_free (group_folder_path);
   
-  if (text_length == 0)
-    {
-      gtk_list_store_clear (priv->store);
-    }
-  else if (text_length > 1 && 
-           gtk_tree_model_iter_n_children (GTK_TREE_MODEL (priv->filter), NULL))
+  if (g_strcmp0 (history_path, priv->history_path) == 0)
     {
-      gtk_tree_model_filter_refilter (GTK_TREE_MODEL_FILTER (priv->filter));
+      g_free (history_path);
+      return;
     }
-  else
+  
+  g_free (priv->history_path);
+  priv->history_path = history_path;
+  g_ptr_array_set_size (priv->history, 0);
+  
+  if (g_file_get_contents (history_path, &contents, NULL, NULL))
     {
-      gchar *input;
-      gchar *output;
-      const gchar *text;
-      
-      gtk_list_store_clear (priv->store);
-
-      text = gtk_entry_get_text (GTK_ENTRY (priv->entry));  
-      input = get_input (search, text);
+      gchar **lines;
+      gchar **tmp;
+      guint i;
       
-      g_print ("input: %s\n", input);
+      lines = g_strsplit (contents, "\n", -1);
       
-      output = java_client_send (priv->client, input);
+      for (tmp = lines; *tmp != NULL && priv->history->len < MAX_HISTORY; tmp++)
+        {
+          if (strchr (*tmp, '\t') != NULL)
+            g_ptr_array_add (priv->history, g_strdup (*tmp));
+        }
       
-      if (output != NULL)
+      for (i = priv->history->len; i > 0; i--)
         {
-          g_print ("output: %s\n", output);
-          render_output (search, output);
-          g_free (output);
+          gchar *line = g_ptr_array_index (priv->history, i - 1);
+          gchar *class_name = g_strndup (line, strchr (line, '\t') - line);
+          java_matcher_use (java_search_dialog_get_matcher (priv->dialog), class_name);
+          g_free (class_name);
         }
-
-      g_free (input);    
+      
+      g_strfreev (lines);
+      g_free (contents);
     }
-  
-  return FALSE;
 }
 
-static gchar* 
-get_input (JavaSearch  *search, 
-           const gchar *text)
+/*
+ * Shows the classes that were opened lately, for when nothing is typed. 
+ * The lines are joined and cut up again in place for the model to own.
+ */
+static void
+render_history (JavaSearch *search)
 {
   JavaSearchPrivate *priv;
-
-  gchar *indexes_folder;
-  gchar *result;
+  JavaResultsModel *model;
+  GArray *rows;
+  gchar *contents;
+  gchar *line;
+  gchar *next;
   
   priv = JAVA_SEARCH_GET_PRIVATE (search);
   
-  indexes_folder = java_utils_get_indexes_folder (priv->codeslayer);
-  
-  result = g_strconcat ("-program search", 
-                        " -name ", text,
-                        indexes_folder, 
-                        NULL);
+  if (priv->history->len == 0)
+    return;
   
-  g_free (indexes_folder);
-
-  return result;
-}
-
-static void
-render_output (JavaSearch *search, 
-               gchar      *output)
-{
-  gchar **split;
-  gchar **tmp;
+  g_ptr_array_add (priv->history, NULL);
+  contents = g_strjoinv ("\n", (gchar**) priv->history->pdata);
+  g_ptr_array_set_size (priv->history, priv->history->len - 1);
   
-  if (!codeslayer_utils_has_text (output))
-    return;
+  rows = g_array_sized_new (FALSE, FALSE, sizeof (JavaMatch), priv->history->len);
   
-  split = g_strsplit (output, "\n", -1);
-
-  if (g_strcmp0 (*split, "NO_RESULTS_FOUND") == 0)
-    return;
-
-  if (split != NULL)
+  for (line = contents; line != NULL; line = next)
     {
-      tmp = split;
-      while (*tmp != NULL)
-        {
-          render_line (search, *tmp);
-          tmp++;
-        }
-      g_strfreev (split);
+      JavaMatch match;
+      gchar *tab;
+      
+      next = strchr (line, '\n');
+      if (next != NULL)
+        *next++ = '\0';
+      
+      tab = strchr (line, '\t');
+      *tab = '\0';
+      
+      match.class_name = line;
+      match.simple_class_name = strrchr (line, '.') != NULL ? strrchr (line, '.') + 1 : line;
+      match.file_path = tab + 1;
+      match.detail = NULL;
+      match.line_number = 0;
+      g_array_append_val (rows, match);
     }
+  
+  model = java_results_model_new (rows, contents, g_free);
+  java_search_dialog_set_model (priv->dialog, model);
+  g_object_unref (model);
 }
 
+/*
+ * Moves the class to the front of the history and writes it out. It is 
+ * never more than a few lines, so that is done right away.
+ */
 static void
-render_line (JavaSearch *search, 
-             gchar      *line)
+add_history (JavaSearch  *search, 
+             const gchar *class_name, 
+             const gchar *file_path)
 {
   JavaSearchPrivate *priv;
-  GtkTreeIter iter;
-  gchar **split;
-  gchar **tmp;
+  gchar *contents;
+  gchar *line;
+  guint i;
   
   priv = JAVA_SEARCH_GET_PRIVATE (search);
   
-  if (!codeslayer_utils_has_text (line))
+  if (class_name == NULL || file_path == NULL || priv->history_path == NULL)
     return;
   
-  split = g_strsplit (line, "\t", -1);
-  if (split != NULL)
+  line = g_strconcat (class_name, "\t", file_path, NULL);
+  
+  for (i = 0; i < priv->history->len; i++)
     {
-      gchar *simple_class_name;  
-      gchar *class_name;  
-      gchar *file_path;
-      
-      tmp = split;
-
-      simple_class_name = *tmp;
-      class_name = *++tmp;
-      file_path = *++tmp;
-      
-      if (simple_class_name != NULL && 
-          class_name != NULL && 
-          file_path != NULL)
+      if (g_strcmp0 (g_ptr_array_index (priv->history, i), line) == 0)
         {
-          gtk_list_store_append (priv->store, &iter);
-          gtk_list_store_set (priv->store, &iter, 
-                              SIMPLE_CLASS_NAME, simple_class_name, 
-                              CLASS_NAME, class_name, 
-                              FILE_PATH, file_path, 
-                              -1);
+          g_ptr_array_remove_index (priv->history, i);
+          break;
         }
-
-      g_strfreev (split);
     }
-}
-
-static gboolean
-filter_callback (GtkTreeModel *model,
-                 GtkTreeIter  *iter,
-                 JavaSearch   *search)
-{  
-  JavaSearchPrivate *priv;
-  const gchar *text = NULL;
-  gchar *value = NULL;
-
-  priv = JAVA_SEARCH_GET_PRIVATE (search);
   
-  text = gtk_entry_get_text (GTK_ENTRY (priv->entry));
-  gtk_tree_model_get (model, iter, SIMPLE_CLASS_NAME, &value, -1);
+  g_ptr_array_add (priv->history, line);
+  memmove (priv->history->pdata + 1, priv->history->pdata, 
+           (priv->history->len - 1) * sizeof (gpointer));
+  priv->history->pdata[0] = line;
   
-  if (text == NULL || value == NULL)
-    return FALSE;
-
-  if (g_str_has_prefix (value, text))
-    return TRUE;
-
-  return FALSE;
-}                 
-
-static void
-row_activated_action (JavaSearch        *search,
-                      GtkTreePath       *path,
-                      GtkTreeViewColumn *column)
-{
-  JavaSearchPrivate *priv;
-  GtkTreeSelection *tree_selection;
-  GtkTreeModel *tree_model;
-  GList *selected_rows = NULL;
-  GList *tmp = NULL;  
+  if (priv->history->len > MAX_HISTORY)
+    g_ptr_array_set_size (priv->history, MAX_HISTORY);
   
-  priv = JAVA_SEARCH_GET_PRIVATE (search);
-
-  tree_selection = gtk_tree_view_get_selection (GTK_TREE_VIEW (priv->tree));
-  tree_model = gtk_tree_view_get_model (GTK_TREE_VIEW (priv->tree));
-  selected_rows = gtk_tree_selection_get_selected_rows (tree_selection, &tree_model);
-
-  tmp = selected_rows;
+  g_ptr_array_add (priv->history, NULL);
+  contents = g_strjoinv ("\n", (gchar**) priv->history->pdata);
+  g_ptr_array_set_size (priv->history, priv->history->len - 1);
   
-  if (tmp != NULL)
-    {
-      GtkTreeIter treeiter;
-      CodeSlayerProject *project;
-      CodeSlayerDocument *document;
-      gchar *file_path; 
-      GtkTreePath *tree_path = tmp->data;
-      
-      gtk_tree_model_get_iter (tree_model, &treeiter, tree_path);
-      gtk_tree_model_get (GTK_TREE_MODEL (priv->filter), &treeiter, FILE_PATH, &file_path, -1);
-      
-      document = codeslayer_document_new ();
-      project = codeslayer_get_project_by_file_path (priv->codeslayer, file_path);
-      codeslayer_document_set_file_path (document, file_path);
-      codeslayer_document_set_project (document, project);
-      
-      codeslayer_select_editor (priv->codeslayer, document);
-      gtk_widget_hide (priv->dialog);
-      
-      g_object_unref (document);
-      g_free (file_path);
-      gtk_tree_path_free (tree_path);
-    }
-
-  g_list_free (selected_rows);
-}                     
+  g_file_set_contents (priv->history_path, contents, -1, NULL);
+  g_free (contents);
+}
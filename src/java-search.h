@@ -21,6 +21,8 @@
 
 #include <gtk/gtk.h>
 #include <codeslayer/codeslayer.h>
+#include "java-tools-properties.h"
+#include "java-indexer.h"
 
 G_BEGIN_DECLS
 
@@ -45,8 +47,10 @@ struct _JavaSearchClass
 
 GType java_search_get_type (void) G_GNUC_CONST;
      
-JavaSearch*  java_search_new  (CodeSlayer *codeslayer,                                          
-                               GtkWidget  *menu);
+JavaSearch*  java_search_new  (CodeSlayer          *codeslayer,
+                               GtkWidget           *menu, 
+                               JavaIndexer         *indexer, 
+                               JavaToolsProperties *tools_properties);
                                      
 G_END_DECLS
 
@@ -0,0 +1,801 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+#include <codeslayer/codeslayer-utils.h>
+#include "java-signature.h"
+#include "java-completion-method.h"
+#include "java-lexer.h"
+#include "java-resolver.h"
+#include "java-utils.h"
+
+/*
+ * Shows the parameters of the method whose parentheses the caret is in, 
+ * with the argument that is being typed in bold. The signatures come out 
+ * of the method completion cache, which already holds the name, types, 
+ * variables and return type of every method on the receivers that were 
+ * completed on. Only when the cache has nothing is the server asked, in 
+ * the background, and when the method is not on the pages that the cache 
+ * has the next page is asked for.
+ *
+ * The type of this is the same anywhere in the buffer, so it is only 
+ * worked out again after the buffer changed.
+ */
+
+typedef struct
+{
+  JavaSignature *signature;
+  GCancellable  *cancellable;
+  gchar         *file_path;
+  gchar         *expression;
+  gchar         *output;
+  gint           offset;
+} Fetch;
+
+static void java_signature_class_init  (JavaSignatureClass *klass);
+static void java_signature_init        (JavaSignature      *signature);
+static void java_signature_finalize    (JavaSignature      *signature);
+
+static void cursor_moved_action        (JavaSignature      *signature);
+static void buffer_changed_action      (JavaSignature      *signature);
+static gboolean focus_out_action       (JavaSignature      *signature, 
+                                        GdkEvent           *event);
+static gboolean key_press_action       (JavaSignature      *signature, 
+                                        GdkEventKey        *event);
+static gboolean update_idle            (JavaSignature      *signature);
+static const gchar* lookup_this        (JavaSignature      *signature, 
+                                        const gchar        *file_path, 
+                                        GtkTextIter        *name, 
+                                        GtkTextIter        *scope);
+static gboolean get_call               (GtkTextIter        *iter, 
+                                        GtkTextIter        *open, 
+                                        GtkTextIter        *name, 
+                                        gint               *argument);
+static gchar* get_markup               (const gchar        *output, 
+                                        const gchar        *name, 
+                                        gint                argument);
+static GPtrArray* split_parameters     (const gchar        *parameters);
+static void show_popup                 (JavaSignature      *signature, 
+                                        const gchar        *markup, 
+                                        GtkTextIter        *open);
+static void hide_popup                 (JavaSignature      *signature);
+static void fetch                      (JavaSignature      *signature, 
+                                        const gchar        *file_path, 
+                                        gchar              *expression, 
+                                        GtkTextIter        *name, 
+                                        gint                offset);
+static void fetch_callback             (gchar              *output, 
+                                        Fetch              *fetch);
+static gboolean fetch_idle             (Fetch              *fetch);
+static void destroy_fetch              (Fetch              *fetch);
+static void cancel_fetch               (JavaSignature      *signature);
+
+#define SIGNATURE_WINDOW 512
+#define MAX_OVERLOADS 8
+
+#define JAVA_SIGNATURE_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), JAVA_SIGNATURE_TYPE, JavaSignaturePrivate))
+
+typedef struct _JavaSignaturePrivate JavaSignaturePrivate;
+
+struct _JavaSignaturePrivate
+{
+  CodeSlayer          *codeslayer;
+  CodeSlayerEditor    *editor;
+  JavaClient          *client;
+  JavaCompletionCache *cache;
+  GtkWidget           *window;
+  GtkWidget           *label;
+  GCancellable        *fetch;
+  GtkTextMark         *fetch_mark;
+  guint                update_id;
+  gchar               *this_type;
+  gboolean             this_known;
+};
+
+G_DEFINE_TYPE (JavaSignature, java_signature, G_TYPE_OBJECT)
+
+static void 
+java_signature_class_init (JavaSignatureClass *klass)
+{
+  G_OBJECT_CLASS (klass)->finalize = (GObjectFinalizeFunc) java_signature_finalize;
+  g_type_class_add_private (klass, sizeof (JavaSignaturePrivate));
+}
+
+static void
+java_signature_init (JavaSignature *signature)
+{
+  JavaSignaturePrivate *priv;
+  priv = JAVA_SIGNATURE_GET_PRIVATE (signature);
+  priv->window = NULL;
+  priv->label = NULL;
+  priv->fetch = NULL;
+  priv->fetch_mark = NULL;
+  priv->update_id = 0;
+  priv->this_type = NULL;
+  priv->this_known = FALSE;
+}
+
+static void
+java_signature_finalize (JavaSignature *signature)
+{
+  JavaSignaturePrivate *priv;
+  priv = JAVA_SIGNATURE_GET_PRIVATE (signature);
+  
+  if (priv->update_id != 0)
+    g_source_remove (priv->update_id);
+  
+  cancel_fetch (signature);
+  
+  if (priv->window != NULL)
+    gtk_widget_destroy (priv->window);
+  
+  g_free (priv->this_type);
+
+  G_OBJECT_CLASS (java_signature_parent_class)->finalize (G_OBJECT (signature));
+}
+
+/*
+ * The signature help lives as long as the editor, which holds on to it.
+ */
+JavaSignature*
+java_signature_new (CodeSlayer          *codeslayer, 
+                    CodeSlayerEditor    *editor, 
+                    JavaClient          *client, 
+                    JavaCompletionCache *cache)
+{
+  JavaSignaturePrivate *priv;
+  JavaSignature *signature;
+  GtkTextBuffer *buffer;
+
+  signature = JAVA_SIGNATURE (g_object_new (java_signature_get_type (), NULL));
+  priv = JAVA_SIGNATURE_GET_PRIVATE (signature);
+  priv->codeslayer = codeslayer;
+  priv->editor = editor;
+  priv->client = client;
+  priv->cache = cache;
+  
+  buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (editor));
+  
+  g_signal_connect_object (G_OBJECT (buffer), "notify::cursor-position",
+                           G_CALLBACK (cursor_moved_action), signature, 
+                           G_CONNECT_SWAPPED | G_CONNECT_AFTER);
+  
+  g_signal_connect_object (G_OBJECT (buffer), "changed",
+                           G_CALLBACK (buffer_changed_action), signature, 
+                           G_CONNECT_SWAPPED);
+  
+  g_signal_connect_object (G_OBJECT (editor), "focus-out-event",
+                           G_CALLBACK (focus_out_action), signature, 
+                           G_CONNECT_SWAPPED);
+  
+  g_signal_connect_object (G_OBJECT (editor), "key-press-event",
+                           G_CALLBACK (key_press_action), signature, 
+                           G_CONNECT_SWAPPED);
+  
+  g_object_set_data_full (G_OBJECT (editor), "java-signature", signature, g_object_unref);
+
+  return signature;
+}
+
+static void
+cursor_moved_action (JavaSignature *signature)
+{
+  JavaSignaturePrivate *priv;
+  priv = JAVA_SIGNATURE_GET_PRIVATE (signature);
+  
+  if (priv->update_id == 0)
+    priv->update_id = g_idle_add ((GSourceFunc) update_idle, signature);
+}
+
+static void
+buffer_changed_action (JavaSignature *signature)
+{
+  JavaSignaturePrivate *priv;
+  priv = JAVA_SIGNATURE_GET_PRIVATE (signature);
+  priv->this_known = FALSE;
+}
+
+static gboolean
+focus_out_action (JavaSignature *signature, 
+                  GdkEvent      *event)
+{
+  hide_popup (signature);
+  return FALSE;
+}
+
+static gboolean
+key_press_action (JavaSignature *signature, 
+                  GdkEventKey   *event)
+{
+  if (event->keyval == GDK_KEY_Escape)
+    hide_popup (signature);
+  return FALSE;
+}
+
+/*
+ * Runs once the caret settles, so that a burst of moves only looks up the 
+ * call once.
+ */
+static gboolean
+update_idle (JavaSignature *signature)
+{
+  JavaSignaturePrivate *priv;
+  GtkTextBuffer *buffer;
+  const gchar *file_path;
+  GtkTextIter iter;
+  GtkTextIter open;
+  GtkTextIter name_start;
+  GtkTextIter prev;
+  GtkTextIter scope;
+  const gchar *output;
+  gchar *expression;
+  gchar *name;
+  gchar *markup = NULL;
+  gint argument;
+  gint next_offset = -1;
+  gboolean dotted;
+  
+  priv = JAVA_SIGNATURE_GET_PRIVATE (signature);
+  priv->update_id = 0;
+  
+  file_path = codeslayer_editor_get_file_path (priv->editor);
+  if (file_path == NULL || !g_str_has_suffix (file_path, ".java"))
+    return FALSE;
+  
+  buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (priv->editor));
+  gtk_text_buffer_get_iter_at_mark (buffer, &iter, gtk_text_buffer_get_insert (buffer));
+  
+  if (!get_call (&iter, &open, &name_start, &argument))
+    {
+      cancel_fetch (signature);
+      hide_popup (signature);
+      return FALSE;
+    }
+  
+  if (priv->fetch != NULL)
+    {
+      GtkTextIter fetched;
+      gtk_text_buffer_get_iter_at_mark (buffer, &fetched, priv->fetch_mark);
+      if (!gtk_text_iter_equal (&fetched, &name_start))
+        cancel_fetch (signature);
+    }
+  
+  prev = name_start;
+  dotted = gtk_text_iter_backward_char (&prev) && gtk_text_iter_get_char (&prev) == '.';
+  
+  if (dotted)
+    expression = java_utils_get_expression (name_start);
+  else
+    expression = g_strdup ("this");
+  
+  if (expression == NULL || *expression == '\0')
+    {
+      g_free (expression);
+      hide_popup (signature);
+      return FALSE;
+    }
+  
+  name = gtk_text_iter_get_text (&name_start, &open);
+  g_strstrip (name);
+  
+  java_completion_cache_get_scope (&name_start, &scope);
+  
+  if (dotted)
+    output = java_completion_cache_lookup_resolved (priv->cache, file_path, expression, 
+                                                    &name_start, &scope);
+  else
+    output = lookup_this (signature, file_path, &name_start, &scope);
+  
+  if (output != NULL)
+    markup = get_markup (output, name, argument);
+  
+  if (markup != NULL)
+    show_popup (signature, markup, &open);
+  else
+    hide_popup (signature);
+  
+  if (output != NULL && markup == NULL)
+    next_offset = java_completion_cache_get_next_offset (output, NULL);
+  
+  /* this is only ever known to the cache through the resolver */
+  if (dotted && priv->fetch == NULL && (output == NULL || next_offset > 0))
+    fetch (signature, file_path, expression, &name_start, MAX (next_offset, 0));
+  else
+    g_free (expression);
+  
+  g_free (markup);
+  g_free (name);
+  
+  return FALSE;
+}
+
+static const gchar*
+lookup_this (JavaSignature *signature, 
+             const gchar   *file_path, 
+             GtkTextIter   *name, 
+             GtkTextIter   *scope)
+{
+  JavaSignaturePrivate *priv;
+  const gchar *cached;
+  
+  priv = JAVA_SIGNATURE_GET_PRIVATE (signature);
+  
+  cached = java_completion_cache_lookup (priv->cache, file_path, "this", scope);
+  if (cached != NULL)
+    return cached;
+  
+  if (!priv->this_known)
+    {
+      g_free (priv->this_type);
+      priv->this_type = java_resolver_get_type (*name, "this");
+      priv->this_known = TRUE;
+    }
+  
+  if (priv->this_type == NULL)
+    return NULL;
+  
+  return java_completion_cache_lookup_type (priv->cache, priv->this_type);
+}
+
+/*
+ * Walks back from the iter to the unclosed parenthesis of a method call, 
+ * counting the commas on the way to know which argument is being typed. 
+ * Statements and blocks end the walk, as do control keywords such as if, 
+ * and constructors.
+ */
+static gboolean
+get_call (GtkTextIter *iter, 
+          GtkTextIter *open, 
+          GtkTextIter *name, 
+          gint        *argument)
+{
+  GtkTextBuffer *buffer;
+  JavaLexer *lexer;
+  gint window = SIGNATURE_WINDOW;
+  gint depth = 0;
+  gint found_line = -1;
+  gint found_index = 0;
+  gint line;
+  gint edge;
+  
+  buffer = gtk_text_iter_get_buffer (iter);
+  lexer = java_lexer_get (buffer);
+  
+  *argument = 0;
+  line = gtk_text_iter_get_line (iter);
+  edge = gtk_text_iter_get_line_index (iter);
+  
+  for (; line >= 0; line--, edge = -1)
+    {
+      GArray *tokens;
+      const gchar *text;
+      gint i;
+      
+      tokens = java_lexer_get_tokens (lexer, line);
+      text = java_lexer_get_text (lexer, line);
+      if (tokens == NULL)
+        break;
+      
+      for (i = tokens->len - 1; i >= 0; i--)
+        {
+          JavaToken *token = &g_array_index (tokens, JavaToken, i);
+          gchar ch;
+          
+          if (edge >= 0 && token->index >= edge)
+            continue;
+          
+          if (--window < 0)
+            return FALSE;
+          
+          if (token->type == JAVA_TOKEN_COMMENT)
+            continue;
+          
+          if (found_line >= 0)
+            {
+              if (token->type != JAVA_TOKEN_IDENTIFIER)
+                return FALSE;
+              
+              if (i > 0 && java_lexer_token_equals (lexer, line, 
+                                                    &g_array_index (tokens, JavaToken, i - 1), "new"))
+                return FALSE;
+              
+              gtk_text_buffer_get_iter_at_line_index (buffer, open, found_line, found_index);
+              gtk_text_buffer_get_iter_at_line_index (buffer, name, line, token->index);
+              return TRUE;
+            }
+          
+          if (token->type != JAVA_TOKEN_OPERATOR)
+            continue;
+          
+          ch = text[token->index];
+          
+          switch (ch)
+            {
+            case ')':
+            case ']':
+              depth++;
+              break;
+            case '[':
+              if (depth == 0)
+                return FALSE;
+              depth--;
+              break;
+            case '(':
+              if (depth == 0)
+                {
+                  found_line = line;
+                  found_index = token->index;
+                }
+              else
+                {
+                  depth--;
+                }
+              break;
+            case ',':
+              if (depth == 0)
+                (*argument)++;
+              break;
+            case ';':
+            case '{':
+            case '}':
+              if (depth == 0)
+                return FALSE;
+              break;
+            }
+        }
+    }
+  
+  return FALSE;
+}
+
+/*
+ * One line per overload of the method, with the argument at the caret in 
+ * bold. Overloads that take too few arguments are left out, unless that 
+ * would leave none.
+ */
+static gchar*
+get_markup (const gchar *output, 
+            const gchar *name, 
+            gint         argument)
+{
+  GString *markup;
+  gchar **lines;
+  gchar **line;
+  gint pass;
+  gint count = 0;
+  
+  lines = g_strsplit (output, "\n", -1);
+  markup = g_string_new ("");
+  
+  for (pass = 0; pass < 2 && count == 0; pass++)
+    {
+      for (line = lines; *line != NULL && count < MAX_OVERLOADS; line++)
+        {
+          gchar **fields;
+          GPtrArray *types;
+          gchar **variables;
+          guint i;
+          
+          fields = g_strsplit (*line, "\t", -1);
+          
+          if (g_strv_length (fields) < 4 || g_strcmp0 (fields[0], name) != 0)
+            {
+              g_strfreev (fields);
+              continue;
+            }
+          
+          types = split_parameters (fields[1]);
+          variables = g_strsplit (fields[2], ",", -1);
+          
+          if (pass == 0 && (gint) types->len <= argument && 
+              !(types->len == 0 && argument == 0))
+            {
+              g_ptr_array_free (types, TRUE);
+              g_strfreev (variables);
+              g_strfreev (fields);
+              continue;
+            }
+          
+          if (count++ > 0)
+            g_string_append_c (markup, '\n');
+          
+          g_string_append_printf (markup, "%s(", fields[0]);
+          
+          for (i = 0; i < types->len; i++)
+            {
+              gchar *parameter;
+              gchar *escaped;
+              
+              if (i < g_strv_length (variables))
+                parameter = g_strdup_printf ("%s %s", (gchar*) g_ptr_array_index (types, i), 
+                                             g_strstrip (variables[i]));
+              else
+                parameter = g_strdup (g_ptr_array_index (types, i));
+              
+              escaped = g_markup_escape_text (parameter, -1);
+              
+              if (i > 0)
+                g_string_append (markup, ", ");
+              
+              if ((gint) i == argument)
+                g_string_append_printf (markup, "<b>%s</b>", escaped);
+              else
+                g_string_append (markup, escaped);
+              
+              g_free (escaped);
+              g_free (parameter);
+            }
+          
+          if (codeslayer_utils_has_text (fields[3]))
+            {
+              gchar *escaped = g_markup_escape_text (fields[3], -1);
+              g_string_append_printf (markup, ") %s", escaped);
+              g_free (escaped);
+            }
+          else
+            {
+              g_string_append_c (markup, ')');
+            }
+          
+          g_ptr_array_free (types, TRUE);
+          g_strfreev (variables);
+          g_strfreev (fields);
+        }
+    }
+  
+  g_strfreev (lines);
+  
+  if (count == 0)
+    {
+      g_string_free (markup, TRUE);
+      return NULL;
+    }
+  
+  return g_string_free (markup, FALSE);
+}
+
+/*
+ * Splits the parameter types on the commas that are not inside type 
+ * arguments, such as the one in Map<String, Integer>.
+ */
+static GPtrArray*
+split_parameters (const gchar *parameters)
+{
+  GPtrArray *types;
+  const gchar *start;
+  const gchar *p;
+  gint depth = 0;
+  
+  types = g_ptr_array_new_with_free_func (g_free);
+  
+  if (!codeslayer_utils_has_text (parameters))
+    return types;
+  
+  for (start = p = parameters; ; p++)
+    {
+      if (*p == '<')
+        {
+          depth++;
+        }
+      else if (*p == '>')
+        {
+          depth--;
+        }
+      else if ((*p == ',' && depth == 0) || *p == '\0')
+        {
+          gchar *type = g_strndup (start, p - start);
+          g_ptr_array_add (types, g_strstrip (type));
+          if (*p == '\0')
+            break;
+          start = p + 1;
+        }
+    }
+  
+  return types;
+}
+
+/*
+ * The popup sits just above the line of the opening parenthesis, so that 
+ * it does not cover the completion popup below the caret.
+ */
+static void
+show_popup (JavaSignature *signature, 
+            const gchar   *markup, 
+            GtkTextIter   *open)
+{
+  JavaSignaturePrivate *priv;
+  GtkTextView *text_view;
+  GdkRectangle location;
+  GtkRequisition size;
+  GdkWindow *window;
+  gint origin_x;
+  gint origin_y;
+  gint x;
+  gint y;
+  
+  priv = JAVA_SIGNATURE_GET_PRIVATE (signature);
+  
+  text_view = GTK_TEXT_VIEW (priv->editor);
+  window = gtk_widget_get_window (GTK_WIDGET (text_view));
+  if (window == NULL)
+    return;
+  
+  if (priv->window == NULL)
+    {
+      GtkWidget *frame;
+      priv->window = gtk_window_new (GTK_WINDOW_POPUP);
+      frame = gtk_frame_new (NULL);
+      priv->label = gtk_label_new (NULL);
+      gtk_misc_set_alignment (GTK_MISC (priv->label), 0, 0.5);
+      gtk_misc_set_padding (GTK_MISC (priv->label), 4, 2);
+      gtk_container_add (GTK_CONTAINER (frame), priv->label);
+      gtk_container_add (GTK_CONTAINER (priv->window), frame);
+      gtk_widget_show_all (frame);
+    }
+  
+  gtk_label_set_markup (GTK_LABEL (priv->label), markup);
+  
+  gtk_text_view_get_iter_location (text_view, open, &location);
+  gtk_text_view_buffer_to_window_coords (text_view, GTK_TEXT_WINDOW_WIDGET, 
+                                         location.x, location.y, &x, &y);
+  gdk_window_get_origin (window, &origin_x, &origin_y);
+  
+  gtk_window_resize (GTK_WINDOW (priv->window), 1, 1);
+  gtk_widget_get_preferred_size (priv->window, NULL, &size);
+  
+  y = origin_y + y - size.height;
+  if (y < 0)
+    y = origin_y + location.y + location.height;
+  
+  gtk_window_move (GTK_WINDOW (priv->window), origin_x + x, y);
+  gtk_widget_show (priv->window);
+}
+
+static void
+hide_popup (JavaSignature *signature)
+{
+  JavaSignaturePrivate *priv;
+  priv = JAVA_SIGNATURE_GET_PRIVATE (signature);
+  
+  if (priv->window != NULL)
+    gtk_widget_hide (priv->window);
+}
+
+/*
+ * Asks the server for a page of the methods of the receiver, taking 
+ * ownership of the expression. They go into the cache, and the popup is 
+ * looked up again once they are there.
+ */
+static void
+fetch (JavaSignature *signature, 
+       const gchar   *file_path, 
+       gchar         *expression, 
+       GtkTextIter   *name, 
+       gint           offset)
+{
+  JavaSignaturePrivate *priv;
+  Fetch *data;
+  gchar *input;
+  gchar *low;
+  
+  priv = JAVA_SIGNATURE_GET_PRIVATE (signature);
+  
+  priv->fetch = g_cancellable_new ();
+  priv->fetch_mark = gtk_text_buffer_create_mark (gtk_text_iter_get_buffer (name), 
+                                                  NULL, name, TRUE);
+  
+  data = g_malloc (sizeof (Fetch));
+  data->signature = g_object_ref (signature);
+  data->cancellable = g_object_ref (priv->fetch);
+  data->file_path = g_strdup (file_path);
+  data->expression = expression;
+  data->output = NULL;
+  data->offset = offset;
+  
+  input = java_completion_method_get_input (priv->codeslayer, file_path, expression, 
+                                            gtk_text_iter_get_line (name), offset);
+  low = g_strconcat (input, " -priority low", NULL);
+  
+  java_client_send_with_cancellable (priv->client, low, data->cancellable, 
+                                     (ClientCallbackFunc) fetch_callback, data);
+  
+  g_free (input);
+  g_free (low);
+}
+
+static void
+fetch_callback (gchar *output, 
+                Fetch *fetch)
+{
+  fetch->output = output;
+  g_idle_add_full (G_PRIORITY_DEFAULT_IDLE, (GSourceFunc) fetch_idle, 
+                   fetch, (GDestroyNotify) destroy_fetch);
+}
+
+/*
+ * The fetch that is still current owns the mark, so the scope is found 
+ * from there. The fetch is kept until the caret leaves the call, so that 
+ * a receiver the server knows nothing about is only asked for once. A 
+ * later page is let go of once it is added, so that the one after it can 
+ * be asked for.
+ */
+static gboolean
+fetch_idle (Fetch *fetch)
+{
+  JavaSignaturePrivate *priv;
+  GtkTextBuffer *buffer;
+  GtkTextIter start;
+  GtkTextIter scope;
+  
+  if (g_cancellable_is_cancelled (fetch->cancellable))
+    return FALSE;
+  
+  priv = JAVA_SIGNATURE_GET_PRIVATE (fetch->signature);
+  
+  if (fetch->output != NULL && !gtk_text_mark_get_deleted (priv->fetch_mark))
+    {
+      buffer = gtk_text_mark_get_buffer (priv->fetch_mark);
+      gtk_text_buffer_get_iter_at_mark (buffer, &start, priv->fetch_mark);
+      java_completion_cache_get_scope (&start, &scope);
+      if (fetch->offset > 0)
+        java_completion_cache_append (priv->cache, fetch->file_path, fetch->expression, 
+                                      &scope, fetch->offset, fetch->output);
+      else
+        java_completion_cache_insert_resolved (priv->cache, fetch->file_path, 
+                                               fetch->expression, &start, &scope, 
+                                               fetch->output);
+      if (priv->update_id == 0)
+        priv->update_id = g_idle_add ((GSourceFunc) update_idle, fetch->signature);
+    }
+  
+  if (fetch->offset > 0)
+    cancel_fetch (fetch->signature);
+  
+  return FALSE;
+}
+
+static void
+destroy_fetch (Fetch *fetch)
+{
+  g_object_unref (fetch->signature);
+  g_object_unref (fetch->cancellable);
+  g_free (fetch->file_path);
+  g_free (fetch->expression);
+  g_free (fetch->output);
+  g_free (fetch);
+}
+
+static void
+cancel_fetch (JavaSignature *signature)
+{
+  JavaSignaturePrivate *priv;
+  priv = JAVA_SIGNATURE_GET_PRIVATE (signature);
+  
+  if (priv->fetch == NULL)
+    return;
+  
+  g_cancellable_cancel (priv->fetch);
+  g_object_unref (priv->fetch);
+  priv->fetch = NULL;
+  
+  if (!gtk_text_mark_get_deleted (priv->fetch_mark))
+    gtk_text_buffer_delete_mark (gtk_text_mark_get_buffer (priv->fetch_mark), 
+                                 priv->fetch_mark);
+  priv->fetch_mark = NULL;
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __JAVA_SIGNATURE_H__
+#define	__JAVA_SIGNATURE_H__
+
+#include <gtk/gtk.h>
+#include <codeslayer/codeslayer.h>
+#include "java-client.h"
+#include "java-completion-cache.h"
+
+G_BEGIN_DECLS
+
+#define JAVA_SIGNATURE_TYPE            (java_signature_get_type ())
+#define JAVA_SIGNATURE(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), JAVA_SIGNATURE_TYPE, JavaSignature))
+#define JAVA_SIGNATURE_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), JAVA_SIGNATURE_TYPE, JavaSignatureClass))
+#define IS_JAVA_SIGNATURE(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), JAVA_SIGNATURE_TYPE))
+#define IS_JAVA_SIGNATURE_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), JAVA_SIGNATURE_TYPE))
+
+typedef struct _JavaSignature JavaSignature;
+typedef struct _JavaSignatureClass JavaSignatureClass;
+
+struct _JavaSignature
+{
+  GObject parent_instance;
+};
+
+struct _JavaSignatureClass
+{
+  GObjectClass parent_class;
+};
+
+GType java_signature_get_type (void) G_GNUC_CONST;
+
+JavaSignature*  java_signature_new  (CodeSlayer          *codeslayer, 
+                                     CodeSlayerEditor    *editor, 
+                                     JavaClient          *client, 
+                                     JavaCompletionCache *cache);
+
+G_END_DECLS
+
+#endif /* __JAVA_SIGNATURE_H__ */
@@ -0,0 +1,513 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+#include <glib/gstdio.h>
+#include <codeslayer/codeslayer-utils.h>
+#include "java-suppressions.h"
+
+typedef struct
+{
+  gchar *text;
+  gchar *pattern;
+  guint  count;
+} Rule;
+
+static void java_suppressions_class_init  (JavaSuppressionsClass *klass);
+static void java_suppressions_init        (JavaSuppressions      *suppressions);
+static void java_suppressions_finalize    (JavaSuppressions      *suppressions);
+
+static void clear_rules                   (JavaSuppressions      *suppressions);
+static void add_rule                      (JavaSuppressions      *suppressions, 
+                                           const gchar           *line);
+static void compile_globs                 (JavaSuppressions      *suppressions);
+static gchar* glob_to_regex               (const gchar           *glob);
+static Rule* find_prefix                  (JavaSuppressions      *suppressions, 
+                                           const gchar           *class_name);
+static Rule* find_glob                    (JavaSuppressions      *suppressions, 
+                                           const gchar           *class_name);
+static void destroy_rule                  (Rule                  *rule);
+
+#define JAVA_SUPPRESSIONS_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), JAVA_SUPPRESSIONS_TYPE, JavaSuppressionsPrivate))
+
+typedef struct _JavaSuppressionsPrivate JavaSuppressionsPrivate;
+
+struct _JavaSuppressionsPrivate
+{
+  gchar      *file_path;
+  time_t      mtime;
+  GList      *rules;
+  GHashTable *suppressed;
+  GHashTable *prefixes;
+  GPtrArray  *globs;
+  GRegex     *regex;
+  GString    *scratch;
+  guint       count;
+  GMutex      mutex;
+};
+
+G_DEFINE_TYPE (JavaSuppressions, java_suppressions, G_TYPE_OBJECT)
+
+static void 
+java_suppressions_class_init (JavaSuppressionsClass *klass)
+{
+  G_OBJECT_CLASS (klass)->finalize = (GObjectFinalizeFunc) java_suppressions_finalize;
+  g_type_class_add_private (klass, sizeof (JavaSuppressionsPrivate));
+}
+
+static void
+java_suppressions_init (JavaSuppressions *suppressions)
+{
+  JavaSuppressionsPrivate *priv;
+  priv = JAVA_SUPPRESSIONS_GET_PRIVATE (suppressions);
+  priv->file_path = NULL;
+  priv->mtime = 0;
+  priv->rules = NULL;
+  priv->suppressed = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  priv->prefixes = g_hash_table_new (g_str_hash, g_str_equal);
+  priv->globs = g_ptr_array_new ();
+  priv->regex = NULL;
+  priv->scratch = g_string_new ("");
+  priv->count = 0;
+  g_mutex_init (&priv->mutex);
+}
+
+static void
+java_suppressions_finalize (JavaSuppressions *suppressions)
+{
+  JavaSuppressionsPrivate *priv;
+  priv = JAVA_SUPPRESSIONS_GET_PRIVATE (suppressions);
+  
+  clear_rules (suppressions);
+  
+  g_hash_table_destroy (priv->suppressed);
+  g_hash_table_destroy (priv->prefixes);
+  g_ptr_array_free (priv->globs, TRUE);
+  g_string_free (priv->scratch, TRUE);
+  g_mutex_clear (&priv->mutex);
+  
+  if (priv->file_path)
+    g_free (priv->file_path);
+
+  G_OBJECT_CLASS (java_suppressions_parent_class)-> finalize (G_OBJECT (suppressions));
+}
+
+JavaSuppressions*
+java_suppressions_new (void)
+{
+  return JAVA_SUPPRESSIONS (g_object_new (java_suppressions_get_type (), NULL));
+}
+
+/*
+ * The suppressions file has one package prefix or glob per line, for example:
+ *
+ * com.sun
+ * org.apache.*
+ * *.internal.*
+ * *Test
+ *
+ * Prefixes go into a hash table keyed on the package, so a class is checked 
+ * with one lookup per package segment no matter how long the list is. Globs 
+ * are compiled into a single regex. The file is only parsed again when it 
+ * has been modified since the last load. The lib indexer uses the rules 
+ * from its own thread, so everything here is done holding the mutex.
+ */
+void
+java_suppressions_load (JavaSuppressions *suppressions, 
+                        const gchar      *file_path)
+{
+  JavaSuppressionsPrivate *priv;
+  GStatBuf stat_buf;
+  time_t mtime = 0;
+  gchar *contents;
+  
+  priv = JAVA_SUPPRESSIONS_GET_PRIVATE (suppressions);
+  
+  if (codeslayer_utils_has_text (file_path) && g_stat (file_path, &stat_buf) == 0)
+    mtime = stat_buf.st_mtime;
+  
+  g_mutex_lock (&priv->mutex);
+  
+  if (g_strcmp0 (priv->file_path, file_path) == 0 && priv->mtime == mtime)
+    {
+      g_mutex_unlock (&priv->mutex);
+      return;
+    }
+    
+  clear_rules (suppressions);
+  
+  if (priv->file_path)
+    g_free (priv->file_path);
+  
+  priv->file_path = g_strdup (file_path);
+  priv->mtime = mtime;
+  
+  if (mtime != 0 && g_file_get_contents (file_path, &contents, NULL, NULL))
+    {
+      gchar **split;
+      gchar **tmp;
+      
+      split = g_strsplit (contents, "\n", -1);
+      for (tmp = split; *tmp != NULL; tmp++)
+        {
+          if (**tmp == '\0' && *(tmp + 1) == NULL)
+            break;
+          add_rule (suppressions, *tmp);
+        }
+      
+      g_strfreev (split);
+      g_free (contents);
+    }
+    
+  priv->rules = g_list_reverse (priv->rules);
+  compile_globs (suppressions);
+  
+  g_mutex_unlock (&priv->mutex);
+}
+
+gboolean
+java_suppressions_is_empty (JavaSuppressions *suppressions)
+{
+  JavaSuppressionsPrivate *priv;
+  gboolean result;
+  
+  priv = JAVA_SUPPRESSIONS_GET_PRIVATE (suppressions);
+  
+  g_mutex_lock (&priv->mutex);
+  result = priv->rules == NULL;
+  g_mutex_unlock (&priv->mutex);
+  
+  return result;
+}
+
+/*
+ * A class is only counted once per load however many times it is looked 
+ * up, so the counts say how many classes each rule kept out of the indexes.
+ */
+gboolean
+java_suppressions_match (JavaSuppressions *suppressions, 
+                         const gchar      *class_name)
+{
+  JavaSuppressionsPrivate *priv;
+  Rule *rule;
+  
+  priv = JAVA_SUPPRESSIONS_GET_PRIVATE (suppressions);
+  
+  if (class_name == NULL)
+    return FALSE;
+  
+  g_mutex_lock (&priv->mutex);
+  
+  rule = find_prefix (suppressions, class_name);
+  
+  if (rule == NULL)
+    rule = find_glob (suppressions, class_name);
+  
+  if (rule != NULL && !g_hash_table_lookup_extended (priv->suppressed, class_name, NULL, NULL))
+    {
+      g_hash_table_insert (priv->suppressed, g_strdup (class_name), NULL);
+      rule->count++;
+      priv->count++;
+    }
+    
+  g_mutex_unlock (&priv->mutex);
+  
+  return rule != NULL;
+}
+
+guint
+java_suppressions_get_count (JavaSuppressions *suppressions)
+{
+  JavaSuppressionsPrivate *priv;
+  guint result;
+  
+  priv = JAVA_SUPPRESSIONS_GET_PRIVATE (suppressions);
+  
+  g_mutex_lock (&priv->mutex);
+  result = priv->count;
+  g_mutex_unlock (&priv->mutex);
+  
+  return result;
+}
+
+/*
+ * Returns a list of "pattern\tcount" lines for every rule that has 
+ * suppressed something. Free with g_list_free_full (list, g_free).
+ */
+GList*
+java_suppressions_get_counts (JavaSuppressions *suppressions)
+{
+  JavaSuppressionsPrivate *priv;
+  GList *results = NULL;
+  GList *list;
+  
+  priv = JAVA_SUPPRESSIONS_GET_PRIVATE (suppressions);
+  
+  g_mutex_lock (&priv->mutex);
+  
+  for (list = priv->rules; list != NULL; list = list->next)
+    {
+      Rule *rule = list->data;
+      if (rule->count > 0)
+        results = g_list_prepend (results, g_strdup_printf ("%s\t%u", rule->text, rule->count));
+    }
+    
+  g_mutex_unlock (&priv->mutex);
+    
+  return g_list_reverse (results);
+}
+
+static void
+clear_rules (JavaSuppressions *suppressions)
+{
+  JavaSuppressionsPrivate *priv;
+  priv = JAVA_SUPPRESSIONS_GET_PRIVATE (suppressions);
+  
+  g_hash_table_remove_all (priv->prefixes);
+  g_ptr_array_set_size (priv->globs, 0);
+  g_hash_table_remove_all (priv->suppressed);
+  
+  if (priv->regex)
+    {
+      g_regex_unref (priv->regex);
+      priv->regex = NULL;
+    }
+  
+  if (priv->rules)
+    {
+      g_list_free_full (priv->rules, (GDestroyNotify) destroy_rule);
+      priv->rules = NULL;
+    }
+  
+  priv->count = 0;
+}
+
+static void
+add_rule (JavaSuppressions *suppressions, 
+          const gchar      *line)
+{
+  JavaSuppressionsPrivate *priv;
+  gchar *pattern;
+  Rule *rule;
+  
+  priv = JAVA_SUPPRESSIONS_GET_PRIVATE (suppressions);
+  
+  pattern = g_strstrip (g_strdup (line));
+  
+  if (*pattern == '\0' || *pattern == '#')
+    {
+      g_free (pattern);
+      return;
+    }
+  
+  rule = g_malloc (sizeof (Rule));
+  rule->text = g_strdup (pattern);
+  rule->count = 0;
+  
+  if (g_str_has_suffix (pattern, ".*") || g_str_has_suffix (pattern, "."))
+    {
+      gchar *package;
+      package = g_strndup (pattern, strlen (pattern) - (g_str_has_suffix (pattern, "*") ? 2 : 1));
+      
+      if (*package != '\0' && strchr (package, '*') == NULL && strchr (package, '?') == NULL)
+        {
+          g_free (pattern);
+          pattern = package;
+        }
+      else
+        {
+          g_free (package);
+        }
+    }
+  
+  rule->pattern = pattern;
+
+  if (strchr (pattern, '*') != NULL || strchr (pattern, '?') != NULL)
+    {
+      g_ptr_array_add (priv->globs, rule);
+    }
+  else if (find_prefix (suppressions, pattern) == NULL)
+    {
+      g_hash_table_insert (priv->prefixes, pattern, rule);
+    }
+  else
+    {
+      destroy_rule (rule);
+      return;
+    }
+
+  priv->rules = g_list_prepend (priv->rules, rule);
+}
+
+/*
+ * All the globs end up in one anchored alternation with a group per glob, 
+ * which says what rule matched without trying the globs one at a time.
+ */
+static void
+compile_globs (JavaSuppressions *suppressions)
+{
+  JavaSuppressionsPrivate *priv;
+  GString *string;
+  GError *error = NULL;
+  guint i;
+  
+  priv = JAVA_SUPPRESSIONS_GET_PRIVATE (suppressions);
+  
+  if (priv->globs->len == 0)
+    return;
+    
+  string = g_string_new ("^(?:");
+  
+  for (i = 0; i < priv->globs->len; i++)
+    {
+      Rule *rule = g_ptr_array_index (priv->globs, i);
+      gchar *regex;
+      
+      regex = glob_to_regex (rule->pattern);
+      
+      if (i > 0)
+        string = g_string_append_c (string, '|');
+      
+      g_string_append_printf (string, "(%s)", regex);
+      g_free (regex);
+    }
+
+  string = g_string_append (string, ")$");
+  
+  priv->regex = g_regex_new (string->str, G_REGEX_OPTIMIZE, 0, &error);
+  
+  if (error != NULL)
+    {
+      g_warning ("suppressions regex: %s", error->message);
+      g_error_free (error);
+    }
+  
+  g_string_free (string, TRUE);
+}
+
+static gchar*
+glob_to_regex (const gchar *glob)
+{
+  GString *string;
+  const gchar *start;
+  const gchar *end;
+  
+  string = g_string_new ("");
+  
+  start = glob;
+  
+  while (*start != '\0')
+    {
+      gchar *escaped;
+      
+      end = start + strcspn (start, "*?");
+      
+      escaped = g_regex_escape_string (start, end - start);
+      string = g_string_append (string, escaped);
+      g_free (escaped);
+      
+      if (*end == '*')
+        string = g_string_append (string, ".*");
+      else if (*end == '?')
+        string = g_string_append_c (string, '.');
+      else
+        break;
+        
+      start = end + 1;
+    }
+  
+  return g_string_free (string, FALSE);
+}
+
+/*
+ * Looks up every package of the class, shortest first, so that a rule 
+ * like com.sun matches com.sun.Foo and com.sun.tools.Bar but not 
+ * com.sunny.Baz.
+ */
+static Rule*
+find_prefix (JavaSuppressions *suppressions, 
+             const gchar      *class_name)
+{
+  JavaSuppressionsPrivate *priv;
+  gchar *str;
+  gchar *dot;
+  Rule *rule;
+  
+  priv = JAVA_SUPPRESSIONS_GET_PRIVATE (suppressions);
+  
+  if (g_hash_table_size (priv->prefixes) == 0)
+    return NULL;
+  
+  g_string_assign (priv->scratch, class_name);
+  str = priv->scratch->str;
+  
+  for (dot = strchr (str, '.'); dot != NULL; dot = strchr (dot + 1, '.'))
+    {
+      *dot = '\0';
+      rule = g_hash_table_lookup (priv->prefixes, str);
+      *dot = '.';
+      
+      if (rule != NULL)
+        return rule;
+    }
+  
+  return g_hash_table_lookup (priv->prefixes, str);
+}
+
+static Rule*
+find_glob (JavaSuppressions *suppressions, 
+           const gchar      *class_name)
+{
+  JavaSuppressionsPrivate *priv;
+  GMatchInfo *match_info;
+  Rule *rule = NULL;
+  
+  priv = JAVA_SUPPRESSIONS_GET_PRIVATE (suppressions);
+  
+  if (priv->regex == NULL)
+    return NULL;
+  
+  if (g_regex_match (priv->regex, class_name, 0, &match_info))
+    {
+      guint i;
+      for (i = 0; i < priv->globs->len; i++)
+        {
+          gint start;
+          gint end;
+          
+          if (g_match_info_fetch_pos (match_info, i + 1, &start, &end) && start != -1)
+            {
+              rule = g_ptr_array_index (priv->globs, i);
+              break;
+            }
+        }
+    }
+  
+  g_match_info_free (match_info);
+  
+  return rule;
+}
+
+static void
+destroy_rule (Rule *rule)
+{
+  g_free (rule->text);
+  g_free (rule->pattern);
+  g_free (rule);
+}
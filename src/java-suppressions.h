@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __JAVA_SUPPRESSIONS_H__
+#define	__JAVA_SUPPRESSIONS_H__
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+#define JAVA_SUPPRESSIONS_TYPE            (java_suppressions_get_type ())
+#define JAVA_SUPPRESSIONS(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), JAVA_SUPPRESSIONS_TYPE, JavaSuppressions))
+#define JAVA_SUPPRESSIONS_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), JAVA_SUPPRESSIONS_TYPE, JavaSuppressionsClass))
+#define IS_JAVA_SUPPRESSIONS(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), JAVA_SUPPRESSIONS_TYPE))
+#define IS_JAVA_SUPPRESSIONS_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), JAVA_SUPPRESSIONS_TYPE))
+
+typedef struct _JavaSuppressions JavaSuppressions;
+typedef struct _JavaSuppressionsClass JavaSuppressionsClass;
+
+struct _JavaSuppressions
+{
+  GObject parent_instance;
+};
+
+struct _JavaSuppressionsClass
+{
+  GObjectClass parent_class;
+};
+
+GType java_suppressions_get_type (void) G_GNUC_CONST;
+
+JavaSuppressions*  java_suppressions_new           (void);
+
+void               java_suppressions_load          (JavaSuppressions *suppressions,
+                                                    const gchar      *file_path);
+gboolean           java_suppressions_is_empty      (JavaSuppressions *suppressions);
+gboolean           java_suppressions_match         (JavaSuppressions *suppressions,
+                                                    const gchar      *class_name);
+guint              java_suppressions_get_count     (JavaSuppressions *suppressions);
+GList*             java_suppressions_get_counts    (JavaSuppressions *suppressions);
+
+G_END_DECLS
+
+#endif /* __JAVA_SUPPRESSIONS_H__ */
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <codeslayer/codeslayer-utils.h>
+#include "java-symbol-search.h"
+#include "java-search-dialog.h"
+
+/*
+ * Finds the methods, fields and constants of every class in the indexes. 
+ * They are matched in the same dialog as Class Search, which opens the 
+ * file of the member at its line.
+ */
+
+static void java_symbol_search_class_init  (JavaSymbolSearchClass *klass);
+static void java_symbol_search_init        (JavaSymbolSearch      *search);
+static void java_symbol_search_finalize    (JavaSymbolSearch      *search);
+
+static void search_action                  (JavaSymbolSearch      *search);
+static void render_output                  (JavaMatcher           *matcher, 
+                                            gchar                 *output, 
+                                            JavaSuppressions      *suppressions);
+static void render_line                    (JavaMatcher           *matcher, 
+                                            gchar                 *line, 
+                                            JavaSuppressions      *suppressions, 
+                                            GString               *qualified);
+
+#define FIELDS 5
+
+#define JAVA_SYMBOL_SEARCH_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), JAVA_SYMBOL_SEARCH_TYPE, JavaSymbolSearchPrivate))
+
+typedef struct _JavaSymbolSearchPrivate JavaSymbolSearchPrivate;
+
+struct _JavaSymbolSearchPrivate
+{
+  JavaSearchDialog *dialog;
+};
+
+G_DEFINE_TYPE (JavaSymbolSearch, java_symbol_search, G_TYPE_OBJECT)
+
+static void 
+java_symbol_search_class_init (JavaSymbolSearchClass *klass)
+{
+  G_OBJECT_CLASS (klass)->finalize = (GObjectFinalizeFunc) java_symbol_search_finalize;
+  g_type_class_add_private (klass, sizeof (JavaSymbolSearchPrivate));
+}
+
+static void
+java_symbol_search_init (JavaSymbolSearch *search) {}
+
+static void
+java_symbol_search_finalize (JavaSymbolSearch *search)
+{
+  JavaSymbolSearchPrivate *priv;
+  priv = JAVA_SYMBOL_SEARCH_GET_PRIVATE (search);
+  g_object_unref (priv->dialog);
+  G_OBJECT_CLASS (java_symbol_search_parent_class)-> finalize (G_OBJECT (search));
+}
+
+/*
+ * Each line that the server sends back holds the name of the member, its 
+ * signature, the class it is declared in, the file of that class and the 
+ * line of the member.
+ */
+JavaSymbolSearch*
+java_symbol_search_new (CodeSlayer          *codeslayer,
+                        GtkWidget           *menu, 
+                        JavaIndexer         *indexer, 
+                        JavaToolsProperties *tools_properties)
+{
+  JavaSymbolSearchPrivate *priv;
+  JavaSymbolSearch *search;
+
+  search = JAVA_SYMBOL_SEARCH (g_object_new (java_symbol_search_get_type (), NULL));
+  priv = JAVA_SYMBOL_SEARCH_GET_PRIVATE (search);
+  
+  priv->dialog = java_search_dialog_new (codeslayer, indexer, tools_properties, 
+                                         "Symbol", "symbols", JAVA_RESULTS_DETAIL, 300, 
+                                         render_output);
+
+  g_signal_connect_swapped (G_OBJECT (menu), "symbol-search",
+                            G_CALLBACK (search_action), search);
+
+  return search;
+}
+
+static void
+search_action (JavaSymbolSearch *search)
+{
+  JavaSymbolSearchPrivate *priv;
+  priv = JAVA_SYMBOL_SEARCH_GET_PRIVATE (search);
+  java_search_dialog_run (priv->dialog);
+}
+
+static void
+render_output (JavaMatcher      *matcher, 
+               gchar            *output, 
+               JavaSuppressions *suppressions)
+{
+  GString *qualified;
+  gchar *line;
+  gchar *next;
+  
+  qualified = g_string_new ("");
+  
+  for (line = output; line != NULL; line = next)
+    {
+      next = strchr (line, '\n');
+      if (next != NULL)
+        *next++ = '\0';
+      render_line (matcher, line, suppressions, qualified);
+    }
+  
+  g_string_free (qualified, TRUE);
+}
+
+/*
+ * The line is cut up in place, and the qualified name is put together in 
+ * the same string every time.
+ */
+static void
+render_line (JavaMatcher      *matcher, 
+             gchar            *line, 
+             JavaSuppressions *suppressions, 
+             GString          *qualified)
+{
+  gchar *fields[FIELDS];
+  gint i;
+  
+  if (!codeslayer_utils_has_text (line))
+    return;
+  
+  fields[0] = line;
+  for (i = 1; i < FIELDS; i++)
+    {
+      gchar *tab = strchr (fields[i - 1], '\t');
+      if (tab == NULL)
+        return;
+      *tab = '\0';
+      fields[i] = tab + 1;
+    }
+  
+  if (java_suppressions_match (suppressions, fields[2]))
+    return;
+  
+  g_string_assign (qualified, fields[2]);
+  g_string_append_c (qualified, '.');
+  g_string_append (qualified, fields[0]);
+  
+  java_matcher_add_member (matcher, fields[0], qualified->str, 
+                           fields[3], fields[1], atoi (fields[4]));
+}
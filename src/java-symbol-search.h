@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __JAVA_SYMBOL_SEARCH_H__
+#define	__JAVA_SYMBOL_SEARCH_H__
+
+#include <gtk/gtk.h>
+#include <codeslayer/codeslayer.h>
+#include "java-tools-properties.h"
+#include "java-indexer.h"
+
+G_BEGIN_DECLS
+
+#define JAVA_SYMBOL_SEARCH_TYPE            (java_symbol_search_get_type ())
+#define JAVA_SYMBOL_SEARCH(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), JAVA_SYMBOL_SEARCH_TYPE, JavaSymbolSearch))
+#define JAVA_SYMBOL_SEARCH_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), JAVA_SYMBOL_SEARCH_TYPE, JavaSymbolSearchClass))
+#define IS_JAVA_SYMBOL_SEARCH(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), JAVA_SYMBOL_SEARCH_TYPE))
+#define IS_JAVA_SYMBOL_SEARCH_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), JAVA_SYMBOL_SEARCH_TYPE))
+
+typedef struct _JavaSymbolSearch JavaSymbolSearch;
+typedef struct _JavaSymbolSearchClass JavaSymbolSearchClass;
+
+struct _JavaSymbolSearch
+{
+  GObject parent_instance;
+};
+
+struct _JavaSymbolSearchClass
+{
+  GObjectClass parent_class;
+};
+
+GType java_symbol_search_get_type (void) G_GNUC_CONST;
+     
+JavaSymbolSearch*  java_symbol_search_new  (CodeSlayer          *codeslayer,
+                                            GtkWidget           *menu, 
+                                            JavaIndexer         *indexer, 
+                                            JavaToolsProperties *tools_properties);
+                                     
+G_END_DECLS
+
+#endif /* __JAVA_SYMBOL_SEARCH_H__ */
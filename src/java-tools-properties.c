@@ -17,6 +17,7 @@
  */
 
 #include "java-tools-properties.h"
+#include "java-suppressions.h"
 
 static void java_tools_properties_class_init  (JavaToolsPropertiesClass *klass);
 static void java_tools_properties_init        (JavaToolsProperties      *tools_properties);
@@ -38,6 +39,10 @@ static gboolean verify_conf_exists            (JavaToolsProperties       *tools_
 #define JAVA_TOOLS_PROPERTIES_FILE "java-tools.properties"
 #define JDK_FOLDER "jdk_folder"
 #define SUPPRESSIONS_FILE "suppressions_file"                                           
+#define INDEXER_THREADS "indexer_threads"
+#define INDEXER_NICE "indexer_nice"
+#define INDEXER_IO_PRIORITY "indexer_io_priority"
+#define WORD_COMPLETION "word_completion"
 #define MAIN "main"                                           
 
 #define JAVA_TOOLS_PROPERTIES_GET_PRIVATE(obj) \
@@ -52,9 +57,21 @@ struct _JavaToolsPropertiesPrivate
   GtkWidget  *dialog;
   GtkWidget  *jdk_folder_entry;
   GtkWidget  *suppressions_file_entry;  
+  GtkWidget  *indexer_threads_spin;  
+  GtkWidget  *indexer_nice_spin;  
+  GtkWidget  *indexer_io_priority_combo;  
+  GtkWidget  *word_completion_combo;  
   GKeyFile   *keyfile;  
+  JavaSuppressions *suppressions;
+  gchar      *word_completion;
 };
 
+static const gchar *io_priorities[] = {"normal", "low", "idle", NULL};
+static const gchar *word_completions[] = {"editor", "Current Editor", 
+                                          "editors", "Open Editors", 
+                                          "projects", "Open Editors and Projects", 
+                                          NULL};
+
 G_DEFINE_TYPE (JavaToolsProperties, java_tools_properties, G_TYPE_OBJECT)
 
 static void
@@ -72,6 +89,8 @@ java_tools_properties_init (JavaToolsProperties *tools_properties)
   priv = JAVA_TOOLS_PROPERTIES_GET_PRIVATE (tools_properties);
   priv->dialog = NULL;
   priv->keyfile = NULL;
+  priv->suppressions = java_suppressions_new ();
+  priv->word_completion = NULL;
 }
 
 static void
@@ -88,6 +107,9 @@ java_tools_properties_finalize (JavaToolsProperties *tools_properties)
       g_key_file_free (priv->keyfile);
       priv->keyfile = NULL;
     }
+    
+  g_object_unref (priv->suppressions);
+  g_free (priv->word_completion);
 
   G_OBJECT_CLASS (java_tools_properties_parent_class)->finalize (G_OBJECT(tools_properties));
 }
@@ -139,6 +161,112 @@ java_tools_properties_get_suppressions_file (JavaToolsProperties *tools_properti
   return NULL;    
 }
 
+/*
+ * The compiled suppressions file that the indexer, search and import share. 
+ * It is checked against the file on disk each time it is handed out, so 
+ * edits to the file are picked up without having to save the properties.
+ */
+JavaSuppressions*
+java_tools_properties_get_suppressions (JavaToolsProperties *tools_properties)
+{
+  JavaToolsPropertiesPrivate *priv;
+  gchar *suppressions_file;
+  
+  priv = JAVA_TOOLS_PROPERTIES_GET_PRIVATE (tools_properties);
+  
+  suppressions_file = g_key_file_get_string (priv->keyfile, MAIN, SUPPRESSIONS_FILE, NULL);
+  java_suppressions_load (priv->suppressions, suppressions_file);
+  g_free (suppressions_file);
+  
+  return priv->suppressions;
+}
+
+/*
+ * The maximum number of threads the server may use to index with. 
+ * Zero lets the server decide.
+ */
+gint
+java_tools_properties_get_indexer_threads (JavaToolsProperties *tools_properties)
+{
+  JavaToolsPropertiesPrivate *priv;
+  priv = JAVA_TOOLS_PROPERTIES_GET_PRIVATE (tools_properties);
+  
+  if (g_key_file_has_key (priv->keyfile, MAIN, INDEXER_THREADS, NULL))
+    return g_key_file_get_integer (priv->keyfile, MAIN, INDEXER_THREADS, NULL);
+    
+  return 0;    
+}
+
+gint
+java_tools_properties_get_indexer_nice (JavaToolsProperties *tools_properties)
+{
+  JavaToolsPropertiesPrivate *priv;
+  priv = JAVA_TOOLS_PROPERTIES_GET_PRIVATE (tools_properties);
+  
+  if (g_key_file_has_key (priv->keyfile, MAIN, INDEXER_NICE, NULL))
+    return g_key_file_get_integer (priv->keyfile, MAIN, INDEXER_NICE, NULL);
+    
+  return 0;    
+}
+
+/*
+ * One of normal, low or idle, or NULL when it is not set or not one of 
+ * them. The string is static.
+ */
+const gchar*
+java_tools_properties_get_indexer_io_priority (JavaToolsProperties *tools_properties)
+{
+  JavaToolsPropertiesPrivate *priv;
+  const gchar **io_priority;
+  gchar *value;
+  
+  priv = JAVA_TOOLS_PROPERTIES_GET_PRIVATE (tools_properties);
+  
+  value = g_key_file_get_string (priv->keyfile, MAIN, INDEXER_IO_PRIORITY, NULL);
+  if (value == NULL)
+    return NULL;
+  
+  for (io_priority = io_priorities; *io_priority != NULL; io_priority++)
+    {
+      if (g_strcmp0 (*io_priority, value) == 0)
+        break;
+    }
+  
+  g_free (value);
+    
+  return *io_priority;    
+}
+
+/*
+ * Where word completion finds its words: editor for the current editor, 
+ * editors for all the open editors, or projects for the open editors as 
+ * well as the source files of the projects. This is asked for on every 
+ * completion, so the string is kept and belongs to the tools properties.
+ */
+const gchar*
+java_tools_properties_get_word_completion (JavaToolsProperties *tools_properties)
+{
+  JavaToolsPropertiesPrivate *priv;
+  gchar *word_completion = NULL;
+  
+  priv = JAVA_TOOLS_PROPERTIES_GET_PRIVATE (tools_properties);
+  
+  if (g_key_file_has_key (priv->keyfile, MAIN, WORD_COMPLETION, NULL))
+    word_completion = g_key_file_get_string (priv->keyfile, MAIN, WORD_COMPLETION, NULL);
+  
+  if (g_strcmp0 (word_completion, priv->word_completion) == 0)
+    {
+      g_free (word_completion);
+    }
+  else
+    {
+      g_free (priv->word_completion);
+      priv->word_completion = word_completion;
+    }
+    
+  return priv->word_completion;    
+}
+
 static void
 properties_action (JavaToolsProperties *tools_properties)
 {
@@ -155,6 +283,16 @@ properties_action (JavaToolsProperties *tools_properties)
       GtkWidget *jdk_folder_label;
       GtkWidget  *suppressions_file_entry;  
       GtkWidget *suppressions_file_label;
+      GtkWidget *indexer_threads_spin;
+      GtkWidget *indexer_threads_label;
+      GtkWidget *indexer_nice_spin;
+      GtkWidget *indexer_nice_label;
+      GtkWidget *indexer_io_priority_combo;
+      GtkWidget *indexer_io_priority_label;
+      GtkWidget *word_completion_combo;
+      GtkWidget *word_completion_label;
+      const gchar **io_priority;
+      const gchar **word_completion;
       
       priv->dialog = gtk_dialog_new_with_buttons ("Properties", 
                                                   codeslayer_get_toplevel_window (priv->codeslayer),
@@ -198,6 +336,57 @@ properties_action (JavaToolsProperties *tools_properties)
       gtk_grid_attach_next_to (GTK_GRID (grid), suppressions_file_entry, suppressions_file_label, 
                                GTK_POS_RIGHT, 1, 1);
                         
+      indexer_threads_label = gtk_label_new ("Indexer Threads:");
+      gtk_misc_set_alignment (GTK_MISC (indexer_threads_label), 1, .50);
+      gtk_misc_set_padding (GTK_MISC (indexer_threads_label), 4, 0);
+      gtk_grid_attach (GTK_GRID (grid), indexer_threads_label, 0, 2, 1, 1);
+
+      indexer_threads_spin = gtk_spin_button_new_with_range (0, 64, 1);
+      priv->indexer_threads_spin = indexer_threads_spin;
+      gtk_widget_set_tooltip_text (indexer_threads_spin, "0 lets the server decide");
+      gtk_widget_set_halign (indexer_threads_spin, GTK_ALIGN_START);
+      gtk_grid_attach_next_to (GTK_GRID (grid), indexer_threads_spin, indexer_threads_label, 
+                               GTK_POS_RIGHT, 1, 1);
+                        
+      indexer_nice_label = gtk_label_new ("Indexer Nice Level:");
+      gtk_misc_set_alignment (GTK_MISC (indexer_nice_label), 1, .50);
+      gtk_misc_set_padding (GTK_MISC (indexer_nice_label), 4, 0);
+      gtk_grid_attach (GTK_GRID (grid), indexer_nice_label, 0, 3, 1, 1);
+
+      indexer_nice_spin = gtk_spin_button_new_with_range (0, 19, 1);
+      priv->indexer_nice_spin = indexer_nice_spin;
+      gtk_widget_set_halign (indexer_nice_spin, GTK_ALIGN_START);
+      gtk_grid_attach_next_to (GTK_GRID (grid), indexer_nice_spin, indexer_nice_label, 
+                               GTK_POS_RIGHT, 1, 1);
+                        
+      indexer_io_priority_label = gtk_label_new ("Indexer I/O Priority:");
+      gtk_misc_set_alignment (GTK_MISC (indexer_io_priority_label), 1, .50);
+      gtk_misc_set_padding (GTK_MISC (indexer_io_priority_label), 4, 0);
+      gtk_grid_attach (GTK_GRID (grid), indexer_io_priority_label, 0, 4, 1, 1);
+
+      indexer_io_priority_combo = gtk_combo_box_text_new ();
+      priv->indexer_io_priority_combo = indexer_io_priority_combo;
+      for (io_priority = io_priorities; *io_priority != NULL; io_priority++)
+        gtk_combo_box_text_append (GTK_COMBO_BOX_TEXT (indexer_io_priority_combo), 
+                                   *io_priority, *io_priority);
+      gtk_widget_set_halign (indexer_io_priority_combo, GTK_ALIGN_START);
+      gtk_grid_attach_next_to (GTK_GRID (grid), indexer_io_priority_combo, indexer_io_priority_label, 
+                               GTK_POS_RIGHT, 1, 1);
+                        
+      word_completion_label = gtk_label_new ("Word Completion:");
+      gtk_misc_set_alignment (GTK_MISC (word_completion_label), 1, .50);
+      gtk_misc_set_padding (GTK_MISC (word_completion_label), 4, 0);
+      gtk_grid_attach (GTK_GRID (grid), word_completion_label, 0, 5, 1, 1);
+
+      word_completion_combo = gtk_combo_box_text_new ();
+      priv->word_completion_combo = word_completion_combo;
+      for (word_completion = word_completions; *word_completion != NULL; word_completion += 2)
+        gtk_combo_box_text_append (GTK_COMBO_BOX_TEXT (word_completion_combo), 
+                                   word_completion[0], word_completion[1]);
+      gtk_widget_set_halign (word_completion_combo, GTK_ALIGN_START);
+      gtk_grid_attach_next_to (GTK_GRID (grid), word_completion_combo, word_completion_label, 
+                               GTK_POS_RIGHT, 1, 1);
+                        
       gtk_box_pack_start (GTK_BOX (content_area), grid, TRUE, TRUE, 0);
       gtk_widget_show_all (content_area);
       
@@ -220,6 +409,20 @@ properties_action (JavaToolsProperties *tools_properties)
                         g_key_file_get_string (priv->keyfile, MAIN, SUPPRESSIONS_FILE, NULL));
     }
 
+  gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->indexer_threads_spin), 
+                             java_tools_properties_get_indexer_threads (tools_properties));
+
+  gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->indexer_nice_spin), 
+                             java_tools_properties_get_indexer_nice (tools_properties));
+
+  if (!gtk_combo_box_set_active_id (GTK_COMBO_BOX (priv->indexer_io_priority_combo), 
+                                    java_tools_properties_get_indexer_io_priority (tools_properties)))
+    gtk_combo_box_set_active (GTK_COMBO_BOX (priv->indexer_io_priority_combo), 0);
+
+  if (!gtk_combo_box_set_active_id (GTK_COMBO_BOX (priv->word_completion_combo), 
+                                    java_tools_properties_get_word_completion (tools_properties)))
+    gtk_combo_box_set_active (GTK_COMBO_BOX (priv->word_completion_combo), 0);
+
   response = gtk_dialog_run (GTK_DIALOG (priv->dialog));
   if (response == GTK_RESPONSE_OK)
     {
@@ -340,6 +543,18 @@ save_tools_properties (JavaToolsProperties *tools_properties)
   g_key_file_set_string (priv->keyfile, MAIN, SUPPRESSIONS_FILE, 
                          gtk_entry_get_text (GTK_ENTRY (priv->suppressions_file_entry)));
 
+  g_key_file_set_integer (priv->keyfile, MAIN, INDEXER_THREADS, 
+                          gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (priv->indexer_threads_spin)));
+
+  g_key_file_set_integer (priv->keyfile, MAIN, INDEXER_NICE, 
+                          gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (priv->indexer_nice_spin)));
+
+  g_key_file_set_string (priv->keyfile, MAIN, INDEXER_IO_PRIORITY, 
+                         gtk_combo_box_get_active_id (GTK_COMBO_BOX (priv->indexer_io_priority_combo)));
+
+  g_key_file_set_string (priv->keyfile, MAIN, WORD_COMPLETION, 
+                         gtk_combo_box_get_active_id (GTK_COMBO_BOX (priv->word_completion_combo)));
+
   data = g_key_file_to_data (priv->keyfile, &size, NULL);
 
   conf_path = get_conf_path (tools_properties);
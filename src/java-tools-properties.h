@@ -21,6 +21,7 @@
 
 #include <gtk/gtk.h>
 #include <codeslayer/codeslayer.h>
+#include "java-suppressions.h"
 
 G_BEGIN_DECLS
 
@@ -43,14 +44,19 @@ struct _JavaToolsPropertiesClass
   GObjectClass parent_class;
 };
 
-GType java_tools_properties_get_type (void) G_GNUC_CONST;
+GType                 java_tools_properties_get_type                 (void) G_GNUC_CONST;
 
-JavaToolsProperties*  java_tools_properties_new                    (CodeSlayer *codeslayer,
-                                                                    GtkWidget  *menu);
+JavaToolsProperties*  java_tools_properties_new                      (CodeSlayer *codeslayer,
+                                                                     GtkWidget  *menu);
                                 
-void                  java_tools_properties_load                   (JavaToolsProperties *tools_properties);
-const gchar*          java_tools_properties_get_jdk_folder         (JavaToolsProperties *tools_properties);
-const gchar*          java_tools_properties_get_suppressions_file  (JavaToolsProperties *tools_properties);
+void                  java_tools_properties_load                     (JavaToolsProperties *tools_properties);
+const gchar*          java_tools_properties_get_jdk_folder           (JavaToolsProperties *tools_properties);
+const gchar*          java_tools_properties_get_suppressions_file    (JavaToolsProperties *tools_properties);
+JavaSuppressions*     java_tools_properties_get_suppressions         (JavaToolsProperties *tools_properties);
+gint                  java_tools_properties_get_indexer_threads      (JavaToolsProperties *tools_properties);
+gint                  java_tools_properties_get_indexer_nice         (JavaToolsProperties *tools_properties);
+const gchar*          java_tools_properties_get_indexer_io_priority  (JavaToolsProperties *tools_properties);
+const gchar*          java_tools_properties_get_word_completion      (JavaToolsProperties *tools_properties);
                                                   
 G_END_DECLS
 
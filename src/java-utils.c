@@ -19,10 +19,9 @@
 #include <string.h>
 #include <codeslayer/codeslayer-utils.h>
 #include "java-utils.h"
+#include "java-lexer.h"
 
-static gchar* find_path              (gchar *text);
-static gchar* strip_comments         (gchar *text);
-static gchar* strip_path_parameters  (gchar *text);
+#define EXPRESSION_WINDOW 256
 
 gchar*
 java_utils_get_class_name (JavaConfiguration  *configuration,
@@ -54,26 +53,6 @@ java_utils_get_class_name (JavaConfiguration  *configuration,
   return replace;
 }
 
-/*
- * Start at the current place in the editor and get all the previous text.
- * The idea is that any variables that need to be resolved will come 
- * before this place in the editor.
- */
-gchar*
-java_utils_get_text_to_search (GtkTextView *text_view, 
-                               GtkTextIter  iter)
-{
-  GtkTextBuffer *buffer;
-  GtkTextIter start;
-  gchar *text;      
-
-  buffer = gtk_text_view_get_buffer (text_view);      
-  gtk_text_buffer_get_start_iter (buffer, &start);
-  text = gtk_text_buffer_get_text (buffer, &start, &iter, FALSE);
-
-  return text;
-}
-
 void
 java_utils_move_iter_word_start (GtkTextIter *iter)
 {
@@ -188,153 +167,113 @@ java_utils_get_indexes_folder (CodeSlayer *codeslayer)
   return g_string_free (string, FALSE);
 }
 
-gchar*
-java_utils_get_expression (gchar *text)
-{
-  gchar *result = NULL;
-  gchar *comments_stripped;
-  gchar *path;
-  
-  comments_stripped = strip_comments (text);
-  
-  path = find_path (comments_stripped);
-  if (path != NULL)
-    {
-      gchar *parameters_stripped;
-      
-      parameters_stripped = strip_path_parameters (path);
-      parameters_stripped = g_strreverse (parameters_stripped);
-      
-      result = g_strdup (parameters_stripped);
-      
-      g_free (path);
-      g_free (parameters_stripped);
-    }
-    
-  g_free (comments_stripped);
-
-  return result; 
-}
-
 /*
- * Walk backwards and match braces to find the context path.
+ * Walk backwards from the iter and match braces to find the context path.
  *
  * For example at any point in the following path you would be able to 
  * find the context, namely the tableModel, or the presidentService.
  *
  * tableModel.setItems(presidentService.getPresidents())
+ *
+ * Everything between the braces that does not belong to the path is left 
+ * out, so the above becomes tableModel.setItems() when in the context of 
+ * the tableModel. The tokens come from the lexer of the buffer, so string 
+ * literals and comments never effect how the path is walked.
+ *
+ * Never more than EXPRESSION_WINDOW tokens are looked at, so the cost does 
+ * not depend on how far into the file the iter is.
  */
-static gchar*
-find_path (gchar *text)
+gchar*
+java_utils_get_expression (GtkTextIter iter)
 {
-  gchar *result;
+  JavaLexer *lexer;
   GString *string;
-  gchar *text_cpy;
-  gchar *tmp;
-  int brace = 0;
+  gint window = EXPRESSION_WINDOW;
+  gint brace = 0;
+  gint line;
+  gint edge;
+  
+  lexer = java_lexer_get (gtk_text_iter_get_buffer (&iter));
   
   string = g_string_new ("");
-
-  text_cpy = g_strdup (text);
-  tmp = text_cpy;
-  text_cpy = g_strreverse (text_cpy);
   
-  for (; *text_cpy != '\0'; ++text_cpy)
+  line = gtk_text_iter_get_line (&iter);
+  edge = gtk_text_iter_get_line_index (&iter);
+  
+  for (; line >= 0; line--, edge = -1)
     {
-      if (*text_cpy == '=' ||
-          *text_cpy == ';' ||
-          g_ascii_isspace (*text_cpy) ||
-          *text_cpy == '{')
+      GArray *tokens;
+      const gchar *text;
+      gint i;
+      
+      tokens = java_lexer_get_tokens (lexer, line);
+      text = java_lexer_get_text (lexer, line);
+      if (tokens == NULL)
         break;
       
-      if (*text_cpy == ')')
-        brace++;
-      if (*text_cpy == '(')
-        {
-          brace--;
-          if (brace == -1)
-            break;
-        }
-        
-      string = g_string_append_c (string, *text_cpy);
-    }
-  
-  result = g_string_free (string, FALSE);
-  g_strstrip (result);
-  g_free (tmp);
-    
-  return result;
-}
-
-/*
- * Take out the comments so that they do not effect how the 
- * completion path is walked to find the context of the methods.
- *
- * new DateFilterMatcher("MM/yyyy") becomes new DateFilterMatcher()
- */
-static gchar*
-strip_comments (gchar *text)
-{
-  gchar *result;
-  GRegex *regex;
-  GError *error = NULL;
-
-  regex = g_regex_new ("\"([^\"\\\\]*(\\.[^\"\\\\]*)*)\"", 0, 0, &error);
-  
-  if (error != NULL)
-    {
-      g_printerr (error->message);
-      g_error_free (error);
-    }
-  
-  result = g_regex_replace (regex, text, -1, 0, "", 0, NULL);
-  
-  g_regex_unref (regex);
-
-  return result;
-}
-
-/*
- * Take out everything in the methods (between the braces) that do not 
- * belong in the context of the path being matched so that they do not 
- * effect how the completion path is walked to find the context of the 
- * methods.
- *
- * tableModel.setItems(presidentService.getPresidents()) 
- * becomes tableModel.setItems() if we are in the context of the tableModel.
- */
-static gchar*
-strip_path_parameters (gchar *path)
-{
-  gchar *result;
-  GString *string;
-  int brace = 0;
-  
-  string = g_string_new ("");
-
-  for (; *path != '\0'; ++path)
-    {
-      if (*path == ')')
-        {
-          brace++;
-          if (brace == 1)
-            string = g_string_append_c (string, *path);
-          continue;
-        }
-      if (*path == '(')
+      for (i = tokens->len - 1; i >= 0; i--)
         {
-          brace--;
+          JavaToken *token = &g_array_index (tokens, JavaToken, i);
+          gint length;
+          gchar ch;
+          
+          if (edge >= 0 && token->index >= edge)
+            continue;
+          
+          if (--window < 0)
+            {
+              g_string_truncate (string, 0);
+              return g_string_free (string, FALSE);
+            }
+          
+          length = token->length;
+          if (edge >= 0 && token->index + length > edge)
+            length = edge - token->index;
+          
+          if (token->type == JAVA_TOKEN_COMMENT || 
+              token->type == JAVA_TOKEN_STRING || 
+              token->type == JAVA_TOKEN_CHARACTER)
+            {
+              edge = token->index;
+              continue;
+            }
+          
+          /* whitespace in between ends the path */
+          if (edge < 0 || token->index + length != edge)
+            return g_string_free (string, FALSE);
+          
+          edge = token->index;
+          ch = text[token->index];
+          
+          if (token->type == JAVA_TOKEN_OPERATOR && 
+              (ch == '=' || ch == ';' || ch == '{'))
+            return g_string_free (string, FALSE);
+          
+          if (token->type == JAVA_TOKEN_OPERATOR && ch == ')')
+            {
+              brace++;
+              if (brace == 1)
+                g_string_prepend_c (string, ch);
+              continue;
+            }
+          
+          if (token->type == JAVA_TOKEN_OPERATOR && ch == '(')
+            {
+              brace--;
+              if (brace == -1)
+                return g_string_free (string, FALSE);
+              if (brace == 0)
+                g_string_prepend_c (string, ch);
+              continue;
+            }
+          
           if (brace == 0)
-            string = g_string_append_c (string, *path);
-          continue;
+            g_string_prepend_len (string, text + token->index, length);
         }
       
-      if (brace == 0)
-        string = g_string_append_c (string, *path);
+      if (edge != 0)
+        break;
     }
   
-  result = g_string_free (string, FALSE);
-  g_strstrip(result);
-    
-  return result;
+  return g_string_free (string, FALSE);
 }
@@ -27,15 +27,13 @@ G_BEGIN_DECLS
 
 gchar*  java_utils_get_class_name        (JavaConfiguration  *configuration,
                                           CodeSlayerDocument *document);                                    
-gchar*  java_utils_get_text_to_search    (GtkTextView        *text_view, 
-                                          GtkTextIter         iter);                                    
 void    java_utils_move_iter_word_start  (GtkTextIter        *iter);  
 gchar*  get_source_indexes_folders       (CodeSlayer         *codeslayer, 
                                           JavaConfigurations *configurations);
 gchar*  get_lib_indexes_folders          (CodeSlayer         *codeslayer, 
                                           JavaConfigurations *configurations);
 gchar*  java_utils_get_indexes_folder    (CodeSlayer         *codeslayer);
-gchar*  java_utils_get_expression        (gchar              *text);
+gchar*  java_utils_get_expression        (GtkTextIter         iter);
                                
 G_END_DECLS
 
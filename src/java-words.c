@@ -0,0 +1,452 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+#include <codeslayer/codeslayer-utils.h>
+#include "java-words.h"
+#include "java-lexer.h"
+#include "java-identifiers.h"
+#include "java-configuration.h"
+
+/*
+ * The words that word completion suggests. Every open buffer counts its 
+ * identifiers in one shared trie, and the source files of the projects 
+ * are lexed into another trie on a background thread. A lookup is a walk 
+ * down the prefix in each trie, so it costs the same no matter how many 
+ * editors are open.
+ *
+ * The matches are ranked by how often they occur near the caret, then in 
+ * the same buffer, then anywhere else.
+ *
+ * Unlike the old scan of the text before the caret, the words of the whole 
+ * buffer are offered, including the ones that only occur after the caret. 
+ * The other editors and the projects have no caret to be before anyway.
+ */
+
+typedef struct
+{
+  JavaWords       *words;
+  GList           *folders;
+  JavaIdentifiers *identifiers;
+  guint            generation;
+} Refresh;
+
+typedef struct
+{
+  gchar *word;
+  guint  score;
+} Match;
+
+static void java_words_class_init  (JavaWordsClass *klass);
+static void java_words_init        (JavaWords      *words);
+static void java_words_finalize    (JavaWords      *words);
+
+static gpointer refresh_thread     (Refresh        *refresh);
+static void scan_folder            (const gchar    *folder_path, 
+                                    JavaIdentifiers *identifiers);
+static gboolean refresh_idle       (Refresh        *refresh);
+static void destroy_refresh        (Refresh        *refresh);
+static void add_matches            (GHashTable     *matches, 
+                                    GList          *list);
+static GHashTable* count_near      (JavaLexer      *lexer, 
+                                    gint            line_number, 
+                                    const gchar    *prefix);
+static gint compare_matches        (Match          *match1, 
+                                    Match          *match2);
+static void free_match             (Match          *match);
+
+#define NEAR_LINES 30
+#define NEAR_WEIGHT 4
+#define LOCAL_WEIGHT 2
+
+#define JAVA_WORDS_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), JAVA_WORDS_TYPE, JavaWordsPrivate))
+
+typedef struct _JavaWordsPrivate JavaWordsPrivate;
+
+struct _JavaWordsPrivate
+{
+  JavaToolsProperties *tools_properties;
+  JavaConfigurations  *configurations;
+  JavaIdentifiers     *editors;
+  JavaIdentifiers     *projects;
+  guint                generation;
+  gboolean             refreshing;
+};
+
+G_DEFINE_TYPE (JavaWords, java_words, G_TYPE_OBJECT)
+
+static void 
+java_words_class_init (JavaWordsClass *klass)
+{
+  G_OBJECT_CLASS (klass)->finalize = (GObjectFinalizeFunc) java_words_finalize;
+  g_type_class_add_private (klass, sizeof (JavaWordsPrivate));
+}
+
+static void
+java_words_init (JavaWords *words)
+{
+  JavaWordsPrivate *priv;
+  priv = JAVA_WORDS_GET_PRIVATE (words);
+  priv->editors = java_identifiers_new ();
+  priv->projects = NULL;
+  priv->generation = 0;
+  priv->refreshing = FALSE;
+}
+
+static void
+java_words_finalize (JavaWords *words)
+{
+  JavaWordsPrivate *priv;
+  priv = JAVA_WORDS_GET_PRIVATE (words);
+  
+  g_object_unref (priv->editors);
+  
+  if (priv->projects != NULL)
+    g_object_unref (priv->projects);
+
+  G_OBJECT_CLASS (java_words_parent_class)-> finalize (G_OBJECT (words));
+}
+
+JavaWords*
+java_words_new (JavaToolsProperties *tools_properties, 
+                JavaConfigurations  *configurations)
+{
+  JavaWordsPrivate *priv;
+  JavaWords *words;
+
+  words = JAVA_WORDS (g_object_new (java_words_get_type (), NULL));
+  priv = JAVA_WORDS_GET_PRIVATE (words);
+  priv->tools_properties = tools_properties;
+  priv->configurations = configurations;
+
+  return words;
+}
+
+/*
+ * The buffer counts its identifiers in the shared trie until it is 
+ * destroyed, which takes them back out.
+ */
+void
+java_words_add_buffer (JavaWords     *words, 
+                       GtkTextBuffer *buffer)
+{
+  JavaWordsPrivate *priv;
+  priv = JAVA_WORDS_GET_PRIVATE (words);
+  java_lexer_share_identifiers (java_lexer_get (buffer), priv->editors);
+}
+
+/*
+ * Lexes the source files of the projects again in the background. Only 
+ * does anything when word completion looks at the projects, and only the 
+ * last refresh that was started gets to replace the trie.
+ */
+void
+java_words_refresh_projects (JavaWords *words)
+{
+  JavaWordsPrivate *priv;
+  const gchar *word_completion;
+  Refresh *refresh;
+  GList *list;
+  
+  priv = JAVA_WORDS_GET_PRIVATE (words);
+  
+  word_completion = java_tools_properties_get_word_completion (priv->tools_properties);
+  if (g_strcmp0 (word_completion, "projects") != 0)
+    return;
+  
+  refresh = g_malloc (sizeof (Refresh));
+  refresh->words = g_object_ref (words);
+  refresh->folders = NULL;
+  refresh->identifiers = java_identifiers_new ();
+  refresh->generation = ++priv->generation;
+  
+  list = java_configurations_get_list (priv->configurations);
+  while (list != NULL)
+    {
+      JavaConfiguration *configuration = list->data;
+      const gchar *source_folder;
+      const gchar *test_folder;
+      source_folder = java_configuration_get_source_folder (configuration);
+      test_folder = java_configuration_get_test_folder (configuration);
+      if (codeslayer_utils_has_text (source_folder))
+        refresh->folders = g_list_prepend (refresh->folders, g_strdup (source_folder));
+      if (codeslayer_utils_has_text (test_folder))
+        refresh->folders = g_list_prepend (refresh->folders, g_strdup (test_folder));
+      list = g_list_next (list);
+    }
+  
+  priv->refreshing = TRUE;
+  
+  g_thread_new ("Index Words", (GThreadFunc) refresh_thread, refresh);
+}
+
+static gpointer
+refresh_thread (Refresh *refresh)
+{
+  GList *list = refresh->folders;
+  
+  while (list != NULL)
+    {
+      scan_folder (list->data, refresh->identifiers);
+      list = g_list_next (list);
+    }
+  
+  g_idle_add_full (G_PRIORITY_DEFAULT_IDLE, (GSourceFunc) refresh_idle, 
+                   refresh, (GDestroyNotify) destroy_refresh);
+  
+  return NULL;
+}
+
+static void
+scan_folder (const gchar     *folder_path, 
+             JavaIdentifiers *identifiers)
+{
+  GDir *dir;
+  const gchar *file_name;
+  
+  dir = g_dir_open (folder_path, 0, NULL);
+  if (dir == NULL)
+    return;
+  
+  while ((file_name = g_dir_read_name (dir)) != NULL)
+    {
+      gchar *file_path;
+      gchar *contents;
+      
+      file_path = g_build_filename (folder_path, file_name, NULL);
+      
+      if (g_file_test (file_path, G_FILE_TEST_IS_DIR))
+        {
+          scan_folder (file_path, identifiers);
+        }
+      else if (g_str_has_suffix (file_name, ".java") && 
+               g_file_get_contents (file_path, &contents, NULL, NULL))
+        {
+          java_lexer_scan (contents, identifiers);
+          g_free (contents);
+        }
+      
+      g_free (file_path);
+    }
+    
+  g_dir_close (dir);
+}
+
+static gboolean
+refresh_idle (Refresh *refresh)
+{
+  JavaWordsPrivate *priv;
+  priv = JAVA_WORDS_GET_PRIVATE (refresh->words);
+  
+  if (refresh->generation != priv->generation)
+    return FALSE;
+  
+  if (priv->projects != NULL)
+    g_object_unref (priv->projects);
+  
+  priv->projects = refresh->identifiers;
+  refresh->identifiers = NULL;
+  priv->refreshing = FALSE;
+  
+  return FALSE;
+}
+
+static void
+destroy_refresh (Refresh *refresh)
+{
+  if (refresh->identifiers != NULL)
+    g_object_unref (refresh->identifiers);
+  
+  g_list_foreach (refresh->folders, (GFunc) g_free, NULL);
+  g_list_free (refresh->folders);
+  g_object_unref (refresh->words);
+  g_free (refresh);
+}
+
+/*
+ * Returns the words that start with the prefix, best first. Free with 
+ * g_list_free_full (list, g_free).
+ */
+GList*
+java_words_find (JavaWords   *words, 
+                 GtkTextIter  iter, 
+                 const gchar *prefix)
+{
+  JavaWordsPrivate *priv;
+  const gchar *word_completion;
+  JavaIdentifiers *local;
+  JavaLexer *lexer;
+  GHashTable *matches;
+  GHashTable *near;
+  GHashTableIter hash_iter;
+  GList *sorted = NULL;
+  GList *results = NULL;
+  GList *list;
+  Match *match;
+  
+  priv = JAVA_WORDS_GET_PRIVATE (words);
+  
+  word_completion = java_tools_properties_get_word_completion (priv->tools_properties);
+  
+  lexer = java_lexer_get (gtk_text_iter_get_buffer (&iter));
+  java_lexer_share_identifiers (lexer, priv->editors);
+  local = java_lexer_get_identifiers (lexer);
+  
+  matches = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, (GDestroyNotify) free_match);
+  
+  if (g_strcmp0 (word_completion, "editors") == 0 || 
+      g_strcmp0 (word_completion, "projects") == 0)
+    add_matches (matches, java_identifiers_find (priv->editors, prefix));
+  else
+    add_matches (matches, java_identifiers_find (local, prefix));
+  
+  if (g_strcmp0 (word_completion, "projects") == 0)
+    {
+      if (priv->projects != NULL)
+        add_matches (matches, java_identifiers_find (priv->projects, prefix));
+      else if (!priv->refreshing)
+        java_words_refresh_projects (words);
+    }
+  
+  near = count_near (lexer, gtk_text_iter_get_line (&iter), prefix);
+  
+  g_hash_table_iter_init (&hash_iter, matches);
+  while (g_hash_table_iter_next (&hash_iter, NULL, (gpointer *) &match))
+    {
+      match->score = NEAR_WEIGHT * GPOINTER_TO_UINT (g_hash_table_lookup (near, match->word)) + 
+                     LOCAL_WEIGHT * java_identifiers_get_count (local, match->word) + 
+                     java_identifiers_get_count (priv->editors, match->word);
+      
+      if (priv->projects != NULL)
+        match->score += java_identifiers_get_count (priv->projects, match->word);
+      
+      sorted = g_list_prepend (sorted, match);
+    }
+  
+  sorted = g_list_sort (sorted, (GCompareFunc) compare_matches);
+  
+  for (list = sorted; list != NULL; list = g_list_next (list))
+    {
+      match = list->data;
+      results = g_list_prepend (results, g_strdup (match->word));
+    }
+  
+  g_list_free (sorted);
+  g_hash_table_destroy (near);
+  g_hash_table_destroy (matches);
+  
+  return g_list_reverse (results);
+}
+
+/*
+ * Takes over the words in the list, skipping the ones already matched.
+ */
+static void
+add_matches (GHashTable *matches, 
+             GList      *list)
+{
+  GList *tmp = list;
+  
+  while (list != NULL)
+    {
+      gchar *word = list->data;
+      
+      if (g_hash_table_contains (matches, word))
+        {
+          g_free (word);
+        }
+      else
+        {
+          Match *match = g_malloc (sizeof (Match));
+          match->word = word;
+          match->score = 0;
+          g_hash_table_insert (matches, word, match);
+        }
+      
+      list = g_list_next (list);
+    }
+  
+  g_list_free (tmp);
+}
+
+/*
+ * Counts the identifiers that start with the prefix on the lines around 
+ * the caret.
+ */
+static GHashTable*
+count_near (JavaLexer   *lexer, 
+            gint         line_number, 
+            const gchar *prefix)
+{
+  GHashTable *near;
+  gint prefix_length;
+  gint line_count;
+  gint line;
+  
+  near = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  prefix_length = strlen (prefix);
+  line_count = java_lexer_get_line_count (lexer);
+  
+  for (line = MAX (0, line_number - NEAR_LINES); 
+       line <= line_number + NEAR_LINES && line < line_count; line++)
+    {
+      GArray *tokens;
+      const gchar *text;
+      guint i;
+      
+      tokens = java_lexer_get_tokens (lexer, line);
+      text = java_lexer_get_text (lexer, line);
+      if (tokens == NULL)
+        break;
+      
+      for (i = 0; i < tokens->len; i++)
+        {
+          JavaToken *token = &g_array_index (tokens, JavaToken, i);
+          gchar *word;
+          
+          if (token->type != JAVA_TOKEN_IDENTIFIER || 
+              token->length <= prefix_length || 
+              strncmp (text + token->index, prefix, prefix_length) != 0)
+            continue;
+          
+          word = g_strndup (text + token->index, token->length);
+          g_hash_table_insert (near, word, 
+                               GUINT_TO_POINTER (GPOINTER_TO_UINT (g_hash_table_lookup (near, word)) + 1));
+        }
+    }
+  
+  return near;
+}
+
+static gint
+compare_matches (Match *match1, 
+                 Match *match2)
+{
+  if (match1->score != match2->score)
+    return match1->score > match2->score ? -1 : 1;
+  
+  return g_strcmp0 (match1->word, match2->word);
+}
+
+static void
+free_match (Match *match)
+{
+  g_free (match->word);
+  g_free (match);
+}
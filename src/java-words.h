@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __JAVA_WORDS_H__
+#define	__JAVA_WORDS_H__
+
+#include <gtk/gtk.h>
+#include <codeslayer/codeslayer.h>
+#include "java-tools-properties.h"
+#include "java-configurations.h"
+
+G_BEGIN_DECLS
+
+#define JAVA_WORDS_TYPE            (java_words_get_type ())
+#define JAVA_WORDS(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), JAVA_WORDS_TYPE, JavaWords))
+#define JAVA_WORDS_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), JAVA_WORDS_TYPE, JavaWordsClass))
+#define IS_JAVA_WORDS(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), JAVA_WORDS_TYPE))
+#define IS_JAVA_WORDS_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), JAVA_WORDS_TYPE))
+
+typedef struct _JavaWords JavaWords;
+typedef struct _JavaWordsClass JavaWordsClass;
+
+struct _JavaWords
+{
+  GObject parent_instance;
+};
+
+struct _JavaWordsClass
+{
+  GObjectClass parent_class;
+};
+
+GType java_words_get_type (void) G_GNUC_CONST;
+
+JavaWords*  java_words_new              (JavaToolsProperties *tools_properties, 
+                                         JavaConfigurations  *configurations);
+
+void        java_words_add_buffer       (JavaWords           *words, 
+                                         GtkTextBuffer       *buffer);
+void        java_words_refresh_projects (JavaWords           *words);
+GList*      java_words_find             (JavaWords           *words, 
+                                         GtkTextIter          iter, 
+                                         const gchar         *prefix);
+
+G_END_DECLS
+
+#endif /* __JAVA_WORDS_H__ */